@@ -0,0 +1,77 @@
+// File  : ArmConfig.h
+// Author: Cole Schwandt
+//
+// Arm geometry and finger poses shared by the renderer and the CPU-side
+// kinematics. Camera, light and material settings stay in main.cpp.
+
+#ifndef ARMCONFIG_H
+#define ARMCONFIG_H
+
+#include <GL/freeglut.h>
+
+namespace cfg
+{
+    // -------- tessellation --------
+    const GLint SLICES = 20;
+    const GLint STACKS = 20;
+
+    // -------- base (cube scaled) --------
+    const GLfloat BASE_SIZE = 1.0f;    
+    const GLfloat BASE_SX   = 5.0f;
+    const GLfloat BASE_SY   = 0.5f;
+    const GLfloat BASE_SZ   = 5.0f;
+
+    // -------- joints --------
+    const GLfloat JOINT_R = 1.0f; // was 1
+
+    // -------- links (cylinders) --------
+    const GLfloat ARM_R = 0.5f;
+    const GLfloat ARM_L = 2.0f;
+    const GLfloat ROT_Z_TO_Y = -90.0f;  
+    const GLfloat OVERLAP_FRAC = 0.25f;
+    
+    inline GLfloat LINK_GAP()
+    {
+        const GLfloat m = (ARM_R < JOINT_R ? ARM_R : JOINT_R);
+        return -OVERLAP_FRAC * m;
+    }
+
+    // -------- hand/fingers --------
+    const GLfloat PALM_SIZE = 1.0f;
+    const GLfloat FINGER_JOINT_R = 0.15f;
+    const GLfloat FINGER_DIGIT_R = 0.1f;
+    const GLfloat FINGER_DIGIT_L = 0.5f;
+    
+    const GLfloat PALM_TO_FINGER_Y = 0.5f * PALM_SIZE;
+    const GLfloat FINGER_OFFSET_X  = 0.23f * JOINT_R;
+    const GLfloat FINGER_OFFSET_Z  = 0.30f * JOINT_R;
+}
+
+//==============================================================
+// Finger poses
+//==============================================================
+struct FingerAngles { GLfloat baseZ, jointZ, tipY; };
+
+// OPEN pose
+const FingerAngles OPEN_F0 = { -60.0f, +60.0f, -35.0f };
+const FingerAngles OPEN_F1 = { +60.0f, -60.0f, +35.0f };
+const FingerAngles OPEN_F2 = { +60.0f, -60.0f, +35.0f };
+
+// CLOSED pose (pinch): stronger curl, zero tip twist for a tight pinch
+const FingerAngles CLOSED_F0 = { -150.0f, +120.0f, 0.0f };
+const FingerAngles CLOSED_F1 = { +150.0f, -120.0f, 0.0f };
+const FingerAngles CLOSED_F2 = { +150.0f, -120.0f, 0.0f };
+
+inline GLfloat lerp(GLfloat a, GLfloat b, GLfloat t)
+{
+    return a + t * (b - a);
+}
+
+inline FingerAngles mix(const FingerAngles& a, const FingerAngles& b, GLfloat t)
+{
+    return { lerp(a.baseZ,  b.baseZ,  t),
+             lerp(a.jointZ, b.jointZ, t),
+             lerp(a.tipY,   b.tipY,   t) };
+}
+
+#endif
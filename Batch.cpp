@@ -0,0 +1,221 @@
+// File  : Batch.cpp
+// Author: Cole Schwandt
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include "Clock.h"
+#include "BlockingQueue.h"
+#include "Headless.h"
+#include "debug.h"
+#include "Batch.h"
+
+namespace
+{
+    // A rendered image waiting to be written. Frames are recycled through a
+    // free list so the steady state allocates nothing.
+    struct Frame
+    {
+        size_t index;
+        std::vector< unsigned char > pixels;
+    };
+
+    void write_ppm(const std::string & path, const Frame & f, int w, int h)
+    {
+        FILE * fp = fopen(path.c_str(), "wb");
+        if (fp == NULL)
+        {
+            std::cout << "batch: cannot write " << path << std::endl;
+            return;
+        }
+        fprintf(fp, "P6\n%d %d\n255\n", w, h);
+        // GL rows are bottom-up
+        for (int y = h - 1; y >= 0; --y)
+            fwrite(&f.pixels[size_t(y) * w * 3], 1, size_t(w) * 3, fp);
+        fclose(fp);
+    }
+
+    void write_metadata(std::ostream & out, const std::string & file,
+                        size_t index, const arm::BatchItem & item)
+    {
+        const arm::Pose & p = item.pose;
+        arm::Frames f;
+        arm::forward_kinematics(p, f);
+        const arm::Mat4 & m = f.palm;
+
+        out << index << ',' << file << ','
+            << p.shoulder_pitch << ',' << p.shoulder_yaw << ',' << p.shoulder_roll << ','
+            << p.elbow_pitch << ',' << p.elbow_yaw << ',' << p.elbow_roll << ','
+            << p.grip << ','
+            << item.eye[0] << ',' << item.eye[1] << ',' << item.eye[2] << ','
+            << item.ref[0] << ',' << item.ref[1] << ',' << item.ref[2] << ','
+            << item.fovy;
+        // palm position, then rotation row by row
+        out << ',' << m(0, 3) << ',' << m(1, 3) << ',' << m(2, 3);
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                out << ',' << m(r, c);
+        out << '\n';
+    }
+}
+
+std::vector< arm::BatchItem > arm::read_pose_list(const std::string & path)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+    {
+        std::cout << "batch: cannot open " << path << std::endl;
+        throw BatchError();
+    }
+
+    std::vector< BatchItem > items;
+    std::string line;
+    for (int n = 1; std::getline(in, line); ++n)
+    {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        BatchItem b;
+        Pose & p = b.pose;
+        std::istringstream s(line);
+        if (!(s >> p.shoulder_pitch >> p.shoulder_yaw >> p.shoulder_roll
+                >> p.elbow_pitch >> p.elbow_yaw >> p.elbow_roll >> p.grip
+                >> b.eye[0] >> b.eye[1] >> b.eye[2]
+                >> b.ref[0] >> b.ref[1] >> b.ref[2] >> b.fovy))
+        {
+            std::cout << path << ':' << n << ": expected 14 numbers" << std::endl;
+            throw BatchError();
+        }
+        p.xb = p.yb = p.zb = 0.0f;
+        items.push_back(b);
+    }
+    return items;
+}
+
+arm::BatchStats arm::render_batch(const std::vector< BatchItem > & items,
+                                  const std::string & out_dir,
+                                  int threads, int w, int h,
+                                  const ArmMeshes & meshes)
+{
+    if (threads < 1) threads = 1;
+    mkdir(out_dir.c_str(), 0755);
+    std::ofstream csv((out_dir + "/metadata.csv").c_str());
+    if (!csv)
+    {
+        std::cout << "batch: cannot write to " << out_dir << std::endl;
+        throw BatchError();
+    }
+    csv << "index,file,shoulder_pitch,shoulder_yaw,shoulder_roll,"
+           "elbow_pitch,elbow_yaw,elbow_roll,grip,"
+           "eye_x,eye_y,eye_z,ref_x,ref_y,ref_z,fovy,"
+           "palm_x,palm_y,palm_z,"
+           "palm_r00,palm_r01,palm_r02,palm_r10,palm_r11,palm_r12,"
+           "palm_r20,palm_r21,palm_r22\n";
+
+    // llvmpipe rasterizes each context on its own thread pool; with one
+    // context per core that only oversubscribes. Respect an explicit value.
+    if (threads > 1) setenv("LP_NUM_THREADS", "1", 0);
+
+    // two frames in flight per worker keeps everyone busy while the writer
+    // catches up
+    const size_t pool = 2 * threads;
+    std::vector< Frame > frames(pool);
+    mygllib::BlockingQueue< Frame * > free_frames(pool);
+    mygllib::BlockingQueue< Frame * > done_frames(pool);
+    for (size_t i = 0; i < pool; ++i)
+    {
+        frames[i].pixels.resize(size_t(w) * h * 3);
+        free_frames.push(&frames[i]);
+    }
+
+    std::atomic< size_t > next(0);
+    std::atomic< bool > failed(false);
+    BatchStats stats;
+    stats.images = 0;
+    stats.per_thread.assign(threads, 0);
+
+    const int64_t start = mygllib::now_ns();
+
+    std::thread writer([&]()
+    {
+        Frame * f;
+        char name[32];
+        while (done_frames.pop(f))
+        {
+            snprintf(name, sizeof(name), "img_%06zu.ppm", f->index);
+            write_ppm(out_dir + "/" + name, *f, w, h);
+            write_metadata(csv, name, f->index, items[f->index]);
+            ++stats.images;
+            free_frames.push(f);
+        }
+    });
+
+    std::vector< std::thread > workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&, t]()
+        {
+            try
+            {
+                mygllib::OffscreenContext context(w, h);
+                context.make_current();
+                mygllib::debug_context();
+                init_scene();
+                glViewport(0, 0, w, h);
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+                mygllib::View view;
+                view.aspect() = GLfloat(w) / h;
+                for (size_t i = next++; i < items.size() && !failed; i = next++)
+                {
+                    const BatchItem & item = items[i];
+                    view.eyex() = item.eye[0];
+                    view.eyey() = item.eye[1];
+                    view.eyez() = item.eye[2];
+                    view.refx() = item.ref[0];
+                    view.refy() = item.ref[1];
+                    view.refz() = item.ref[2];
+                    view.fovy() = item.fovy;
+                    view.set_projection();
+                    draw_scene(item.pose, view, meshes);
+
+                    Frame * f;
+                    if (!free_frames.pop(f)) break;
+                    f->index = i;
+                    GL_CALL(glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, &f->pixels[0]));
+                    done_frames.push(f);
+                    ++stats.per_thread[t];
+                }
+                context.release();
+            }
+            catch (...)
+            {
+                failed = true;
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < workers.size(); ++t) workers[t].join();
+    done_frames.close();
+    writer.join();
+
+    stats.wall_ns = mygllib::now_ns() - start;
+    if (failed) throw BatchError();
+    return stats;
+}
+
+void arm::report(const BatchStats & stats, std::ostream & out)
+{
+    const double secs = stats.wall_ns / 1e9;
+    out << "batch: " << stats.images << " images in " << secs << " s ("
+        << stats.images / secs << " images/s) on "
+        << stats.per_thread.size() << " thread(s):";
+    for (size_t t = 0; t < stats.per_thread.size(); ++t)
+        out << ' ' << stats.per_thread[t];
+    out << std::endl;
+}
@@ -0,0 +1,64 @@
+// File  : Batch.h
+// Author: Cole Schwandt
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Scene.h"
+
+namespace arm
+{
+    class BatchError
+    {};
+
+    //-------------------------------------------------------------------------
+    // BatchItem
+    //
+    // One image to render. Pose list files have one item per line:
+    //
+    //   sp sy sr  ep ey er  grip  eyex eyey eyez  refx refy refz  fovy
+    //
+    // (shoulder/elbow pitch, yaw, roll in degrees, then the View eye,
+    // reference point and vertical field of view). '#' starts a comment.
+    //-------------------------------------------------------------------------
+    struct BatchItem
+    {
+        Pose pose;
+        GLfloat eye[3];
+        GLfloat ref[3];
+        GLfloat fovy;
+    };
+
+    std::vector< BatchItem > read_pose_list(const std::string & path);
+
+    struct BatchStats
+    {
+        size_t images;
+        int64_t wall_ns;
+        std::vector< size_t > per_thread;
+    };
+
+    //-------------------------------------------------------------------------
+    // render_batch
+    //
+    // Renders items on `threads` workers, each with its own w x h offscreen
+    // context, all drawing from the one shared meshes. Finished frames go
+    // through a bounded queue to a writer thread, which saves
+    // <out_dir>/img_NNNNNN.ppm and appends a row to <out_dir>/metadata.csv
+    // (joint angles, grip, camera and the palm's world pose). Rendering the
+    // next image overlaps writing the previous ones; rows are written in
+    // completion order and carry the item index.
+    //-------------------------------------------------------------------------
+    BatchStats render_batch(const std::vector< BatchItem > & items,
+                            const std::string & out_dir,
+                            int threads, int w, int h,
+                            const ArmMeshes & meshes);
+
+    void report(const BatchStats & stats, std::ostream & out);
+}
+
+#endif
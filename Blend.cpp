@@ -0,0 +1,205 @@
+// File  : Blend.cpp
+// Author: Cole Schwandt
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+#include "Blend.h"
+
+namespace
+{
+    void channels(const arm::Pose & p, GLfloat c[arm::BLEND_CHANNELS])
+    {
+        c[0] = p.shoulder_pitch;
+        c[1] = p.shoulder_yaw;
+        c[2] = p.shoulder_roll;
+        c[3] = p.elbow_pitch;
+        c[4] = p.elbow_yaw;
+        c[5] = p.elbow_roll;
+        c[arm::BLEND_GRIP] = p.grip;
+        c[arm::BLEND_BASE] = p.xb;
+        c[arm::BLEND_BASE + 1] = p.yb;
+        c[arm::BLEND_BASE + 2] = p.zb;
+    }
+
+    // shoulder then elbow, w x y z each
+    void rotations(const arm::Pose & p, GLfloat q[arm::BLEND_QUAT])
+    {
+        const arm::Quat r[2] = { arm::shoulder_rotation(p),
+                                 arm::elbow_rotation(p) };
+        for (int j = 0; j < 2; ++j)
+        {
+            q[4 * j] = r[j].w;
+            q[4 * j + 1] = r[j].x;
+            q[4 * j + 2] = r[j].y;
+            q[4 * j + 3] = r[j].z;
+        }
+    }
+
+    // Arm k's joint channels from its summed ball joint quaternions; the
+    // channels hold the linear blend, which picks among the Euler triples
+    // of each rotation the one nearest the keyframes.
+    void set_joints(GLfloat * const o[], size_t k, const GLfloat q[arm::BLEND_QUAT])
+    {
+        for (int j = 0; j < 2; ++j)
+        {
+            const arm::Quat r = mygllib::normalize(arm::Quat(q[4 * j], q[4 * j + 1],
+                                                             q[4 * j + 2], q[4 * j + 3]));
+            float a[3] = { o[3 * j][k], o[3 * j + 1][k], o[3 * j + 2][k] };
+            mygllib::euler_xyz(r, a);
+            for (int i = 0; i < 3; ++i) o[3 * j + i][k] = a[i];
+        }
+    }
+}
+
+void arm::PoseArray::resize(size_t n)
+{
+    for (int c = 0; c < BLEND_CHANNELS; ++c) channel[c].assign(n, 0.0f);
+}
+
+arm::Pose arm::PoseArray::pose(size_t k) const
+{
+    Pose p =
+    {
+        channel[0][k], channel[1][k], channel[2][k],
+        channel[3][k], channel[4][k], channel[5][k],
+        channel[BLEND_GRIP][k],
+        channel[BLEND_BASE][k], channel[BLEND_BASE + 1][k],
+        channel[BLEND_BASE + 2][k],
+    };
+    return p;
+}
+
+void arm::PoseArray::set(size_t k, const Pose & p)
+{
+    GLfloat c[BLEND_CHANNELS];
+    channels(p, c);
+    for (int i = 0; i < BLEND_CHANNELS; ++i) channel[i][k] = c[i];
+}
+
+arm::BlendTree::BlendTree(size_t arms)
+    : n_(arms)
+{}
+
+int arm::BlendTree::add_keyframe(const Pose & key)
+{
+    key_.resize(key_.size() + BLEND_CHANNELS);
+    channels(key, &key_[key_.size() - BLEND_CHANNELS]);
+    key_q_.resize(key_q_.size() + BLEND_QUAT);
+    rotations(key, &key_q_[key_q_.size() - BLEND_QUAT]);
+    weight_.push_back(std::vector< GLfloat >(n_, 0.0f));
+    return int(weight_.size()) - 1;
+}
+
+int arm::BlendTree::add_layer(const Pose & offset)
+{
+    layer_.resize(layer_.size() + BLEND_CHANNELS);
+    channels(offset, &layer_[layer_.size() - BLEND_CHANNELS]);
+    amount_.push_back(std::vector< GLfloat >(n_, 0.0f));
+    return int(amount_.size()) - 1;
+}
+
+void arm::BlendTree::evaluate(size_t begin, size_t end, PoseArray & out) const
+{
+    const int nk = keyframes(), nl = layers();
+    GLfloat * o[BLEND_CHANNELS];
+    for (int c = 0; c < BLEND_CHANNELS; ++c) o[c] = &out.channel[c][0];
+
+    size_t k = begin;
+#ifdef __SSE__
+    // 4 arms at a time: every channel accumulates in its own register
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for ( ; k + 4 <= end; k += 4)
+    {
+        __m128 acc[BLEND_CHANNELS], q[BLEND_QUAT];
+        for (int c = 0; c < BLEND_CHANNELS; ++c) acc[c] = zero;
+        for (int c = 0; c < BLEND_QUAT; ++c) q[c] = zero;
+        __m128 sum = zero;
+        for (int i = 0; i < nk; ++i)
+        {
+            const __m128 w = _mm_loadu_ps(&weight_[i][k]);
+            const GLfloat * key = &key_[i * BLEND_CHANNELS];
+            sum = _mm_add_ps(sum, w);
+            for (int c = 0; c < BLEND_CHANNELS; ++c)
+                acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(w, _mm_set1_ps(key[c])));
+
+            // each ball joint: the key's quaternion flipped, in the arms
+            // where it points away from the sum so far
+            const GLfloat * kq = &key_q_[i * BLEND_QUAT];
+            for (int j = 0; j < BLEND_QUAT; j += 4)
+            {
+                __m128 d = zero;
+                for (int c = j; c < j + 4; ++c)
+                    d = _mm_add_ps(d, _mm_mul_ps(q[c], _mm_set1_ps(kq[c])));
+                const __m128 sw = _mm_xor_ps(w, _mm_and_ps(_mm_cmplt_ps(d, zero),
+                                                            sign));
+                for (int c = j; c < j + 4; ++c)
+                    q[c] = _mm_add_ps(q[c], _mm_mul_ps(sw, _mm_set1_ps(kq[c])));
+            }
+        }
+
+        // 1 / sum, or 0 where every weight is 0
+        const __m128 inv = _mm_and_ps(_mm_cmpgt_ps(sum, zero),
+                                      _mm_div_ps(one, sum));
+        for (int c = 0; c < BLEND_CHANNELS; ++c) acc[c] = _mm_mul_ps(acc[c], inv);
+
+        // joint channels from the quaternions, one arm at a time
+        GLfloat lanes[BLEND_QUAT][4];
+        for (int c = 0; c < BLEND_QUAT; ++c) _mm_storeu_ps(lanes[c], q[c]);
+        for (int c = 0; c < NUM_JOINTS; ++c) _mm_storeu_ps(o[c] + k, acc[c]);
+        for (int a = 0; a < 4; ++a)
+        {
+            GLfloat r[BLEND_QUAT];
+            for (int c = 0; c < BLEND_QUAT; ++c) r[c] = lanes[c][a];
+            set_joints(o, k + a, r);
+        }
+        for (int c = 0; c < NUM_JOINTS; ++c) acc[c] = _mm_loadu_ps(o[c] + k);
+
+        for (int j = 0; j < nl; ++j)
+        {
+            const __m128 a = _mm_loadu_ps(&amount_[j][k]);
+            const GLfloat * layer = &layer_[j * BLEND_CHANNELS];
+            for (int c = 0; c < BLEND_CHANNELS; ++c)
+                acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(a, _mm_set1_ps(layer[c])));
+        }
+        for (int c = 0; c < BLEND_CHANNELS; ++c) _mm_storeu_ps(o[c] + k, acc[c]);
+    }
+#endif
+
+    // the last arms (all of them without SSE)
+    for ( ; k < end; ++k)
+    {
+        GLfloat acc[BLEND_CHANNELS] = { 0 }, q[BLEND_QUAT] = { 0 };
+        GLfloat sum = 0.0f;
+        for (int i = 0; i < nk; ++i)
+        {
+            const GLfloat w = weight_[i][k];
+            const GLfloat * key = &key_[i * BLEND_CHANNELS];
+            sum += w;
+            for (int c = 0; c < BLEND_CHANNELS; ++c) acc[c] += w * key[c];
+
+            const GLfloat * kq = &key_q_[i * BLEND_QUAT];
+            for (int j = 0; j < BLEND_QUAT; j += 4)
+            {
+                GLfloat d = 0.0f;
+                for (int c = j; c < j + 4; ++c) d += q[c] * kq[c];
+                const GLfloat sw = d < 0.0f ? -w : w;
+                for (int c = j; c < j + 4; ++c) q[c] += sw * kq[c];
+            }
+        }
+        const GLfloat inv = sum > 0.0f ? 1.0f / sum : 0.0f;
+        for (int c = 0; c < BLEND_CHANNELS; ++c) acc[c] *= inv;
+        for (int c = 0; c < NUM_JOINTS; ++c) o[c][k] = acc[c];
+        set_joints(o, k, q);
+        for (int c = 0; c < NUM_JOINTS; ++c) acc[c] = o[c][k];
+
+        for (int j = 0; j < nl; ++j)
+        {
+            const GLfloat a = amount_[j][k];
+            const GLfloat * layer = &layer_[j * BLEND_CHANNELS];
+            for (int c = 0; c < BLEND_CHANNELS; ++c) acc[c] += a * layer[c];
+        }
+        for (int c = 0; c < BLEND_CHANNELS; ++c) o[c][k] = acc[c];
+    }
+}
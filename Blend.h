@@ -0,0 +1,97 @@
+// File  : Blend.h
+// Author: Cole Schwandt
+
+#ifndef BLEND_H
+#define BLEND_H
+
+#include <vector>
+#include "Kinematics.h"
+
+namespace arm
+{
+    // six joint angles (degrees, joint order), grip, base offset x y z
+    const int BLEND_CHANNELS = NUM_JOINTS + 4;
+    const int BLEND_GRIP = NUM_JOINTS;
+    const int BLEND_BASE = NUM_JOINTS + 1;
+
+    // a keyframe's shoulder and elbow quaternions (w x y z each)
+    const int BLEND_QUAT = 8;
+
+    //-------------------------------------------------------------------------
+    // PoseArray
+    //
+    // Many poses packed one array per channel (structure of arrays), so a
+    // channel of consecutive arms is contiguous.
+    //-------------------------------------------------------------------------
+    struct PoseArray
+    {
+        std::vector< GLfloat > channel[BLEND_CHANNELS];
+
+        void resize(size_t n);                  // all channels 0
+        size_t size() const { return channel[0].size(); }
+
+        Pose pose(size_t k) const;
+        void set(size_t k, const Pose & p);
+    };
+
+    //-------------------------------------------------------------------------
+    // BlendTree
+    //
+    // Blends whole poses for many arms at once. Keyframes are poses shared
+    // by every arm; each arm has its own weight per keyframe and its own
+    // amount per additive layer (a pose used as an offset):
+    //
+    //     pose[k] = blend_i(w_i[k], key_i) + sum_j a_j[k] layer_j
+    //
+    // The keyframes' ball joints blend as quaternions, not Euler angles
+    // (see slerp() in Kinematics.h): a weighted sum, each key flipped into
+    // the hemisphere of the sum so far, then normalized. For two keys this
+    // is nlerp. Grip and base blend linearly (weights summing to 1). The
+    // layers are offsets to the Euler angles, so they stay in joint
+    // space, the way the joints are driven. An arm whose weights are all 0
+    // gets only its layers.
+    //
+    // evaluate() runs 4 arms per SSE instruction (plain C++ elsewhere);
+    // only turning the blended quaternions back into angles is per arm.
+    // Disjoint arm ranges can be evaluated, and their weights written, on
+    // different threads.
+    //
+    // USAGE:
+    // arm::BlendTree tree(arms);
+    // const int rest = tree.add_keyframe(home);
+    // const int reach = tree.add_keyframe(approach);
+    // const int wobble = tree.add_layer(shake);
+    // tree.weight(rest)[k] = 1 - s;               // per arm, each tick
+    // tree.weight(reach)[k] = s;
+    // tree.amount(wobble)[k] = 0.5f;
+    // tree.evaluate(0, arms, poses);
+    //-------------------------------------------------------------------------
+    class BlendTree
+    {
+    public:
+        BlendTree(size_t arms);
+
+        int add_keyframe(const Pose & key);     // weights start at 0
+        int add_layer(const Pose & offset);     // amounts start at 0
+
+        GLfloat * weight(int key)               { return &weight_[key][0]; }
+        GLfloat * amount(int layer)             { return &amount_[layer][0]; }
+
+        int keyframes() const  { return int(weight_.size()); }
+        int layers() const     { return int(amount_.size()); }
+        size_t size() const    { return n_; }
+
+        // arms [begin, end) of out, which must hold size() poses
+        void evaluate(size_t begin, size_t end, PoseArray & out) const;
+
+    private:
+        size_t n_;
+        std::vector< GLfloat > key_;                    // BLEND_CHANNELS each
+        std::vector< GLfloat > key_q_;                  // BLEND_QUAT each
+        std::vector< GLfloat > layer_;
+        std::vector< std::vector< GLfloat > > weight_;  // per keyframe, per arm
+        std::vector< std::vector< GLfloat > > amount_;  // per layer, per arm
+    };
+}
+
+#endif
@@ -0,0 +1,88 @@
+// File  : BlockingQueue.h
+// Author: Cole Schwandt
+
+#ifndef BLOCKINGQUEUE_H
+#define BLOCKINGQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // BlockingQueue
+    //
+    // Bounded multi-producer/multi-consumer FIFO for handing work between
+    // worker threads (render -> encode/write). push() blocks while full and
+    // pop() blocks while empty; after close() pop() drains what is left and
+    // then returns false.
+    //
+    // Not for the GLUT thread: anything on the render loop should use the
+    // non-blocking try_push()/try_pop().
+    //-------------------------------------------------------------------------
+    template < typename T >
+    class BlockingQueue
+    {
+    public:
+        BlockingQueue(size_t capacity)
+            : capacity_(capacity), closed_(false)
+        {}
+
+        void push(const T & x)
+        {
+            std::unique_lock< std::mutex > lock(mutex_);
+            not_full_.wait(lock, [this] { return q_.size() < capacity_ || closed_; });
+            q_.push_back(x);
+            not_empty_.notify_one();
+        }
+
+        bool try_push(const T & x)
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            if (q_.size() >= capacity_) return false;
+            q_.push_back(x);
+            not_empty_.notify_one();
+            return true;
+        }
+
+        bool pop(T & x)
+        {
+            std::unique_lock< std::mutex > lock(mutex_);
+            not_empty_.wait(lock, [this] { return !q_.empty() || closed_; });
+            if (q_.empty()) return false;
+            x = q_.front();
+            q_.pop_front();
+            not_full_.notify_one();
+            return true;
+        }
+
+        bool try_pop(T & x)
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            if (q_.empty()) return false;
+            x = q_.front();
+            q_.pop_front();
+            not_full_.notify_one();
+            return true;
+        }
+
+        void close()
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            closed_ = true;
+            not_empty_.notify_all();
+            not_full_.notify_all();
+        }
+
+    private:
+        size_t capacity_;
+        bool closed_;
+        std::deque< T > q_;
+        std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+    };
+}
+
+#endif
@@ -0,0 +1,121 @@
+// File  : Broadphase.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include "Broadphase.h"
+
+namespace
+{
+    inline void grow(arm::Footprint & f, const arm::Vec3 & c, float r)
+    {
+        f.x0 = std::min(f.x0, c.x - r);
+        f.x1 = std::max(f.x1, c.x + r);
+        f.z0 = std::min(f.z0, c.z - r);
+        f.z1 = std::max(f.z1, c.z + r);
+    }
+
+    inline void grow(arm::Footprint & f, const arm::Capsule & c)
+    {
+        grow(f, c.a, c.r);
+        grow(f, c.b, c.r);
+    }
+
+    inline uint32_t hash(int32_t ix, int32_t iz)
+    {
+        return uint32_t(ix) * 73856093u ^ uint32_t(iz) * 19349663u;
+    }
+}
+
+arm::Footprint arm::footprint(const ArmShapes & s, const Box & base)
+{
+    Footprint f = { base.lo.x, base.lo.z, base.hi.x, base.hi.z };
+    grow(f, s.shoulder.c, s.shoulder.r);
+    grow(f, s.upper_arm);
+    grow(f, s.elbow.c, s.elbow.r);
+    grow(f, s.forearm);
+    grow(f, s.palm.c, s.palm.r);
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        grow(f, s.proximal[i]);
+        grow(f, s.distal[i]);
+    }
+    return f;
+}
+
+void arm::all_pairs(const std::vector< Footprint > & f,
+                    std::vector< ArmPair > & pairs)
+{
+    pairs.clear();
+    const uint32_t n = uint32_t(f.size());
+    for (uint32_t i = 0; i < n; ++i)
+        for (uint32_t j = i + 1; j < n; ++j)
+            if (overlap(f[i], f[j])) pairs.push_back(ArmPair(i, j));
+}
+
+arm::SpatialHash::SpatialHash(GLfloat cell)
+    : inv_cell_(1.0f / cell)
+{}
+
+int32_t arm::SpatialHash::cell(GLfloat v) const
+{
+    return int32_t(std::floor(v * inv_cell_));
+}
+
+void arm::SpatialHash::pairs(const std::vector< Footprint > & f,
+                             std::vector< ArmPair > & pairs)
+{
+    pairs.clear();
+
+    // every cell each footprint covers
+    entries_.clear();
+    for (uint32_t i = 0; i < f.size(); ++i)
+    {
+        const int32_t x0 = cell(f[i].x0), x1 = cell(f[i].x1);
+        const int32_t z0 = cell(f[i].z0), z1 = cell(f[i].z1);
+        for (int32_t iz = z0; iz <= z1; ++iz)
+            for (int32_t ix = x0; ix <= x1; ++ix)
+            {
+                const Entry e = { ix, iz, i };
+                entries_.push_back(e);
+            }
+    }
+
+    // counting sort into power-of-two buckets, at least two per entry
+    uint32_t buckets = 16;
+    while (buckets < 2 * entries_.size()) buckets *= 2;
+    const uint32_t mask = buckets - 1;
+    start_.assign(buckets + 1, 0);
+    for (size_t k = 0; k < entries_.size(); ++k)
+        ++start_[(hash(entries_[k].ix, entries_[k].iz) & mask) + 1];
+    for (uint32_t b = 0; b < buckets; ++b) start_[b + 1] += start_[b];
+    sorted_.resize(entries_.size());
+    for (size_t k = 0; k < entries_.size(); ++k)
+    {
+        const uint32_t b = hash(entries_[k].ix, entries_[k].iz) & mask;
+        sorted_[start_[b]++] = entries_[k];
+    }
+    // start_[b] now holds the end of bucket b: shift back by one
+    for (uint32_t b = buckets; b > 0; --b) start_[b] = start_[b - 1];
+    start_[0] = 0;
+
+    for (uint32_t b = 0; b < buckets; ++b)
+    {
+        for (uint32_t p = start_[b]; p < start_[b + 1]; ++p)
+        {
+            const Entry & e = sorted_[p];
+            for (uint32_t q = p + 1; q < start_[b + 1]; ++q)
+            {
+                const Entry & g = sorted_[q];
+                if (g.ix != e.ix || g.iz != e.iz) continue;   // hash clash
+                const Footprint & a = f[e.arm], & c = f[g.arm];
+                if (!overlap(a, c)) continue;
+                if (cell(std::max(a.x0, c.x0)) != e.ix
+                    || cell(std::max(a.z0, c.z0)) != e.iz)
+                    continue;                   // reported by another cell
+                pairs.push_back(ArmPair(std::min(e.arm, g.arm),
+                                        std::max(e.arm, g.arm)));
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+// File  : Broadphase.h
+// Author: Cole Schwandt
+
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Collision.h"
+
+namespace cfg
+{
+    // -------- broadphase --------
+    // Cell edge on the floor plane, a whole number of draw_xz_plane()
+    // squares so cells line up with the drawn grid. About the footprint
+    // of one station: an arm covers 2x2 to 4x4 cells.
+    const GLfloat BROADPHASE_CELL = 4.0f;
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // Footprint
+    //
+    // Axis-aligned bounds of an arm and its base projected onto the XZ
+    // (floor) plane. Two arms can only touch if their footprints overlap.
+    //-------------------------------------------------------------------------
+    struct Footprint
+    {
+        GLfloat x0, z0, x1, z1;
+    };
+
+    Footprint footprint(const ArmShapes & s, const Box & base);
+
+    inline bool overlap(const Footprint & a, const Footprint & b)
+    {
+        return a.x0 <= b.x1 && b.x0 <= a.x1 && a.z0 <= b.z1 && b.z0 <= a.z1;
+    }
+
+    // (i, j), i < j: indices of two arms whose footprints overlap
+    typedef std::pair< uint32_t, uint32_t > ArmPair;
+
+    // Reference broadphase: every pair, O(n^2).
+    void all_pairs(const std::vector< Footprint > & f,
+                   std::vector< ArmPair > & pairs);
+
+    //-------------------------------------------------------------------------
+    // SpatialHash
+    //
+    // Uniform grid on the floor plane, stored as a hash from cell to the
+    // arms whose footprint covers it, rebuilt from scratch on each call.
+    // Only arms sharing a cell are compared. A pair sharing several cells
+    // is reported once, from the cell holding the low corner of the two
+    // footprints' intersection, so no duplicate filtering is needed.
+    // Buffers are kept between calls: no allocation once warmed up.
+    //
+    // USAGE:
+    // arm::SpatialHash hash;
+    // hash.pairs(footprints, candidates);       // every tick
+    // ... narrow phase on candidates ...
+    //-------------------------------------------------------------------------
+    class SpatialHash
+    {
+    public:
+        SpatialHash(GLfloat cell=cfg::BROADPHASE_CELL);
+
+        void pairs(const std::vector< Footprint > & f,
+                   std::vector< ArmPair > & pairs);
+
+        size_t entries() const { return entries_.size(); }  // arm-cell pairs
+
+    private:
+        struct Entry
+        {
+            int32_t ix, iz;
+            uint32_t arm;
+        };
+
+        int32_t cell(GLfloat v) const;
+
+        GLfloat inv_cell_;
+        std::vector< Entry > entries_;
+        std::vector< Entry > sorted_;       // grouped by bucket
+        std::vector< uint32_t > start_;     // bucket b: sorted_[start_[b], start_[b + 1])
+    };
+}
+
+#endif
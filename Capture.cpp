@@ -0,0 +1,178 @@
+// File  : Capture.cpp
+// Author: Cole Schwandt
+
+#define GL_GLEXT_PROTOTYPES
+#include <cstring>
+#include <iostream>
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include "debug.h"
+#include "Capture.h"
+
+mygllib::FrameCapture::FrameCapture(const std::string & path, int w, int h,
+                                    int fps)
+    : w_(w), h_(h), out_(fopen(path.c_str(), "wb")), scale_fbo_(0),
+      scale_color_(0), frame_(0),
+      finished_(false), buffers_(ENCODE_BUFFERS),
+      free_(ENCODE_BUFFERS), full_(ENCODE_BUFFERS),
+      written_(0), dropped_(0)
+{
+    if (out_ == NULL)
+    {
+        std::cout << "capture: cannot write " << path << std::endl;
+        throw CaptureError();
+    }
+    fprintf(out_, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", w_, h_, fps);
+
+    const size_t bytes = size_t(w_) * h_ * 4;
+    glGenBuffers(RING, pbo_);
+    for (int i = 0; i < RING; ++i)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    for (int i = 0; i < ENCODE_BUFFERS; ++i)
+    {
+        buffers_[i].resize(bytes);
+        free_.push(&buffers_[i]);
+    }
+    encoder_ = std::thread(&FrameCapture::encode, this);
+}
+
+mygllib::FrameCapture::~FrameCapture()
+{
+    finish();
+}
+
+void mygllib::FrameCapture::capture(int w, int h)
+{
+    GLint read;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read);
+    if (w != w_ || h != h_) glBindFramebuffer(GL_READ_FRAMEBUFFER, scale(w, h));
+
+    // queue the copy of this frame ...
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[frame_ % RING]);
+    GL_CALL(glReadPixels(0, 0, w_, h_, GL_RGBA, GL_UNSIGNED_BYTE, 0));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read);
+
+    // ... and collect frame N-2, whose copy has had two frames to land
+    if (frame_ >= RING - 1) consume((frame_ - (RING - 1)) % RING, false);
+    ++frame_;
+}
+
+// Blits the w x h frame being drawn into a framebuffer of the stream's
+// size and returns it for reading.
+GLint mygllib::FrameCapture::scale(int w, int h)
+{
+    if (scale_fbo_ == 0)
+    {
+        glGenRenderbuffers(1, &scale_color_);
+        glBindRenderbuffer(GL_RENDERBUFFER, scale_color_);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w_, h_);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        GLint draw;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+        glGenFramebuffers(1, &scale_fbo_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, scale_fbo_);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, scale_color_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw);
+    }
+
+    GLint draw;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, draw);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, scale_fbo_);
+    GL_CALL(glBlitFramebuffer(0, 0, w, h, 0, 0, w_, h_, GL_COLOR_BUFFER_BIT,
+                              GL_LINEAR));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw);
+    return scale_fbo_;
+}
+
+void mygllib::FrameCapture::consume(int slot, bool wait)
+{
+    std::vector< unsigned char > * buf;
+    if (wait)
+    {
+        free_.pop(buf);
+    }
+    else if (!free_.try_pop(buf))
+    {
+        ++dropped_;
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[slot]);
+    const void * p;
+    GL_CALL(p = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if (p != NULL)
+    {
+        memcpy(&(*buf)[0], p, buf->size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (p == NULL)
+    {
+        ++dropped_;
+        free_.push(buf);
+        return;
+    }
+    full_.push(buf);
+}
+
+void mygllib::FrameCapture::finish()
+{
+    if (finished_) return;
+    finished_ = true;
+
+    // the last frames still sitting in the ring; waiting is fine here
+    const uint64_t first = frame_ >= RING - 1 ? frame_ - (RING - 1) : 0;
+    for (uint64_t f = first; f < frame_; ++f) consume(f % RING, true);
+
+    full_.close();
+    encoder_.join();
+    glDeleteBuffers(RING, pbo_);
+    if (scale_fbo_ != 0)
+    {
+        glDeleteFramebuffers(1, &scale_fbo_);
+        glDeleteRenderbuffers(1, &scale_color_);
+    }
+    fclose(out_);
+}
+
+// RGBA (bottom-up) -> Y4M 4:4:4, BT.601 studio range
+void mygllib::FrameCapture::encode()
+{
+    std::vector< unsigned char > planes(size_t(w_) * h_ * 3);
+    unsigned char * Y = &planes[0];
+    unsigned char * U = Y + size_t(w_) * h_;
+    unsigned char * V = U + size_t(w_) * h_;
+
+    std::vector< unsigned char > * buf;
+    while (full_.pop(buf))
+    {
+        size_t o = 0;
+        for (int y = h_ - 1; y >= 0; --y)
+        {
+            const unsigned char * p = &(*buf)[size_t(y) * w_ * 4];
+            for (int x = 0; x < w_; ++x, ++o, p += 4)
+            {
+                const int r = p[0], g = p[1], b = p[2];
+                Y[o] = (unsigned char) ((66 * r + 129 * g + 25 * b + 128 + 4096) >> 8);
+                U[o] = (unsigned char) ((-38 * r - 74 * g + 112 * b + 128 + 32768) >> 8);
+                V[o] = (unsigned char) ((112 * r - 94 * g - 18 * b + 128 + 32768) >> 8);
+            }
+        }
+        free_.push(buf);
+
+        fputs("FRAME\n", out_);
+        fwrite(&planes[0], 1, planes.size(), out_);
+        ++written_;
+    }
+}
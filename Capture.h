@@ -0,0 +1,88 @@
+// File  : Capture.h
+// Author: Cole Schwandt
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GL/freeglut.h>
+#include "BlockingQueue.h"
+
+namespace mygllib
+{
+    class CaptureError
+    {};
+
+    //-------------------------------------------------------------------------
+    // FrameCapture
+    //
+    // Records the rendered frames to a raw Y4M (YUV 4:4:4) file without
+    // stalling the render loop. glReadPixels() goes into a ring of three
+    // pixel-buffer objects, so it only queues a copy. The buffer filled two
+    // frames earlier is mapped and handed to a background encoder thread.
+    // If the encoder falls behind, frames are dropped and counted; the
+    // render loop never waits for it.
+    //
+    // The stream keeps the size it was opened with. capture() is given
+    // the size of the frame drawn; if the window has been resized since,
+    // the frame is first scaled to the stream's size with a blit.
+    //
+    // USAGE:
+    // mygllib::FrameCapture capture("session.y4m", w, h);
+    // void display()
+    // {
+    //     ... draw ...
+    //     capture.capture(w, h);  // before swapping
+    //     glutSwapBuffers();
+    // }
+    // ...
+    // capture.finish();           // flushes the last two frames
+    //
+    // finish() (or the destructor) must run while the context is current.
+    //-------------------------------------------------------------------------
+    class FrameCapture
+    {
+    public:
+        FrameCapture(const std::string & path, int w, int h, int fps=60);
+        ~FrameCapture();
+
+        void capture(int w, int h);     // frame of w x h in the draw buffer
+        void finish();
+
+        int width() const  { return w_; }
+        int height() const { return h_; }
+        size_t frames_written() const { return written_; }
+        size_t frames_dropped() const { return dropped_; }
+
+    private:
+        FrameCapture(const FrameCapture &);
+        FrameCapture & operator=(const FrameCapture &);
+
+        static const int RING = 3;
+        static const int ENCODE_BUFFERS = 4;
+
+        GLint scale(int w, int h);
+        void consume(int slot, bool wait);
+        void encode();
+
+        int w_, h_;
+        FILE * out_;
+        GLuint pbo_[RING];
+        GLuint scale_fbo_, scale_color_;        // only once resized
+        uint64_t frame_;
+        bool finished_;
+
+        std::vector< std::vector< unsigned char > > buffers_;
+        BlockingQueue< std::vector< unsigned char > * > free_;
+        BlockingQueue< std::vector< unsigned char > * > full_;
+        std::thread encoder_;
+        std::atomic< size_t > written_;
+        size_t dropped_;
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+// File  : Clock.h
+// Author: Cole Schwandt
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <cstdint>
+#include <time.h>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // Monotonic time in nanoseconds. CLOCK_MONOTONIC is shared by every
+    // process on the host, so stamps taken in a client can be compared with
+    // stamps taken in the visualizer.
+    //-------------------------------------------------------------------------
+    inline
+    int64_t now_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    inline
+    double ns_to_ms(int64_t ns)
+    {
+        return ns / 1e6;
+    }
+}
+
+#endif
@@ -0,0 +1,340 @@
+// File  : Collision.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include "Collision.h"
+
+namespace
+{
+    inline float clamp01(float t)
+    {
+        return t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    }
+
+    inline float sq(float x) { return x * x; }
+
+    const int ARM_SPHERES = 3;
+    const int ARM_CAPSULES = 2 + 2 * arm::NUM_FINGERS;
+
+    void parts(const arm::ArmShapes & s, const arm::Sphere * sphere[],
+               const arm::Capsule * capsule[])
+    {
+        sphere[0] = &s.shoulder;
+        sphere[1] = &s.elbow;
+        sphere[2] = &s.palm;
+        capsule[0] = &s.upper_arm;
+        capsule[1] = &s.forearm;
+        for (int i = 0; i < arm::NUM_FINGERS; ++i)
+        {
+            capsule[2 + i] = &s.proximal[i];
+            capsule[2 + arm::NUM_FINGERS + i] = &s.distal[i];
+        }
+    }
+
+    // any part of one arm against a box
+    bool hits(const arm::Sphere * const sphere[],
+              const arm::Capsule * const capsule[], const arm::Box & box)
+    {
+        for (int i = 0; i < ARM_SPHERES; ++i)
+            if (overlap(*sphere[i], box)) return true;
+        for (int i = 0; i < ARM_CAPSULES; ++i)
+            if (overlap(*capsule[i], box)) return true;
+        return false;
+    }
+}
+
+float arm::closest_t(const Vec3 & a, const Vec3 & b, const Vec3 & p)
+{
+    const Vec3 ab = b - a;
+    const float d = dot(ab, ab);
+    return d > 0.0f ? clamp01(dot(p - a, ab) / d) : 0.0f;
+}
+
+float arm::segment_point_dist2(const Vec3 & a, const Vec3 & b, const Vec3 & p)
+{
+    return length2(a + (b - a) * closest_t(a, b, p) - p);
+}
+
+float arm::segment_segment_dist2(const Vec3 & p0, const Vec3 & p1,
+                                 const Vec3 & q0, const Vec3 & q1)
+{
+    float s, t;
+    return segment_segment_dist2(p0, p1, q0, q1, s, t);
+}
+
+// Closest points of two segments (Ericson, Real-Time Collision Detection 5.1.9)
+float arm::segment_segment_dist2(const Vec3 & p0, const Vec3 & p1,
+                                 const Vec3 & q0, const Vec3 & q1,
+                                 float & s, float & t)
+{
+    const float EPS = 1e-12f;
+    const Vec3 d1 = p1 - p0;
+    const Vec3 d2 = q1 - q0;
+    const Vec3 r  = p0 - q0;
+    const float a = dot(d1, d1);
+    const float e = dot(d2, d2);
+    const float f = dot(d2, r);
+
+    if (a <= EPS && e <= EPS)
+    {
+        s = t = 0.0f;
+        return length2(r);
+    }
+    if (a <= EPS)
+    {
+        s = 0.0f;
+        t = clamp01(f / e);
+    }
+    else
+    {
+        const float c = dot(d1, r);
+        if (e <= EPS)
+        {
+            t = 0.0f;
+            s = clamp01(-c / a);
+        }
+        else
+        {
+            const float b = dot(d1, d2);
+            const float denom = a * e - b * b;
+            s = denom > EPS ? clamp01((b * f - c * e) / denom) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f)
+            {
+                t = 0.0f;
+                s = clamp01(-c / a);
+            }
+            else if (t > 1.0f)
+            {
+                t = 1.0f;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+    return length2((p0 + d1 * s) - (q0 + d2 * t));
+}
+
+float arm::point_box_dist2(const Vec3 & p, const Box & box)
+{
+    float d = 0.0f;
+    if (p.x < box.lo.x) d += sq(box.lo.x - p.x); else if (p.x > box.hi.x) d += sq(p.x - box.hi.x);
+    if (p.y < box.lo.y) d += sq(box.lo.y - p.y); else if (p.y > box.hi.y) d += sq(p.y - box.hi.y);
+    if (p.z < box.lo.z) d += sq(box.lo.z - p.z); else if (p.z > box.hi.z) d += sq(p.z - box.hi.z);
+    return d;
+}
+
+arm::Vec3 arm::closest_point(const Vec3 & p, const Box & box)
+{
+    return Vec3(std::min(std::max(p.x, box.lo.x), box.hi.x),
+                std::min(std::max(p.y, box.lo.y), box.hi.y),
+                std::min(std::max(p.z, box.lo.z), box.hi.z));
+}
+
+float arm::segment_box_dist2(const Vec3 & a, const Vec3 & b, const Box & box)
+{
+    float t;
+    return segment_box_dist2(a, b, box, t);
+}
+
+// Distance to a convex set is convex along a segment, so a fixed number of
+// golden-section steps finds the minimum to well under a micron here.
+float arm::segment_box_dist2(const Vec3 & a, const Vec3 & b, const Box & box,
+                             float & t)
+{
+    const float G = 0.618033988f;
+    const Vec3 ab = b - a;
+    float lo = 0.0f, hi = 1.0f;
+    float t1 = hi - G * (hi - lo), t2 = lo + G * (hi - lo);
+    float f1 = point_box_dist2(a + ab * t1, box);
+    float f2 = point_box_dist2(a + ab * t2, box);
+    for (int i = 0; i < 24; ++i)
+    {
+        if (f1 <= f2)
+        {
+            hi = t2; t2 = t1; f2 = f1;
+            t1 = hi - G * (hi - lo);
+            f1 = point_box_dist2(a + ab * t1, box);
+        }
+        else
+        {
+            lo = t1; t1 = t2; f1 = f2;
+            t2 = lo + G * (hi - lo);
+            f2 = point_box_dist2(a + ab * t2, box);
+        }
+    }
+    float best = f1;
+    t = t1;
+    if (f2 < best) { best = f2; t = t2; }
+    const float fa = point_box_dist2(a, box), fb = point_box_dist2(b, box);
+    if (fa < best) { best = fa; t = 0.0f; }
+    if (fb < best) { best = fb; t = 1.0f; }
+    return best;
+}
+
+bool arm::overlap(const Sphere & s, const Sphere & t)
+{
+    return length2(s.c - t.c) < sq(s.r + t.r);
+}
+
+bool arm::overlap(const Capsule & c, const Sphere & s)
+{
+    return segment_point_dist2(c.a, c.b, s.c) < sq(c.r + s.r);
+}
+
+bool arm::overlap(const Capsule & c, const Capsule & d)
+{
+    return segment_segment_dist2(c.a, c.b, d.a, d.b) < sq(c.r + d.r);
+}
+
+bool arm::overlap(const Capsule & c, const Box & box)
+{
+    // cheap reject against the box's bounding sphere before the search
+    const Vec3 center = (box.lo + box.hi) * 0.5f;
+    if (segment_point_dist2(c.a, c.b, center)
+        >= sq(c.r + length(box.hi - center)))
+        return false;
+    return segment_box_dist2(c.a, c.b, box) < sq(c.r);
+}
+
+bool arm::overlap(const Sphere & s, const Box & box)
+{
+    return point_box_dist2(s.c, box) < sq(s.r);
+}
+
+void arm::arm_shapes(const Frames & f, ArmShapes & s)
+{
+    const Vec3 link(0.0f, cfg::ARM_L, 0.0f);
+    // the digits' capsules also cover the joint spheres at their ends
+    const float digit_r = std::max(cfg::FINGER_DIGIT_R, cfg::FINGER_JOINT_R);
+
+    s.shoulder.c  = f.shoulder.origin();
+    s.shoulder.r  = cfg::JOINT_R;
+    s.upper_arm.a = f.upper_arm.origin();
+    s.upper_arm.b = f.upper_arm.point(link);
+    s.upper_arm.r = cfg::ARM_R;
+    s.elbow.c     = f.elbow.origin();
+    s.elbow.r     = cfg::JOINT_R;
+    s.forearm.a   = f.forearm.origin();
+    s.forearm.b   = f.forearm.point(link);
+    s.forearm.r   = cfg::ARM_R;
+    s.palm.c      = f.palm.origin();
+    s.palm.r      = 0.5f * sqrtf(3.0f) * cfg::PALM_SIZE;  // corners
+
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        s.proximal[i].a = f.knuckle[i].origin();
+        s.proximal[i].b = f.middle[i].origin();
+        s.proximal[i].r = digit_r;
+        s.distal[i].a   = f.distal[i].origin();
+        s.distal[i].b   = f.fingertip[i].origin();
+        s.distal[i].r   = digit_r;
+    }
+}
+
+arm::Box arm::base_box(const Pose & pose)
+{
+    const Vec3 half(0.5f * cfg::BASE_SIZE * cfg::BASE_SX,
+                    0.5f * cfg::BASE_SIZE * cfg::BASE_SY,
+                    0.5f * cfg::BASE_SIZE * cfg::BASE_SZ);
+    const Vec3 c(pose.xb, pose.yb, pose.zb);
+    Box b = { c - half, c + half };
+    return b;
+}
+
+bool arm::in_collision(const Pose & pose, const ArmShapes & s)
+{
+    return in_collision(s, base_box(pose));
+}
+
+bool arm::in_collision(const ArmShapes & s, const Box & base)
+{
+    // against the base (the shoulder sits in it by design)
+    if (overlap(s.upper_arm, base) || overlap(s.elbow, base)
+        || overlap(s.forearm, base) || overlap(s.palm, base))
+        return true;
+
+    // hand folded back onto the shoulder or upper arm
+    if (overlap(s.forearm, s.shoulder) || overlap(s.upper_arm, s.palm)
+        || overlap(s.shoulder, s.palm))
+        return true;
+
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        if (overlap(s.distal[i], base) || overlap(s.proximal[i], base)
+            || overlap(s.distal[i], s.upper_arm)
+            || overlap(s.distal[i], s.shoulder))
+            return true;
+    }
+    return false;
+}
+
+void arm::translate(ArmShapes & s, const Vec3 & d)
+{
+    s.shoulder.c  += d;
+    s.upper_arm.a += d;
+    s.upper_arm.b += d;
+    s.elbow.c     += d;
+    s.forearm.a   += d;
+    s.forearm.b   += d;
+    s.palm.c      += d;
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        s.proximal[i].a += d;
+        s.proximal[i].b += d;
+        s.distal[i].a   += d;
+        s.distal[i].b   += d;
+    }
+}
+
+bool arm::overlap(const ArmShapes & a, const Box & base_a,
+                  const ArmShapes & b, const Box & base_b)
+{
+    const Sphere * sa[ARM_SPHERES], * sb[ARM_SPHERES];
+    const Capsule * ca[ARM_CAPSULES], * cb[ARM_CAPSULES];
+    parts(a, sa, ca);
+    parts(b, sb, cb);
+
+    for (int i = 0; i < ARM_SPHERES; ++i)
+    {
+        for (int k = 0; k < ARM_SPHERES; ++k)
+            if (overlap(*sa[i], *sb[k])) return true;
+        for (int k = 0; k < ARM_CAPSULES; ++k)
+            if (overlap(*cb[k], *sa[i])) return true;
+    }
+    for (int i = 0; i < ARM_CAPSULES; ++i)
+    {
+        for (int k = 0; k < ARM_SPHERES; ++k)
+            if (overlap(*ca[i], *sb[k])) return true;
+        for (int k = 0; k < ARM_CAPSULES; ++k)
+            if (overlap(*ca[i], *cb[k])) return true;
+    }
+    return hits(sa, ca, base_b) || hits(sb, cb, base_a);
+}
+
+bool arm::overlap(const ArmShapes & s, const Obstacles & obstacles)
+{
+    const Sphere * sphere[ARM_SPHERES];
+    const Capsule * capsule[ARM_CAPSULES];
+    parts(s, sphere, capsule);
+
+    for (size_t k = 0; k < obstacles.spheres.size(); ++k)
+    {
+        const Sphere & o = obstacles.spheres[k];
+        for (int i = 0; i < ARM_SPHERES; ++i)
+            if (overlap(*sphere[i], o)) return true;
+        for (int i = 0; i < ARM_CAPSULES; ++i)
+            if (overlap(*capsule[i], o)) return true;
+    }
+    for (size_t k = 0; k < obstacles.capsules.size(); ++k)
+    {
+        const Capsule & o = obstacles.capsules[k];
+        for (int i = 0; i < ARM_SPHERES; ++i)
+            if (overlap(o, *sphere[i])) return true;
+        for (int i = 0; i < ARM_CAPSULES; ++i)
+            if (overlap(*capsule[i], o)) return true;
+    }
+    for (size_t k = 0; k < obstacles.boxes.size(); ++k)
+        if (hits(sphere, capsule, obstacles.boxes[k])) return true;
+    return false;
+}
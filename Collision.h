@@ -0,0 +1,107 @@
+// File  : Collision.h
+// Author: Cole Schwandt
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <vector>
+#include "Kinematics.h"
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // Primitive shapes. Capsule is the segment a-b swept by radius r; Box is
+    // axis-aligned. All queries are closed-form or fixed-iteration and never
+    // allocate.
+    //-------------------------------------------------------------------------
+    struct Sphere
+    {
+        Vec3 c;
+        float r;
+    };
+
+    struct Capsule
+    {
+        Vec3 a, b;
+        float r;
+    };
+
+    struct Box
+    {
+        Vec3 lo, hi;
+    };
+
+    // parameter in [0,1] of the point on a-b closest to p
+    float closest_t(const Vec3 & a, const Vec3 & b, const Vec3 & p);
+    float segment_point_dist2(const Vec3 & a, const Vec3 & b, const Vec3 & p);
+    float segment_segment_dist2(const Vec3 & p0, const Vec3 & p1,
+                                const Vec3 & q0, const Vec3 & q1);
+    // same, also returning the closest points' parameters on each segment
+    float segment_segment_dist2(const Vec3 & p0, const Vec3 & p1,
+                                const Vec3 & q0, const Vec3 & q1,
+                                float & s, float & t);
+    float point_box_dist2(const Vec3 & p, const Box & box);
+    Vec3 closest_point(const Vec3 & p, const Box & box);
+    float segment_box_dist2(const Vec3 & a, const Vec3 & b, const Box & box);
+    float segment_box_dist2(const Vec3 & a, const Vec3 & b, const Box & box,
+                            float & t);
+
+    bool overlap(const Sphere & s, const Sphere & t);
+    bool overlap(const Capsule & c, const Sphere & s);
+    bool overlap(const Capsule & c, const Capsule & d);
+    bool overlap(const Capsule & c, const Box & box);
+    bool overlap(const Sphere & s, const Box & box);
+
+    //-------------------------------------------------------------------------
+    // ArmShapes
+    //
+    // Bounding primitives of one posed arm, derived from Frames. Each
+    // contains the part as drawn: the palm cube's sphere passes through
+    // its corners, and the finger capsules are as thick as the finger
+    // joints, which sit at their ends.
+    //-------------------------------------------------------------------------
+    struct ArmShapes
+    {
+        Sphere  shoulder;
+        Capsule upper_arm;
+        Sphere  elbow;
+        Capsule forearm;
+        Sphere  palm;
+        Capsule proximal[NUM_FINGERS];
+        Capsule distal[NUM_FINGERS];
+    };
+
+    void arm_shapes(const Frames & f, ArmShapes & s);
+    Box base_box(const Pose & pose);
+
+    // True if the arm hits its own base or folds back into itself.
+    // Neighbouring parts (which always touch) are not tested. The second
+    // form takes the base's box, e.g. one grown to cover a moving base.
+    bool in_collision(const Pose & pose, const ArmShapes & s);
+    bool in_collision(const ArmShapes & s, const Box & base);
+
+    // Moves every part by d, e.g. from the arm's frame to its station.
+    void translate(ArmShapes & s, const Vec3 & d);
+
+    // True if two different arms touch: any part of one against any part
+    // or the base of the other. Everything in world coordinates.
+    bool overlap(const ArmShapes & a, const Box & base_a,
+                 const ArmShapes & b, const Box & base_b);
+
+    //-------------------------------------------------------------------------
+    // Obstacles
+    //
+    // Static shapes around one arm, in the same frame as its ArmShapes.
+    //-------------------------------------------------------------------------
+    struct Obstacles
+    {
+        std::vector< Sphere > spheres;
+        std::vector< Capsule > capsules;
+        std::vector< Box > boxes;
+    };
+
+    // True if any part of the arm, fingers included, touches an obstacle.
+    bool overlap(const ArmShapes & s, const Obstacles & obstacles);
+}
+
+#endif
@@ -0,0 +1,266 @@
+// File  : Command.cpp
+// Author: Cole Schwandt
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "Clock.h"
+#include "SeqLock.h"
+#include "Command.h"
+
+namespace
+{
+    using mygllib::seq_write;
+    using mygllib::seq_try_read;
+
+    arm::Mailbox * map_mailbox(const char * name, bool create)
+    {
+        const int fd = create ? shm_open(name, O_CREAT | O_RDWR, 0666)
+                              : shm_open(name, O_RDWR, 0);
+        if (fd < 0) return NULL;
+        if (create && ftruncate(fd, sizeof(arm::Mailbox)) != 0)
+        {
+            close(fd);
+            return NULL;
+        }
+        void * p = mmap(NULL, sizeof(arm::Mailbox), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+        close(fd);
+        return p == MAP_FAILED ? NULL : static_cast< arm::Mailbox * >(p);
+    }
+
+    void make_addr(sockaddr_un & addr, const char * path)
+    {
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    }
+
+    int bind_dgram(const char * path)
+    {
+        const int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr;
+        make_addr(addr, path);
+        unlink(path);
+        if (bind(fd, (sockaddr *) &addr, sizeof(addr)) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+}
+
+//=============================================================================
+// CommandServer
+//=============================================================================
+arm::CommandServer::CommandServer(const char * shm_name, const char * sock_path)
+    : shm_name_(shm_name), sock_path_(sock_path),
+      mailbox_(map_mailbox(shm_name, true)),
+      sock_(bind_dgram(sock_path)),
+      last_seq_(0), pending_(false), pending_from_socket_(false),
+      pending_addr_len_(0)
+{
+    if (mailbox_ != NULL)
+    {
+        // The server owns the mailbox: a writer killed mid-write leaves
+        // a seq odd, which would fail every read after it. Start both
+        // halves even, with nothing pending.
+        mailbox_->cmd_seq.store(0, std::memory_order_relaxed);
+        mailbox_->ack_seq.store(0, std::memory_order_relaxed);
+        last_seq_ = 0;
+        mailbox_->magic = Mailbox::MAGIC;
+        mailbox_->version = Mailbox::VERSION;
+    }
+    else
+    {
+        std::cout << "command: no shared memory mailbox " << shm_name
+                  << ", socket only" << std::endl;
+    }
+    if (sock_ < 0)
+    {
+        std::cout << "command: cannot bind " << sock_path << std::endl;
+    }
+}
+
+arm::CommandServer::~CommandServer()
+{
+    if (mailbox_ != NULL)
+    {
+        munmap(mailbox_, sizeof(Mailbox));
+        shm_unlink(shm_name_);
+    }
+    if (sock_ >= 0)
+    {
+        close(sock_);
+        unlink(sock_path_);
+    }
+}
+
+bool arm::CommandServer::poll_shm(Command & cmd)
+{
+    if (mailbox_ == NULL) return false;
+    if (mailbox_->cmd_seq.load(std::memory_order_acquire) == last_seq_)
+        return false;
+
+    uint32_t s;
+    if (!seq_try_read(mailbox_->cmd_seq, mailbox_->cmd, cmd, s)) return false;
+    last_seq_ = s;
+    return true;
+}
+
+bool arm::CommandServer::poll_socket(Command & cmd)
+{
+    if (sock_ < 0) return false;
+
+    // drain the queue; only the newest command matters
+    bool got = false;
+    Command c;
+    sockaddr_un from;
+    for (;;)
+    {
+        socklen_t len = sizeof(from);
+        const ssize_t n = recvfrom(sock_, &c, sizeof(c), 0,
+                                   (sockaddr *) &from, &len);
+        if (n < 0) break;
+        if (n != sizeof(c)) continue;
+        cmd = c;
+        pending_addr_ = from;
+        pending_addr_len_ = len;
+        got = true;
+    }
+    return got;
+}
+
+bool arm::CommandServer::poll(Command & cmd)
+{
+    Command shm_cmd, sock_cmd;
+    const bool from_shm  = poll_shm(shm_cmd);
+    const bool from_sock = poll_socket(sock_cmd);
+    if (!from_shm && !from_sock) return false;
+
+    if (from_sock && (!from_shm || sock_cmd.sent_ns > shm_cmd.sent_ns))
+    {
+        cmd = sock_cmd;
+        pending_from_socket_ = true;
+    }
+    else
+    {
+        cmd = shm_cmd;
+        pending_from_socket_ = false;
+    }
+
+    pending_ = true;
+    pending_ack_.id = cmd.id;
+    pending_ack_.sent_ns = cmd.sent_ns;
+    return true;
+}
+
+void arm::CommandServer::frame_presented(uint64_t frame)
+{
+    if (!pending_) return;
+    pending_ = false;
+    pending_ack_.frame_ns = mygllib::now_ns();
+    pending_ack_.frame = frame;
+
+    if (pending_from_socket_)
+    {
+        if (pending_addr_len_ > sizeof(sa_family_t))
+        {
+            sendto(sock_, &pending_ack_, sizeof(pending_ack_), MSG_DONTWAIT,
+                   (sockaddr *) &pending_addr_, pending_addr_len_);
+        }
+    }
+    else
+    {
+        seq_write(mailbox_->ack_seq, mailbox_->ack, pending_ack_);
+    }
+}
+
+//=============================================================================
+// CommandClient
+//=============================================================================
+arm::CommandClient::CommandClient(Transport transport,
+                                  const char * shm_name,
+                                  const char * sock_path)
+    : transport_(transport), mailbox_(NULL), sock_(-1),
+      next_id_(1), last_ack_seq_(0)
+{
+    client_path_[0] = '\0';
+    if (transport_ == SHM)
+    {
+        mailbox_ = map_mailbox(shm_name, false);
+        if (mailbox_ == NULL || mailbox_->magic != Mailbox::MAGIC
+            || mailbox_->version != Mailbox::VERSION)
+        {
+            std::cout << "command: no mailbox " << shm_name
+                      << " (is the visualizer running?)" << std::endl;
+            throw CommandError();
+        }
+        last_ack_seq_ = mailbox_->ack_seq.load(std::memory_order_acquire);
+    }
+    else
+    {
+        snprintf(client_path_, sizeof(client_path_),
+                 "/tmp/robotarm_client.%d.sock", int(getpid()));
+        sock_ = bind_dgram(client_path_);
+        if (sock_ < 0)
+        {
+            std::cout << "command: cannot bind " << client_path_ << std::endl;
+            throw CommandError();
+        }
+        make_addr(server_addr_, sock_path);
+    }
+}
+
+arm::CommandClient::~CommandClient()
+{
+    if (mailbox_ != NULL) munmap(mailbox_, sizeof(Mailbox));
+    if (sock_ >= 0)
+    {
+        close(sock_);
+        unlink(client_path_);
+    }
+}
+
+void arm::CommandClient::send(Command & cmd)
+{
+    cmd.id = next_id_++;
+    cmd.sent_ns = mygllib::now_ns();
+    if (transport_ == SHM)
+    {
+        seq_write(mailbox_->cmd_seq, mailbox_->cmd, cmd);
+    }
+    else
+    {
+        sendto(sock_, &cmd, sizeof(cmd), MSG_DONTWAIT,
+               (sockaddr *) &server_addr_, sizeof(server_addr_));
+    }
+}
+
+bool arm::CommandClient::latest_ack(Ack & ack)
+{
+    if (transport_ == SHM)
+    {
+        if (mailbox_->ack_seq.load(std::memory_order_acquire) == last_ack_seq_)
+            return false;
+        uint32_t s;
+        if (!seq_try_read(mailbox_->ack_seq, mailbox_->ack, ack, s))
+            return false;
+        last_ack_seq_ = s;
+        return true;
+    }
+
+    bool got = false;
+    Ack a;
+    while (recv(sock_, &a, sizeof(a), 0) == sizeof(a))
+    {
+        ack = a;
+        got = true;
+    }
+    return got;
+}
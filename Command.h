@@ -0,0 +1,163 @@
+// File  : Command.h
+// Author: Cole Schwandt
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <atomic>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace arm
+{
+    class CommandError
+    {};
+
+    const char * const CMD_SHM_NAME  = "/robotarm_cmd";
+    const char * const CMD_SOCK_PATH = "/tmp/robotarm_cmd.sock";
+
+    //-------------------------------------------------------------------------
+    // Command
+    //
+    // One joint/grip target from an external controller. Only the fields
+    // whose bit is set in mask are applied. Angles are in degrees, grip is
+    // 0=open ... 1=closed. id and sent_ns are filled in by CommandClient.
+    //-------------------------------------------------------------------------
+    struct Command
+    {
+        enum Field
+        {
+            SHOULDER_PITCH = 1 << 0,
+            SHOULDER_YAW   = 1 << 1,
+            SHOULDER_ROLL  = 1 << 2,
+            ELBOW_PITCH    = 1 << 3,
+            ELBOW_YAW      = 1 << 4,
+            ELBOW_ROLL     = 1 << 5,
+            GRIP           = 1 << 6,
+            ALL            = (1 << 7) - 1
+        };
+
+        uint64_t id;
+        int64_t  sent_ns;
+        uint32_t mask;
+        float    shoulder_pitch, shoulder_yaw, shoulder_roll;
+        float    elbow_pitch, elbow_yaw, elbow_roll;
+        float    grip;
+    };
+
+    //-------------------------------------------------------------------------
+    // Ack
+    //
+    // Sent back once the frame that first shows command id has been swapped.
+    //-------------------------------------------------------------------------
+    struct Ack
+    {
+        uint64_t id;
+        int64_t  sent_ns;
+        int64_t  frame_ns;
+        uint64_t frame;
+    };
+
+    //-------------------------------------------------------------------------
+    // Shared-memory mailbox. Each half is a single-writer seqlock holding the
+    // latest value only: the controller writes cmd, the visualizer writes
+    // ack. seq is odd while a write is in progress.
+    //-------------------------------------------------------------------------
+    struct Mailbox
+    {
+        static const uint32_t MAGIC   = 0x41524d43; // "ARMC"
+        static const uint32_t VERSION = 1;
+
+        uint32_t magic;
+        uint32_t version;
+
+        alignas(64) std::atomic< uint32_t > cmd_seq;
+        Command cmd;
+
+        alignas(64) std::atomic< uint32_t > ack_seq;
+        Ack ack;
+    };
+
+    //-------------------------------------------------------------------------
+    // CommandServer (visualizer side)
+    //
+    // Owns the mailbox and a non-blocking datagram socket. poll() never
+    // blocks or locks, so it can be called from the GLUT thread every tick.
+    //
+    // USAGE:
+    // arm::CommandServer server;
+    // arm::Command cmd;
+    // if (server.poll(cmd)) { ... apply cmd ... glutPostRedisplay(); }
+    // ...
+    // glutSwapBuffers();
+    // server.frame_presented(frame++);
+    //-------------------------------------------------------------------------
+    class CommandServer
+    {
+    public:
+        CommandServer(const char * shm_name=CMD_SHM_NAME,
+                      const char * sock_path=CMD_SOCK_PATH);
+        ~CommandServer();
+
+        bool poll(Command & cmd);
+        void frame_presented(uint64_t frame);
+
+    private:
+        CommandServer(const CommandServer &);
+        CommandServer & operator=(const CommandServer &);
+
+        bool poll_shm(Command & cmd);
+        bool poll_socket(Command & cmd);
+
+        const char * shm_name_;
+        const char * sock_path_;
+        Mailbox * mailbox_;
+        int sock_;
+        uint32_t last_seq_;
+
+        // command shown by the next swapped frame, if any
+        bool pending_;
+        bool pending_from_socket_;
+        Ack pending_ack_;
+        sockaddr_un pending_addr_;
+        socklen_t pending_addr_len_;
+    };
+
+    //-------------------------------------------------------------------------
+    // CommandClient (controller side)
+    //
+    // SHM writes straight into the visualizer's mailbox; SOCKET is the
+    // fallback for when shared memory is not available.
+    //-------------------------------------------------------------------------
+    class CommandClient
+    {
+    public:
+        enum Transport
+        {
+            SHM, SOCKET
+        };
+
+        CommandClient(Transport transport=SHM,
+                      const char * shm_name=CMD_SHM_NAME,
+                      const char * sock_path=CMD_SOCK_PATH);
+        ~CommandClient();
+
+        void send(Command & cmd);
+        bool latest_ack(Ack & ack);
+
+    private:
+        CommandClient(const CommandClient &);
+        CommandClient & operator=(const CommandClient &);
+
+        Transport transport_;
+        Mailbox * mailbox_;
+        int sock_;
+        sockaddr_un server_addr_;
+        char client_path_[sizeof(sockaddr_un::sun_path)];
+        uint64_t next_id_;
+        uint32_t last_ack_seq_;
+    };
+}
+
+#endif
@@ -0,0 +1,180 @@
+// File  : DepthCamera.cpp
+// Author: Cole Schwandt
+
+#define GL_GLEXT_PROTOTYPES
+#include <cstring>
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include "debug.h"
+#include "Clock.h"
+#include "DepthCamera.h"
+
+mygllib::DepthCamera::DepthCamera(int width, int height)
+    : w_(width), h_(height), fbo_(0), color_(0), depth_(0), next_(0),
+      oldest_(0), prev_fbo_(0), rendered_(0), published_(0), skipped_(0),
+      begin_ns_(0), znear_(0.0f), zfar_(0.0f)
+{
+    glGenFramebuffers(1, &fbo_);
+    glGenRenderbuffers(1, &color_);
+    glGenRenderbuffers(1, &depth_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w_, h_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w_, h_);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint fbo;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, color_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, depth_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    // color (RGBA8) then depth (float) per slot
+    const size_t bytes = size_t(w_) * h_ * (4 + sizeof(float));
+    for (int i = 0; i < SLOTS; ++i)
+    {
+        Slot & s = slots_[i];
+        glGenBuffers(1, &s.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+        s.fence = 0;
+        s.seq = 0;
+        s.render_ns = 0;
+        s.znear = s.zfar = 0.0f;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        DepthFrame & f = frames_.buffer(i);
+        f.width = w_;
+        f.height = h_;
+        f.seq = 0;
+        f.render_ns = 0;
+        f.znear = f.zfar = 0.0f;
+        f.rgba.assign(size_t(w_) * h_ * 4, 0);
+        f.depth.assign(size_t(w_) * h_, 0.0f);
+    }
+}
+
+mygllib::DepthCamera::~DepthCamera()
+{
+    for (int i = 0; i < SLOTS; ++i)
+    {
+        if (slots_[i].fence) glDeleteSync(slots_[i].fence);
+        glDeleteBuffers(1, &slots_[i].pbo);
+    }
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_);
+}
+
+bool mygllib::DepthCamera::begin(const View & view)
+{
+    if (slots_[next_].fence)            // every readback still in flight
+    {
+        ++skipped_;
+        return false;
+    }
+    begin_ns_ = now_ns();
+    znear_ = view.zNear();
+    zfar_ = view.zFar();
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_fbo_);
+    glGetIntegerv(GL_VIEWPORT, prev_viewport_);
+    GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, fbo_));
+    glViewport(0, 0, w_, h_);
+
+    // the view as this camera's aspect sees it
+    View lens = view;
+    lens.aspect() = float(w_) / h_;
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    lens.set_projection();
+    glMatrixMode(GL_MODELVIEW);
+    return true;
+}
+
+void mygllib::DepthCamera::end()
+{
+    Slot & s = slots_[next_];
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+    GL_CALL(glReadPixels(0, 0, w_, h_, GL_RGBA, GL_UNSIGNED_BYTE, 0));
+    GL_CALL(glReadPixels(0, 0, w_, h_, GL_DEPTH_COMPONENT, GL_FLOAT,
+                         (void *) (size_t(w_) * h_ * 4)));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.seq = ++rendered_;
+    s.render_ns = begin_ns_;
+    s.znear = znear_;
+    s.zfar = zfar_;
+    next_ = (next_ + 1) % SLOTS;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prev_fbo_);
+    glViewport(prev_viewport_[0], prev_viewport_[1], prev_viewport_[2],
+               prev_viewport_[3]);
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+int mygllib::DepthCamera::poll()
+{
+    // readbacks finish in order: stop at the first that has not
+    int n = 0;
+    while (slots_[oldest_].fence)
+    {
+        Slot & s = slots_[oldest_];
+        const GLenum r = glClientWaitSync(s.fence, 0, 0);
+        if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) break;
+        glDeleteSync(s.fence);
+        s.fence = 0;
+        publish(s);
+        oldest_ = (oldest_ + 1) % SLOTS;
+        ++n;
+    }
+    return n;
+}
+
+// GL rows run bottom-up; depth buffer values go back to eye distance
+void mygllib::DepthCamera::publish(Slot & slot)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const void * p;
+    GL_CALL(p = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if (p == NULL)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return;
+    }
+
+    DepthFrame & f = frames_.back();
+    f.seq = slot.seq;
+    f.render_ns = slot.render_ns;
+    f.znear = slot.znear;
+    f.zfar = slot.zfar;
+
+    const uint8_t * rgba = (const uint8_t *) p;
+    const float * depth = (const float *) (rgba + size_t(w_) * h_ * 4);
+    const float n = slot.znear, fa = slot.zfar;
+    for (int y = 0; y < h_; ++y)
+    {
+        const size_t src = size_t(h_ - 1 - y) * w_, dst = size_t(y) * w_;
+        memcpy(&f.rgba[dst * 4], rgba + src * 4, size_t(w_) * 4);
+        for (int x = 0; x < w_; ++x)
+        {
+            const float z = 2.0f * depth[src + x] - 1.0f;
+            f.depth[dst + x] = 2.0f * n * fa / (fa + n - z * (fa - n));
+        }
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    frames_.publish();
+    ++published_;
+}
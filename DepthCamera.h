@@ -0,0 +1,121 @@
+// File  : DepthCamera.h
+// Author: Cole Schwandt
+
+#ifndef DEPTHCAMERA_H
+#define DEPTHCAMERA_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/freeglut.h>
+#include "TripleBuffer.h"
+#include "View.h"
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // DepthFrame
+    //
+    // One image of a DepthCamera: color and linear depth (distance along
+    // the view direction, in scene units; zFar where nothing was drawn),
+    // both width x height with the top row first.
+    //-------------------------------------------------------------------------
+    struct DepthFrame
+    {
+        int width, height;
+        uint64_t seq;                   // 1, 2, ... in rendering order
+        int64_t render_ns;              // now_ns() when it was drawn
+        float znear, zfar;
+        std::vector< uint8_t > rgba;    // 4 bytes per pixel
+        std::vector< float > depth;
+
+        float depth_at(int x, int y) const { return depth[y * width + x]; }
+    };
+
+    //-------------------------------------------------------------------------
+    // DepthCamera
+    //
+    // A virtual camera drawn offscreen at its own resolution, for sensors
+    // (a wrist camera) that should not cost the window anything. begin()
+    // binds a width x height color + depth framebuffer object and sets the
+    // viewport and the view's projection for it; the caller draws the
+    // scene with that view; end() starts reading both buffers back into a
+    // pixel buffer object and puts the previous framebuffer, viewport and
+    // projection back. Nothing waits for the GPU: poll() picks up the
+    // readbacks that have finished (a fence each), turns depth buffer
+    // values into linear depth and publishes the frame.
+    //
+    // Three readbacks can be in flight. If all are, begin() returns false
+    // and the frame is skipped (counted by skipped()) rather than stall.
+    //
+    // Consumers read frames() from one thread: acquire(), then front() is
+    // the newest frame and stays put until the next acquire(). The
+    // context must be current in every other call, including the
+    // destructor.
+    //
+    // USAGE:
+    // mygllib::DepthCamera camera(320, 240);
+    // void every_30th_of_a_second()
+    // {
+    //     camera.poll();
+    //     if (camera.begin(view))
+    //     {
+    //         ... draw the scene from view ...
+    //         camera.end();
+    //     }
+    // }
+    //
+    // if (camera.frames().acquire()) use(camera.frames().front());
+    //-------------------------------------------------------------------------
+    class DepthCamera
+    {
+    public:
+        DepthCamera(int width, int height);
+        ~DepthCamera();
+
+        bool begin(const View & view);
+        void end();
+        int poll();                     // frames published
+
+        int width() const  { return w_; }
+        int height() const { return h_; }
+
+        TripleBuffer< DepthFrame > & frames() { return frames_; }
+
+        uint64_t rendered() const  { return rendered_; }
+        uint64_t published() const { return published_; }
+        uint64_t skipped() const   { return skipped_; }
+
+    private:
+        DepthCamera(const DepthCamera &);
+        DepthCamera & operator=(const DepthCamera &);
+
+        static const int SLOTS = 3;
+
+        struct Slot
+        {
+            GLuint pbo;                 // color, then depth
+            GLsync fence;               // 0 while free
+            uint64_t seq;
+            int64_t render_ns;
+            float znear, zfar;
+        };
+
+        void publish(Slot & slot);
+
+        int w_, h_;
+        GLuint fbo_, color_, depth_;
+        Slot slots_[SLOTS];
+        int next_;                      // slot end() fills next
+        int oldest_;                    // slot poll() waits on next
+
+        // state begin() replaced
+        GLint prev_fbo_, prev_viewport_[4];
+
+        uint64_t rendered_, published_, skipped_;
+        int64_t begin_ns_;
+        float znear_, zfar_;
+        TripleBuffer< DepthFrame > frames_;
+    };
+}
+
+#endif
@@ -0,0 +1,275 @@
+// File  : Dynamics.cpp
+// Author: Cole Schwandt
+
+#include <cmath>
+#include "Dynamics.h"
+
+namespace
+{
+    using arm::Vec3;
+
+    //==============================================================
+    // Mass properties
+    //==============================================================
+    // A solid primitive with its principal axes along the link frame's.
+    struct Part
+    {
+        float m;
+        Vec3  c;
+        float xx, yy, zz;
+    };
+
+    Part sphere(float r, const Vec3 & c, float density)
+    {
+        r *= cfg::UNIT_M;
+        const float m = density * (4.0f / 3.0f) * mygllib::PI * r * r * r;
+        const float i = 0.4f * m * r * r;
+        Part p = { m, c * cfg::UNIT_M, i, i, i };
+        return p;
+    }
+
+    // axis along Y (links and phalanges are drawn rotated Z->Y)
+    Part cylinder(float r, float h, const Vec3 & c, float density)
+    {
+        r *= cfg::UNIT_M;
+        h *= cfg::UNIT_M;
+        const float m = density * mygllib::PI * r * r * h;
+        const float side = m * (3.0f * r * r + h * h) / 12.0f;
+        Part p = { m, c * cfg::UNIT_M, side, 0.5f * m * r * r, side };
+        return p;
+    }
+
+    Part cube(float s, const Vec3 & c, float density)
+    {
+        s *= cfg::UNIT_M;
+        const float m = density * s * s * s;
+        const float i = m * s * s / 6.0f;
+        Part p = { m, c * cfg::UNIT_M, i, i, i };
+        return p;
+    }
+
+    Part point(float m, const Vec3 & c)
+    {
+        Part p = { m, c * cfg::UNIT_M, 0.0f, 0.0f, 0.0f };
+        return p;
+    }
+
+    // Parallel-axis sum of the parts about their common center of mass.
+    arm::LinkInertia combine(const Part * parts, int n)
+    {
+        arm::LinkInertia l = { 0.0f, Vec3(), 0, 0, 0, 0, 0, 0 };
+        for (int k = 0; k < n; ++k)
+        {
+            l.m += parts[k].m;
+            l.c += parts[k].c * parts[k].m;
+        }
+        l.c = l.c * (1.0f / l.m);
+
+        for (int k = 0; k < n; ++k)
+        {
+            const Part & p = parts[k];
+            const Vec3 d = p.c - l.c;
+            l.xx += p.xx + p.m * (d.y * d.y + d.z * d.z);
+            l.yy += p.yy + p.m * (d.x * d.x + d.z * d.z);
+            l.zz += p.zz + p.m * (d.x * d.x + d.y * d.y);
+            l.xy -= p.m * d.x * d.y;
+            l.xz -= p.m * d.x * d.z;
+            l.yz -= p.m * d.y * d.z;
+        }
+        return l;
+    }
+
+    //==============================================================
+    // Rotations about one coordinate axis
+    //==============================================================
+    // R v, R = glRotatef(q, axis)
+    inline Vec3 rot(int axis, float c, float s, const Vec3 & v)
+    {
+        switch (axis)
+        {
+            case 0:  return Vec3(v.x, c * v.y - s * v.z, s * v.y + c * v.z);
+            case 1:  return Vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+            default: return Vec3(c * v.x - s * v.y, s * v.x + c * v.y, v.z);
+        }
+    }
+
+    // R^T v: parent frame -> joint frame
+    inline Vec3 rot_t(int axis, float c, float s, const Vec3 & v)
+    {
+        switch (axis)
+        {
+            case 0:  return Vec3(v.x, c * v.y + s * v.z, -s * v.y + c * v.z);
+            case 1:  return Vec3(c * v.x - s * v.z, v.y, s * v.x + c * v.z);
+            default: return Vec3(c * v.x + s * v.y, -s * v.x + c * v.y, v.z);
+        }
+    }
+
+    inline Vec3 unit(int axis, float s)
+    {
+        return Vec3(axis == 0 ? s : 0.0f, axis == 1 ? s : 0.0f,
+                    axis == 2 ? s : 0.0f);
+    }
+
+    inline float component(int axis, const Vec3 & v)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    inline Vec3 inertia_times(const arm::LinkInertia & l, const Vec3 & v)
+    {
+        return Vec3(l.xx * v.x + l.xy * v.y + l.xz * v.z,
+                    l.xy * v.x + l.yy * v.y + l.yz * v.z,
+                    l.xz * v.x + l.yz * v.y + l.zz * v.z);
+    }
+}
+
+arm::ArmModel arm::arm_model(float density)
+{
+    const float link_y = cfg::JOINT_R + cfg::LINK_GAP();   // joint to link
+    const float elbow_y = link_y + cfg::ARM_L - cfg::LINK_GAP();
+    const float palm_y = link_y + cfg::ARM_L + 0.5f * cfg::PALM_SIZE;
+
+    ArmModel model;
+    const LinkInertia massless = { 0.0f, Vec3(), 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < NUM_JOINTS; ++i)
+    {
+        model.axis[i] = i % 3;
+        model.offset[i] = Vec3();
+        model.link[i] = massless;
+    }
+    model.offset[3] = Vec3(0.0f, elbow_y * cfg::UNIT_M, 0.0f);
+
+    // shoulder sphere and upper arm, carried by the shoulder roll joint
+    const Part upper[] =
+    {
+        sphere(cfg::JOINT_R, Vec3(), density),
+        cylinder(cfg::ARM_R, cfg::ARM_L,
+                 Vec3(0.0f, link_y + 0.5f * cfg::ARM_L, 0.0f), density),
+    };
+    model.link[2] = combine(upper, 2);
+
+    // elbow sphere, forearm, palm and fingers, carried by the elbow roll
+    const Part finger = sphere(cfg::FINGER_JOINT_R, Vec3(), density);
+    const Part digit = cylinder(cfg::FINGER_DIGIT_R, cfg::FINGER_DIGIT_L,
+                                Vec3(), density);
+    const float finger_m = finger.m + 2.0f * digit.m;
+    Part fore[3 + NUM_FINGERS] =
+    {
+        sphere(cfg::JOINT_R, Vec3(), density),
+        cylinder(cfg::ARM_R, cfg::ARM_L,
+                 Vec3(0.0f, link_y + 0.5f * cfg::ARM_L, 0.0f), density),
+        cube(cfg::PALM_SIZE, Vec3(0.0f, palm_y, 0.0f), density),
+    };
+    for (int i = 0; i < NUM_FINGERS; ++i)
+        fore[3 + i] = point(finger_m, Vec3(0.0f, palm_y, 0.0f) + finger_mount(i));
+    model.link[5] = combine(fore, 3 + NUM_FINGERS);
+
+    const Part base = cube(cfg::BASE_SIZE, Vec3(), density);
+    model.base_mass = base.m * cfg::BASE_SX * cfg::BASE_SY * cfg::BASE_SZ;
+    return model;
+}
+
+void arm::inverse_dynamics(const ArmModel & model,
+                           const float q[NUM_JOINTS],
+                           const float qd[NUM_JOINTS],
+                           const float qdd[NUM_JOINTS],
+                           float tau[NUM_JOINTS])
+{
+    float c[NUM_JOINTS], s[NUM_JOINTS];
+    Vec3 force[NUM_JOINTS], moment[NUM_JOINTS];
+
+    // outward: angular velocity/acceleration and linear acceleration of
+    // each joint frame, in that frame. Gravity enters as an upward
+    // acceleration of the fixed base.
+    Vec3 w, dw, a(0.0f, cfg::GRAVITY, 0.0f);
+    for (int i = 0; i < NUM_JOINTS; ++i)
+    {
+        const int ax = model.axis[i];
+        const Vec3 & p = model.offset[i];
+        c[i] = std::cos(q[i]);
+        s[i] = std::sin(q[i]);
+
+        const Vec3 ap = a + cross(dw, p) + cross(w, cross(w, p));
+        const Vec3 wp = rot_t(ax, c[i], s[i], w);
+        const Vec3 spin = unit(ax, qd[i]);
+        w  = wp + spin;
+        dw = rot_t(ax, c[i], s[i], dw) + unit(ax, qdd[i]) + cross(wp, spin);
+        a  = rot_t(ax, c[i], s[i], ap);
+
+        const LinkInertia & l = model.link[i];
+        if (l.m > 0.0f)
+        {
+            const Vec3 ac = a + cross(dw, l.c) + cross(w, cross(w, l.c));
+            force[i]  = ac * l.m;
+            moment[i] = inertia_times(l, dw) + cross(w, inertia_times(l, w));
+        }
+        else
+        {
+            force[i] = moment[i] = Vec3();
+        }
+    }
+
+    // inward: force and moment each link's joint transmits
+    Vec3 f, n;
+    for (int i = NUM_JOINTS - 1; i >= 0; --i)
+    {
+        const LinkInertia & l = model.link[i];
+        Vec3 fc, nc, pc;
+        if (i + 1 < NUM_JOINTS)
+        {
+            const int ax = model.axis[i + 1];
+            fc = rot(ax, c[i + 1], s[i + 1], f);
+            nc = rot(ax, c[i + 1], s[i + 1], n);
+            pc = model.offset[i + 1];
+        }
+        n = moment[i] + nc + cross(l.c, force[i]) + cross(pc, fc);
+        f = force[i] + fc;
+        tau[i] = component(model.axis[i], n);
+    }
+}
+
+void arm::inverse_dynamics(const ArmModel & model,
+                           const float * q, const float * qd, const float * qdd,
+                           float * tau, size_t n)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        const size_t o = k * NUM_JOINTS;
+        inverse_dynamics(model, q + o, qd + o, qdd + o, tau + o);
+    }
+}
+
+void arm::gravity_torques(const ArmModel & model, const float q[NUM_JOINTS],
+                          float tau[NUM_JOINTS])
+{
+    const float zero[NUM_JOINTS] = { 0 };
+    inverse_dynamics(model, q, zero, zero, tau);
+}
+
+arm::TorqueMonitor::TorqueMonitor(const ArmModel & model, float smoothing)
+    : model_(model), smoothing_(smoothing), first_(true)
+{
+    for (int i = 0; i < NUM_JOINTS; ++i)
+        q_[i] = qd_[i] = qdd_[i] = tau_[i] = gravity_[i] = 0.0f;
+}
+
+void arm::TorqueMonitor::update(const Pose & pose, float dt)
+{
+    float q[NUM_JOINTS];
+    joint_angles(pose, q);
+    if (!first_ && dt > 0.0f)
+    {
+        for (int i = 0; i < NUM_JOINTS; ++i)
+        {
+            const float qd = qd_[i] + smoothing_ * ((q[i] - q_[i]) / dt - qd_[i]);
+            const float qdd = (qd - qd_[i]) / dt;
+            qdd_[i] += smoothing_ * (qdd - qdd_[i]);
+            qd_[i] = qd;
+        }
+    }
+    first_ = false;
+    for (int i = 0; i < NUM_JOINTS; ++i) q_[i] = q[i];
+
+    inverse_dynamics(model_, q_, qd_, qdd_, tau_);
+    gravity_torques(model_, q_, gravity_);
+}
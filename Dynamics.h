@@ -0,0 +1,117 @@
+// File  : Dynamics.h
+// Author: Cole Schwandt
+
+#ifndef DYNAMICS_H
+#define DYNAMICS_H
+
+#include <cstddef>
+#include "Kinematics.h"
+
+namespace cfg
+{
+    // -------- dynamics --------
+    const GLfloat UNIT_M  = 0.1f;       // one scene unit is 10 cm
+    const GLfloat DENSITY = 2700.0f;    // kg/m^3, solid aluminium
+    const GLfloat GRAVITY = 9.81f;      // m/s^2, along -Y
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // LinkInertia
+    //
+    // Mass (kg), center of mass and inertia tensor about the center of mass
+    // (kg m^2), both in the link's joint frame, in meters.
+    //-------------------------------------------------------------------------
+    struct LinkInertia
+    {
+        float m;
+        Vec3  c;
+        float xx, yy, zz, xy, xz, yz;
+    };
+
+    //-------------------------------------------------------------------------
+    // ArmModel
+    //
+    // The arm as a serial chain of six revolute joints, one per Euler
+    // rotation. Joint i turns about axis[i] (0 = X, 1 = Y, 2 = Z) of its
+    // own frame, whose origin sits at offset[i] (m) in the previous joint's
+    // frame. The three joints of the shoulder (and of the elbow) share an
+    // origin; the links between them are massless.
+    //-------------------------------------------------------------------------
+    struct ArmModel
+    {
+        int         axis[NUM_JOINTS];
+        Vec3        offset[NUM_JOINTS];
+        LinkInertia link[NUM_JOINTS];
+        float       base_mass;             // static, for reference only
+    };
+
+    // Masses and inertias from the drawn geometry (solid spheres, cylinders
+    // and cubes) at a uniform density. The fingers are lumped into point
+    // masses at their mounts on the palm.
+    ArmModel arm_model(float density=cfg::DENSITY);
+
+    //-------------------------------------------------------------------------
+    // inverse_dynamics
+    //
+    // Recursive Newton-Euler: joint torques (N m) needed to follow joint
+    // positions q (rad), velocities qd (rad/s) and accelerations qdd
+    // (rad/s^2) against gravity. One outward pass for link velocities and
+    // accelerations, one inward pass for forces; O(NUM_JOINTS), no
+    // allocation.
+    //
+    // The batched form runs n samples stored back to back (sample k's
+    // joints at [k * NUM_JOINTS, (k + 1) * NUM_JOINTS)), e.g. a whole
+    // trajectory.
+    //
+    // USAGE:
+    // const arm::ArmModel model = arm::arm_model();
+    // arm::inverse_dynamics(model, &q[0], &qd[0], &qdd[0], &tau[0], n);
+    //-------------------------------------------------------------------------
+    void inverse_dynamics(const ArmModel & model,
+                          const float q[NUM_JOINTS],
+                          const float qd[NUM_JOINTS],
+                          const float qdd[NUM_JOINTS],
+                          float tau[NUM_JOINTS]);
+
+    void inverse_dynamics(const ArmModel & model,
+                          const float * q, const float * qd, const float * qdd,
+                          float * tau, size_t n);
+
+    // Holding torques: inverse_dynamics() at rest.
+    void gravity_torques(const ArmModel & model, const float q[NUM_JOINTS],
+                         float tau[NUM_JOINTS]);
+
+    //-------------------------------------------------------------------------
+    // TorqueMonitor
+    //
+    // Live torque estimate for the visualizer. Joint velocities and
+    // accelerations are finite differences of successive poses, low-pass
+    // filtered so keyboard steps do not read as infinite accelerations.
+    //
+    // USAGE:
+    // arm::TorqueMonitor monitor(model);
+    // every tick: monitor.update(current_pose(), dt_seconds);
+    // monitor.torque()[i], monitor.gravity()[i]
+    //-------------------------------------------------------------------------
+    class TorqueMonitor
+    {
+    public:
+        TorqueMonitor(const ArmModel & model, float smoothing=0.05f);
+
+        void update(const Pose & pose, float dt);
+
+        const float * torque() const  { return tau_; }
+        const float * gravity() const { return gravity_; }
+
+    private:
+        const ArmModel & model_;
+        float smoothing_;
+        bool first_;
+        float q_[NUM_JOINTS], qd_[NUM_JOINTS], qdd_[NUM_JOINTS];
+        float tau_[NUM_JOINTS], gravity_[NUM_JOINTS];
+    };
+}
+
+#endif
@@ -0,0 +1,268 @@
+// File  : Export.cpp
+// Author: Cole Schwandt
+
+#include <cstring>
+#include <sys/stat.h>
+#include "Clock.h"
+#include "Export.h"
+
+namespace
+{
+    // big enough that a pose is a handful of write() calls
+    const size_t BUFFER_BYTES = 1 << 20;
+    const size_t STL_HEADER = 80 + 4;
+    const size_t STL_TRIANGLE = 12 * 4 + 2;
+    const size_t PLY_VERTEX = 6 * 4;            // x y z nx ny nz
+    const size_t PLY_FACE = 1 + 3 * 4;          // count, three indices
+
+    // Transpose of the inverse of m's 3x3 part, up to the factor 1/det:
+    // what normals are multiplied by (the base is scaled unevenly).
+    arm::Mat4 cofactor(const arm::Mat4 & m)
+    {
+        arm::Mat4 c = arm::Mat4::identity();
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const int r1 = (r + 1) % 3, r2 = (r + 2) % 3;
+                const int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+                c(r, k) = m(r1, k1) * m(r2, k2) - m(r1, k2) * m(r2, k1);
+            }
+        }
+        return c;
+    }
+}
+
+arm::MeshExporter::MeshExporter(const ArmMeshes & meshes, Format format)
+    : meshes_(meshes), format_(format), triangles_(0), fp_(NULL),
+      buffer_(BUFFER_BYTES), used_(0)
+{
+    Part part[MAX_PARTS];
+    const int n = parts(Pose(), NULL, part);
+    for (int i = 0; i < n; ++i) triangles_ += part[i].mesh->triangle_count();
+
+    if (format_ == PLY)
+    {
+        char counts[128];
+        snprintf(counts, sizeof(counts),
+                 "element vertex %zu\n", 3 * triangles_);
+        ply_header_ = std::string("ply\n"
+                                  "format binary_little_endian 1.0\n"
+                                  "comment rotating robotic arm\n")
+                    + counts
+                    + "property float x\n"
+                      "property float y\n"
+                      "property float z\n"
+                      "property float nx\n"
+                      "property float ny\n"
+                      "property float nz\n";
+        snprintf(counts, sizeof(counts), "element face %zu\n", triangles_);
+        ply_header_ += std::string(counts)
+                     + "property list uchar int vertex_indices\n"
+                       "end_header\n";
+
+        // vertices are never shared: face t is 3t, 3t+1, 3t+2
+        ply_faces_.resize(triangles_ * PLY_FACE);
+        char * f = &ply_faces_[0];
+        for (size_t t = 0; t < triangles_; ++t, f += PLY_FACE)
+        {
+            const int32_t v[3] = { int32_t(3 * t), int32_t(3 * t + 1),
+                                   int32_t(3 * t + 2) };
+            f[0] = 3;
+            memcpy(f + 1, v, sizeof(v));
+        }
+    }
+}
+
+size_t arm::MeshExporter::bytes_per_pose() const
+{
+    if (format_ == STL) return STL_HEADER + triangles_ * STL_TRIANGLE;
+    return ply_header_.size() + 3 * triangles_ * PLY_VERTEX + ply_faces_.size();
+}
+
+int arm::MeshExporter::parts(const Pose & pose, const FingerAngles * fingers,
+                             Part part[MAX_PARTS]) const
+{
+    Frames f;
+    forward_kinematics(pose, f, fingers);
+    const Mat4 z_to_y = Mat4::rotate(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
+
+    // same order and transforms as draw_scene()/draw_arm()/draw_finger()
+    int n = 0;
+    part[n].mesh = &meshes_.base;
+    part[n++].m = Mat4::translate(pose.xb, pose.yb, pose.zb)
+                * Mat4::scale(cfg::BASE_SX, cfg::BASE_SY, cfg::BASE_SZ);
+    part[n].mesh = &meshes_.joint;
+    part[n++].m = f.shoulder;
+    part[n].mesh = &meshes_.link;
+    part[n++].m = f.upper_arm * z_to_y;
+    part[n].mesh = &meshes_.joint;
+    part[n++].m = f.elbow;
+    part[n].mesh = &meshes_.link;
+    part[n++].m = f.forearm * z_to_y;
+    part[n].mesh = &meshes_.palm;
+    part[n++].m = f.palm;
+
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        const Vec3 p = finger_mount(i);
+        part[n].mesh = &meshes_.finger_joint;
+        part[n++].m = f.palm * Mat4::translate(p.x, p.y, p.z);
+        part[n].mesh = &meshes_.digit;
+        part[n++].m = f.knuckle[i] * z_to_y;
+        part[n].mesh = &meshes_.finger_joint;
+        part[n++].m = f.middle[i];
+        part[n].mesh = &meshes_.digit;
+        part[n++].m = f.distal[i];
+    }
+    return n;
+}
+
+void arm::MeshExporter::put(const void * p, size_t n)
+{
+    if (used_ + n > buffer_.size())
+    {
+        flush();
+        if (n > buffer_.size())
+        {
+            emit(p, n);
+            return;
+        }
+    }
+    memcpy(&buffer_[used_], p, n);
+    used_ += n;
+}
+
+void arm::MeshExporter::flush()
+{
+    const size_t n = used_;
+    used_ = 0;
+    emit(&buffer_[0], n);
+}
+
+void arm::MeshExporter::emit(const void * p, size_t n)
+{
+    if (n > 0 && fwrite(p, 1, n, fp_) != n)
+    {
+        fclose(fp_);
+        fp_ = NULL;
+        std::cout << "export: write failed" << std::endl;
+        throw ExportError();
+    }
+}
+
+void arm::MeshExporter::write(const std::string & path, const Pose & pose,
+                              const FingerAngles * fingers)
+{
+    Part part[MAX_PARTS];
+    const int n = parts(pose, fingers, part);
+
+    fp_ = fopen(path.c_str(), "wb");
+    if (fp_ == NULL)
+    {
+        std::cout << "export: cannot write " << path << std::endl;
+        throw ExportError();
+    }
+
+    if (format_ == STL)
+    {
+        char header[80] = "binary STL, rotating robotic arm";
+        const uint32_t count = uint32_t(triangles_);
+        put(header, sizeof(header));
+        put(&count, sizeof(count));
+
+        const uint16_t attribute = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const Mat4 & m = part[i].m;
+            const GLfloat * v = part[i].mesh->vertices();
+            const size_t t_end = part[i].mesh->triangle_count();
+            for (size_t t = 0; t < t_end; ++t, v += 9)
+            {
+                const Vec3 a = m.point(Vec3(v[0], v[1], v[2]));
+                const Vec3 b = m.point(Vec3(v[3], v[4], v[5]));
+                const Vec3 c = m.point(Vec3(v[6], v[7], v[8]));
+                const Vec3 nrm = normalize(cross(b - a, c - a));
+                const float rec[12] =
+                {
+                    nrm.x, nrm.y, nrm.z, a.x, a.y, a.z,
+                    b.x, b.y, b.z, c.x, c.y, c.z,
+                };
+                put(rec, sizeof(rec));
+                put(&attribute, sizeof(attribute));
+            }
+        }
+    }
+    else
+    {
+        put(ply_header_.data(), ply_header_.size());
+        for (int i = 0; i < n; ++i)
+        {
+            const Mat4 & m = part[i].m;
+            const Mat4 nm = cofactor(m);
+            const GLfloat * v = part[i].mesh->vertices();
+            const GLfloat * vn = part[i].mesh->normals();
+            const size_t v_end = part[i].mesh->vertex_count();
+            for (size_t k = 0; k < v_end; ++k, v += 3, vn += 3)
+            {
+                const Vec3 p = m.point(Vec3(v[0], v[1], v[2]));
+                const Vec3 q = normalize(nm.vector(Vec3(vn[0], vn[1], vn[2])));
+                const float rec[6] = { p.x, p.y, p.z, q.x, q.y, q.z };
+                put(rec, sizeof(rec));
+            }
+        }
+        put(&ply_faces_[0], ply_faces_.size());
+    }
+
+    flush();
+    if (fclose(fp_) != 0)
+    {
+        fp_ = NULL;
+        std::cout << "export: write failed" << std::endl;
+        throw ExportError();
+    }
+    fp_ = NULL;
+}
+
+bool arm::parse_format(const char * name, MeshExporter::Format & format)
+{
+    if (strcmp(name, "stl") == 0)      format = MeshExporter::STL;
+    else if (strcmp(name, "ply") == 0) format = MeshExporter::PLY;
+    else return false;
+    return true;
+}
+
+arm::ExportStats arm::export_poses(const std::vector< Pose > & poses,
+                                   const std::string & out_dir,
+                                   MeshExporter::Format format,
+                                   const ArmMeshes & meshes)
+{
+    mkdir(out_dir.c_str(), 0755);
+    MeshExporter out(meshes, format);
+
+    ExportStats stats;
+    stats.poses = 0;
+    stats.triangles = out.triangle_count();
+    stats.bytes = 0;
+
+    const int64_t start = mygllib::now_ns();
+    char name[32];
+    for (size_t i = 0; i < poses.size(); ++i)
+    {
+        snprintf(name, sizeof(name), "pose_%06zu.%s", i, out.extension());
+        out.write(out_dir + '/' + name, poses[i]);
+        ++stats.poses;
+        stats.bytes += out.bytes_per_pose();
+    }
+    stats.wall_ns = mygllib::now_ns() - start;
+    return stats;
+}
+
+void arm::report(const ExportStats & stats, std::ostream & out)
+{
+    const double secs = stats.wall_ns / 1e9;
+    out << "export: " << stats.poses << " poses (" << stats.triangles
+        << " triangles each) in " << secs << " s (" << stats.poses / secs
+        << " poses/s, " << stats.bytes / secs / (1 << 20) << " MB/s)"
+        << std::endl;
+}
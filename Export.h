@@ -0,0 +1,111 @@
+// File  : Export.h
+// Author: Cole Schwandt
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Scene.h"
+
+namespace arm
+{
+    class ExportError
+    {};
+
+    //-------------------------------------------------------------------------
+    // MeshExporter
+    //
+    // Writes the posed arm (base, joints, links, palm and fingers, placed
+    // exactly as draw_scene() draws them) as one binary STL or PLY file
+    // per pose. Every part is one of the shared ArmMeshes transformed by
+    // its joint matrix from forward_kinematics(); triangles go straight
+    // from the shared mesh through the matrix into a fixed write buffer,
+    // so no posed copy of the mesh is ever built.
+    //
+    // STL: 80-byte header, triangle count, then per triangle the facet
+    // normal, three vertices and a zero attribute word.
+    // PLY (binary_little_endian): one vertex (position, normal) per
+    // triangle corner, then the faces. The face block is the same for
+    // every pose and is built once.
+    //
+    // Every pose has the same number of triangles, so headers are written
+    // up front and the file size is known (bytes_per_pose()). Output is
+    // little-endian, as on the machines this runs on.
+    //
+    // USAGE:
+    // arm::MeshExporter out(meshes, arm::MeshExporter::STL);
+    // out.write("pose.stl", pose);
+    //-------------------------------------------------------------------------
+    class MeshExporter
+    {
+    public:
+        enum Format { STL, PLY };
+
+        MeshExporter(const ArmMeshes & meshes, Format format);
+
+        void write(const std::string & path, const Pose & pose,
+                   const FingerAngles * fingers=NULL);
+
+        Format format() const           { return format_; }
+        const char * extension() const  { return format_ == STL ? "stl" : "ply"; }
+        size_t triangle_count() const   { return triangles_; }
+        size_t bytes_per_pose() const;
+
+    private:
+        MeshExporter(const MeshExporter &);
+        MeshExporter & operator=(const MeshExporter &);
+
+        // one primitive placed in the world
+        struct Part
+        {
+            const mygllib::Mesh * mesh;
+            Mat4 m;
+        };
+        static const int MAX_PARTS = 6 + 4 * NUM_FINGERS;
+
+        int parts(const Pose & pose, const FingerAngles * fingers,
+                  Part part[MAX_PARTS]) const;
+        void put(const void * p, size_t n);
+        void flush();
+        void emit(const void * p, size_t n);
+
+        const ArmMeshes & meshes_;
+        Format format_;
+        size_t triangles_;
+        std::string ply_header_;
+        std::vector< char > ply_faces_;
+
+        FILE * fp_;
+        std::vector< char > buffer_;
+        size_t used_;
+    };
+
+    // "stl" or "ply"
+    bool parse_format(const char * name, MeshExporter::Format & format);
+
+    struct ExportStats
+    {
+        size_t poses;
+        size_t triangles;               // per pose
+        uint64_t bytes;
+        int64_t wall_ns;
+    };
+
+    //-------------------------------------------------------------------------
+    // export_poses
+    //
+    // Writes <out_dir>/pose_NNNNNN.<stl|ply> for every pose, in order.
+    //-------------------------------------------------------------------------
+    ExportStats export_poses(const std::vector< Pose > & poses,
+                             const std::string & out_dir,
+                             MeshExporter::Format format,
+                             const ArmMeshes & meshes);
+
+    void report(const ExportStats & stats, std::ostream & out);
+}
+
+#endif
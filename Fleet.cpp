@@ -0,0 +1,233 @@
+// File  : Fleet.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "Clock.h"
+#include "Collision.h"
+#include "Fleet.h"
+
+namespace
+{
+    // The cycle every arm works through, in order (degrees; grip 0..1):
+    // reach out, close on a part, lift it while turning, set it down.
+    // The shoulder stays below about 30 degrees of tilt, where the upper
+    // arm would reach into the base.
+    const arm::Pose CYCLE[] =
+    {
+        { 25.0f,  0.0f, 0.0f, 60.0f,  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 25.0f,  0.0f, 0.0f, 85.0f,  0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+        {  5.0f, 45.0f, 0.0f, 40.0f, 10.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+        { 20.0f, 90.0f, 0.0f, 70.0f,  0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+    };
+    const int CYCLE_KEYS = sizeof(CYCLE) / sizeof(CYCLE[0]);
+
+    // additive layers at amount 1: heading (amount -1..1 per arm) and
+    // wobble (a triangle wave, amplitude 0..1 per arm)
+    const arm::Pose HEADING =
+        { 0.0f, 90.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    const arm::Pose WOBBLE =
+        { 3.0f, 0.0f, 3.0f, 6.0f, 8.0f, 6.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    const GLfloat MIN_KEY_RATE = 0.25f;     // keyframes per second
+    const GLfloat MAX_KEY_RATE = 1.0f;
+    const GLfloat MIN_WOBBLE_RATE = 0.5f;   // Hz
+    const GLfloat MAX_WOBBLE_RATE = 2.0f;
+}
+
+arm::Pose arm::FleetState::pose(size_t k) const
+{
+    Pose p = poses.pose(k);
+    p.xb += x[k];
+    p.zb += z[k];
+    return p;
+}
+
+void arm::fleet_station(size_t arms, size_t k, GLfloat & x, GLfloat & z)
+{
+    const size_t side = size_t(std::ceil(std::sqrt(double(arms))));
+    const GLfloat half = 0.5f * (side - 1) * cfg::FLEET_SPACING;
+    x = (k % side) * cfg::FLEET_SPACING - half;
+    z = (k / side) * cfg::FLEET_SPACING - half;
+}
+
+arm::Fleet::Fleet(size_t arms, unsigned int seed)
+    : n_(arms), begin_(0), end_(arms), tick_(0), t_(0.0), blend_(arms),
+      rate_(arms), phase_(arms), wobble_amplitude_(arms), wobble_rate_(arms),
+      wobble_phase_(arms), shapes_(arms), bases_(arms), footprints_(arms)
+{
+    init(seed);
+}
+
+arm::Fleet::Fleet(size_t arms, size_t begin, size_t end, unsigned int seed)
+    : n_(arms), begin_(begin), end_(end), tick_(0), t_(0.0), blend_(arms),
+      rate_(arms), phase_(arms), wobble_amplitude_(arms), wobble_rate_(arms),
+      wobble_phase_(arms), shapes_(arms), bases_(arms), footprints_(arms)
+{
+    init(seed);
+}
+
+void arm::Fleet::init(unsigned int seed)
+{
+    for (int i = 0; i < CYCLE_KEYS; ++i) blend_.add_keyframe(CYCLE[i]);
+    heading_ = blend_.add_layer(HEADING);
+    wobble_ = blend_.add_layer(WOBBLE);
+
+    // every arm's parameters, owned or not, so a shard's arms move
+    // exactly as in the whole fleet
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution< float > unit(0.0f, 1.0f);
+    GLfloat * heading = blend_.amount(heading_);
+    for (size_t k = 0; k < n_; ++k)
+    {
+        rate_[k] = MIN_KEY_RATE + (MAX_KEY_RATE - MIN_KEY_RATE) * unit(rng);
+        phase_[k] = CYCLE_KEYS * unit(rng);
+        heading[k] = 2.0f * unit(rng) - 1.0f;
+        wobble_amplitude_[k] = unit(rng);
+        wobble_rate_[k] = MIN_WOBBLE_RATE
+                        + (MAX_WOBBLE_RATE - MIN_WOBBLE_RATE) * unit(rng);
+        wobble_phase_[k] = unit(rng);
+    }
+
+    for (int b = 0; b < 3; ++b)
+    {
+        FleetState & s = state_.buffer(b);
+        s.tick = 0;
+        s.t = 0.0;
+        s.x.resize(n_);
+        s.z.resize(n_);
+        s.poses.resize(n_);
+        for (int a = 0; a < 3; ++a) s.palm[a].assign(n_, 0.0f);
+        s.colliding.assign(n_, 0);
+        s.touching.assign(n_, 0);
+        s.candidate_pairs = s.contact_pairs = 0;
+        s.broadphase_ms = s.narrow_ms = 0.0;
+        for (size_t k = 0; k < n_; ++k) fleet_station(n_, k, s.x[k], s.z[k]);
+    }
+}
+
+void arm::Fleet::move(mygllib::WorkPool & pool, float dt)
+{
+    t_ += dt;
+    ++tick_;
+    FleetState & out = state_.back();
+    out.tick = tick_;
+    out.t = t_;
+    pool.parallel_for(end_ - begin_, cfg::FLEET_GRAIN,
+                      [&](size_t begin, size_t end)
+    {
+        update(begin_ + begin, begin_ + end, out);
+    });
+
+    present_.clear();
+    for (size_t k = begin_; k < end_; ++k) present_.push_back(uint32_t(k));
+}
+
+void arm::Fleet::import(size_t k, const ArmShapes & shapes, const Box & base)
+{
+    shapes_[k] = shapes;
+    bases_[k] = base;
+    footprints_[k] = footprint(shapes, base);
+    present_.push_back(uint32_t(k));
+}
+
+void arm::Fleet::update(size_t begin, size_t end, FleetState & out)
+{
+    const float t = float(t_);
+
+    // keyframe weights: a smoothstep crossfade between neighbours in the
+    // cycle; the wobble amount is a triangle wave
+    GLfloat * wobble = blend_.amount(wobble_);
+    for (size_t k = begin; k < end; ++k)
+    {
+        GLfloat u = rate_[k] * t + phase_[k];
+        u -= CYCLE_KEYS * std::floor(u / CYCLE_KEYS);
+        const int i = std::min(int(u), CYCLE_KEYS - 1);
+        GLfloat s = u - i;
+        s = s * s * (3.0f - 2.0f * s);
+        for (int key = 0; key < CYCLE_KEYS; ++key) blend_.weight(key)[k] = 0.0f;
+        blend_.weight(i)[k] = 1.0f - s;
+        blend_.weight((i + 1) % CYCLE_KEYS)[k] = s;
+
+        GLfloat v = wobble_rate_[k] * t + wobble_phase_[k];
+        v -= std::floor(v);
+        wobble[k] = wobble_amplitude_[k] * (4.0f * std::fabs(v - 0.5f) - 1.0f);
+    }
+    blend_.evaluate(begin, end, out.poses);
+
+    // kinematics and collision per arm, in the arm's own frame
+    Frames f;
+    for (size_t k = begin; k < end; ++k)
+    {
+        Pose pose = out.pose(k);
+        const Vec3 base(pose.xb, pose.yb, pose.zb);
+        pose.xb = pose.yb = pose.zb = 0.0f;
+        forward_kinematics(pose, f);
+        ArmShapes & shapes = shapes_[k];
+        arm_shapes(f, shapes);
+        out.colliding[k] = in_collision(pose, shapes) ? 1 : 0;
+
+        translate(shapes, base);
+        pose.xb = base.x;
+        pose.yb = base.y;
+        pose.zb = base.z;
+        bases_[k] = base_box(pose);
+        footprints_[k] = footprint(shapes, bases_[k]);
+
+        const Vec3 palm = f.palm.origin() + base;
+        out.palm[0][k] = palm.x;
+        out.palm[1][k] = palm.y;
+        out.palm[2][k] = palm.z;
+    }
+}
+
+void arm::Fleet::collide(mygllib::WorkPool & pool)
+{
+    FleetState & out = state_.back();
+    const int64_t t0 = mygllib::now_ns();
+    present_footprints_.resize(present_.size());
+    for (size_t i = 0; i < present_.size(); ++i)
+        present_footprints_[i] = footprints_[present_[i]];
+    hash_.pairs(present_footprints_, candidates_);
+
+    // back to arm numbers, dropping pairs of two imported arms
+    size_t kept = 0;
+    for (size_t p = 0; p < candidates_.size(); ++p)
+    {
+        const uint32_t i = present_[candidates_[p].first];
+        const uint32_t j = present_[candidates_[p].second];
+        if (!owns(i) && !owns(j)) continue;
+        candidates_[kept++] = ArmPair(std::min(i, j), std::max(i, j));
+    }
+    candidates_.resize(kept);
+    const int64_t t1 = mygllib::now_ns();
+
+    hit_.resize(candidates_.size());
+    pool.parallel_for(candidates_.size(), cfg::FLEET_GRAIN,
+                      [&](size_t begin, size_t end)
+    {
+        for (size_t p = begin; p < end; ++p)
+        {
+            const uint32_t i = candidates_[p].first, j = candidates_[p].second;
+            hit_[p] = overlap(shapes_[i], bases_[i], shapes_[j], bases_[j]);
+        }
+    });
+
+    out.touching.assign(n_, 0);
+    out.candidate_pairs = 0;
+    out.contact_pairs = 0;
+    for (size_t p = 0; p < candidates_.size(); ++p)
+    {
+        const uint32_t i = candidates_[p].first, j = candidates_[p].second;
+        const bool counted = owns(i);               // the lower arm's shard
+        if (counted) ++out.candidate_pairs;
+        if (!hit_[p]) continue;
+        if (owns(i)) out.touching[i] = 1;
+        if (owns(j)) out.touching[j] = 1;
+        if (counted) ++out.contact_pairs;
+    }
+    out.broadphase_ms = mygllib::ns_to_ms(t1 - t0);
+    out.narrow_ms = mygllib::ns_to_ms(mygllib::now_ns() - t1);
+    state_.publish();
+}
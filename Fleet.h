@@ -0,0 +1,177 @@
+// File  : Fleet.h
+// Author: Cole Schwandt
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Blend.h"
+#include "Broadphase.h"
+#include "TripleBuffer.h"
+#include "WorkPool.h"
+
+namespace cfg
+{
+    // -------- fleet --------
+    // Stations sit on a square grid in the XZ plane; neighbours' reach
+    // (ARM_REACH(), about 8.2 from the shoulder) overlaps.
+    const GLfloat FLEET_SPACING = 6.0f;
+    const size_t  FLEET_GRAIN = 16;     // arms per WorkPool chunk
+
+    // Furthest any part of an arm gets from its shoulder: the links end
+    // to end out to a fingertip's capsule, or the palm's corners.
+    inline GLfloat ARM_REACH()
+    {
+        const GLfloat elbow = JOINT_R + ARM_L;
+        const GLfloat palm = JOINT_R + LINK_GAP() + ARM_L + 0.5f * PALM_SIZE;
+        const GLfloat mount = std::sqrt(FINGER_OFFSET_X * FINGER_OFFSET_X
+                                        + PALM_TO_FINGER_Y * PALM_TO_FINGER_Y
+                                        + FINGER_OFFSET_Z * FINGER_OFFSET_Z);
+        const GLfloat finger = mount + 2.0f * FINGER_DIGIT_L
+                             + std::max(FINGER_DIGIT_R, FINGER_JOINT_R);
+        return elbow + palm
+             + std::max(finger, 0.5f * std::sqrt(3.0f) * PALM_SIZE);
+    }
+
+    // Arms whose stations are further apart than this along x or z can
+    // never touch: one reach against the other's reach or base.
+    inline GLfloat FLEET_TOUCH_RANGE()
+    {
+        const GLfloat base = 0.5f * BASE_SIZE * std::max(BASE_SX, BASE_SZ);
+        return ARM_REACH() + std::max(ARM_REACH(), base);
+    }
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // FleetState
+    //
+    // Everything one tick produced, one array per quantity (structure of
+    // arrays), indexed by arm. Angles are in degrees like Pose; the base
+    // channels of poses are offsets from the station; palm is the palm
+    // center in world coordinates.
+    //-------------------------------------------------------------------------
+    struct FleetState
+    {
+        uint64_t tick;
+        double t;                                   // sim time (s)
+        std::vector< GLfloat > x, z;                // station
+        PoseArray poses;
+        std::vector< GLfloat > palm[3];
+        std::vector< unsigned char > colliding;     // with itself or its base
+        std::vector< unsigned char > touching;      // another arm or its base
+        uint32_t candidate_pairs;                   // passed the broadphase
+        uint32_t contact_pairs;                     // and the narrow phase
+        double broadphase_ms, narrow_ms;            // cost of each this tick
+
+        size_t size() const { return x.size(); }
+        Pose pose(size_t k) const;                  // base in world coordinates
+    };
+
+    // Station of arm k of a fleet of `arms`: a square grid in the XZ plane,
+    // row by row, centered on the origin.
+    void fleet_station(size_t arms, size_t k, GLfloat & x, GLfloat & z);
+
+    //-------------------------------------------------------------------------
+    // Fleet
+    //
+    // Many arms, each working through the same pick-and-place cycle of
+    // keyframes at its own rate and phase, turned to its own heading and
+    // with its own wobble: a BlendTree with four keyframes and two
+    // additive layers. step() advances every arm on a WorkPool: keyframe
+    // weights, the blend, forward kinematics with grip blending, and the
+    // self/base collision test. Then arms whose floor footprints share a
+    // SpatialHash cell are tested against each other, again spread over
+    // the pool. Workers write straight into the back buffer of a
+    // TripleBuffer, which is published once the whole tick is done, so a
+    // renderer on another thread always sees one complete tick.
+    //
+    // USAGE:
+    // arm::Fleet fleet(500);
+    // mygllib::WorkPool pool(4);
+    // fleet.step(pool, 0.01f);                      // sim thread
+    //
+    // fleet.acquire();                              // render thread
+    // const arm::FleetState & s = fleet.front();
+    //
+    // A Fleet can also own only arms [begin, end) of the fleet, as one
+    // shard of it (Shard.h). Every arm keeps its motion, whatever the
+    // split. step() is then move(), the owner bringing in the
+    // neighbouring arms of other shards with import(), and collide().
+    // Only owned arms are moved and published; the pair tests cover every
+    // pair with at least one owned arm, and candidate and contact pairs
+    // are counted by the shard owning the lower arm, so the shards' counts
+    // add up to the whole fleet's.
+    //-------------------------------------------------------------------------
+    class Fleet
+    {
+    public:
+        Fleet(size_t arms, unsigned int seed=1);
+        Fleet(size_t arms, size_t begin, size_t end, unsigned int seed=1);
+
+        void step(mygllib::WorkPool & pool, float dt)
+        {
+            move(pool, dt);
+            collide(pool);
+        }
+
+        void move(mygllib::WorkPool & pool, float dt);
+        void import(size_t k, const ArmShapes & shapes, const Box & base);
+        void collide(mygllib::WorkPool & pool);
+
+        // world-space shapes of arm k from the last move() or import()
+        const ArmShapes & shapes(size_t k) const { return shapes_[k]; }
+        const Box & base(size_t k) const         { return bases_[k]; }
+
+        bool acquire()                      { return state_.acquire(); }
+        const FleetState & front() const    { return state_.front(); }
+
+        size_t size() const  { return n_; }
+        size_t begin() const { return begin_; }
+        size_t end() const   { return end_; }
+        bool owns(size_t k) const { return begin_ <= k && k < end_; }
+
+        // the last step()'s floor footprints, one per arm
+        const std::vector< Footprint > & footprints() const
+        {
+            return footprints_;
+        }
+
+    private:
+        Fleet(const Fleet &);
+        Fleet & operator=(const Fleet &);
+
+        void init(unsigned int seed);
+        void update(size_t begin, size_t end, FleetState & out);
+
+        size_t n_;
+        size_t begin_, end_;                    // owned arms
+        uint64_t tick_;
+        double t_;
+
+        // motion: keyframe cycle position rate * t + phase (in keyframes),
+        // heading layer constant, wobble layer a triangle wave
+        BlendTree blend_;
+        int heading_, wobble_;
+        std::vector< GLfloat > rate_, phase_;
+        std::vector< GLfloat > wobble_amplitude_, wobble_rate_, wobble_phase_;
+
+        // world-space shapes of the tick, for the inter-arm tests
+        std::vector< ArmShapes > shapes_;
+        std::vector< Box > bases_;
+        std::vector< Footprint > footprints_;
+        std::vector< uint32_t > present_;       // owned, then imported arms
+        std::vector< Footprint > present_footprints_;
+        SpatialHash hash_;
+        std::vector< ArmPair > candidates_;
+        std::vector< unsigned char > hit_;      // per candidate
+
+        mygllib::TripleBuffer< FleetState > state_;
+    };
+}
+
+#endif
@@ -0,0 +1,218 @@
+// File  : Framebuffer.cpp
+// Author: Cole Schwandt
+
+#define GL_GLEXT_PROTOTYPES
+#include <algorithm>
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include "debug.h"
+#include "Framebuffer.h"
+
+mygllib::ScaledFramebuffer::ScaledFramebuffer()
+    : fbo_(0), color_(0), depth_(0), w_(0), h_(0), bw_(0), bh_(0),
+      active_(false)
+{}
+
+mygllib::ScaledFramebuffer::~ScaledFramebuffer()
+{
+    release();
+}
+
+void mygllib::ScaledFramebuffer::release()
+{
+    if (fbo_ == 0) return;
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_);
+    fbo_ = color_ = depth_ = 0;
+    bw_ = bh_ = 0;
+}
+
+void mygllib::ScaledFramebuffer::begin(int w, int h, float scale)
+{
+    w_ = w;
+    h_ = h;
+    active_ = true;
+
+    const int bw = scale < 1.0f ? std::max(1, int(w * scale + 0.5f)) : w;
+    const int bh = scale < 1.0f ? std::max(1, int(h * scale + 0.5f)) : h;
+    if (bw != bw_ || bh != bh_)
+    {
+        release();
+        glGenFramebuffers(1, &fbo_);
+        glGenRenderbuffers(1, &color_);
+        glGenRenderbuffers(1, &depth_);
+        glBindRenderbuffer(GL_RENDERBUFFER, color_);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, bw, bh);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, bw, bh);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, color_);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER, depth_);
+        bw_ = bw;
+        bh_ = bh;
+    }
+    GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, fbo_));
+    glViewport(0, 0, bw_, bh_);
+}
+
+void mygllib::ScaledFramebuffer::end()
+{
+    if (!active_) return;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    const bool same = bw_ == w_ && bh_ == h_;
+    GL_CALL(glBlitFramebuffer(0, 0, bw_, bh_, 0, 0, w_, h_,
+                              GL_COLOR_BUFFER_BIT,
+                              same ? GL_NEAREST : GL_LINEAR));
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, w_, h_);
+    active_ = false;
+}
+
+//==============================================================
+// StaticLayer
+//==============================================================
+namespace
+{
+    // internal format of a renderbuffer attached to the bound draw
+    // framebuffer object, or GL_NONE
+    GLint attachment_format(GLenum attachment)
+    {
+        GLint type = GL_NONE, name = 0, format = GL_NONE, bound;
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, attachment,
+            GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+        if (type != GL_RENDERBUFFER) return GL_NONE;
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, attachment,
+            GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &name);
+        glGetIntegerv(GL_RENDERBUFFER_BINDING, &bound);
+        glBindRenderbuffer(GL_RENDERBUFFER, name);
+        glGetRenderbufferParameteriv(GL_RENDERBUFFER,
+                                     GL_RENDERBUFFER_INTERNAL_FORMAT, &format);
+        glBindRenderbuffer(GL_RENDERBUFFER, bound);
+        return format;
+    }
+
+    // w x h of color and depth from one framebuffer to another
+    void copy(GLint from, GLint to, int w, int h)
+    {
+        GLint read, draw;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, from);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, to);
+        GL_CALL(glBlitFramebuffer(0, 0, w, h, 0, 0, w, h,
+                                  GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
+                                  GL_NEAREST));
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, read);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw);
+    }
+}
+
+uint64_t mygllib::StaticLayer::generation_ = 0;
+
+mygllib::StaticLayer::StaticLayer()
+    : fbo_(0), color_(0), depth_(0), color_format_(GL_NONE),
+      depth_format_(GL_NONE), w_(0), h_(0), seen_generation_(0),
+      valid_(false), drawing_(false), uncached_(false), draws_(0),
+      restores_(0)
+{}
+
+mygllib::StaticLayer::~StaticLayer()
+{
+    release();
+}
+
+void mygllib::StaticLayer::release()
+{
+    if (fbo_ == 0) return;
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteRenderbuffers(1, &color_);
+    glDeleteRenderbuffers(1, &depth_);
+    fbo_ = color_ = depth_ = 0;
+    w_ = h_ = 0;
+    valid_ = false;
+}
+
+bool mygllib::StaticLayer::begin(int w, int h, const float * key, int n)
+{
+    // the frame's buffers: only a single-sampled framebuffer object's
+    // renderbuffers can be matched exactly
+    GLint target, samples = 0, color = GL_NONE, depth = GL_NONE;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    glGetIntegerv(GL_SAMPLE_BUFFERS, &samples);
+    if (target != 0 && samples == 0)
+    {
+        color = attachment_format(GL_COLOR_ATTACHMENT0);
+        depth = attachment_format(GL_DEPTH_ATTACHMENT);
+    }
+    uncached_ = color == GL_NONE || depth == GL_NONE;
+    if (uncached_)
+    {
+        valid_ = false;
+        ++draws_;
+        return true;
+    }
+
+    if (valid_ && seen_generation_ == generation_ && w == w_ && h == h_
+        && key_.size() == size_t(n) && std::equal(key, key + n, key_.begin()))
+    {
+        ++restores_;
+        return false;
+    }
+
+    if (w != w_ || h != h_ || color != color_format_ || depth != depth_format_)
+    {
+        release();
+        GLuint rb[2];
+        glGenRenderbuffers(2, rb);
+        color_ = rb[0];
+        depth_ = rb[1];
+        glBindRenderbuffer(GL_RENDERBUFFER, color_);
+        glRenderbufferStorage(GL_RENDERBUFFER, color, w, h);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+        glRenderbufferStorage(GL_RENDERBUFFER, depth, w, h);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &fbo_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, color_);
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER, depth_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        color_format_ = color;
+        depth_format_ = depth;
+        w_ = w;
+        h_ = h;
+    }
+    key_.assign(key, key + n);
+    seen_generation_ = generation_;
+    valid_ = false;                     // until end() has kept it
+    drawing_ = true;
+    ++draws_;
+    return true;
+}
+
+// the frame has the static part: keep it
+void mygllib::StaticLayer::end()
+{
+    if (!drawing_) return;
+    GLint target;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    copy(target, fbo_, w_, h_);
+    valid_ = true;
+    drawing_ = false;
+}
+
+void mygllib::StaticLayer::restore()
+{
+    if (uncached_ || !valid_) return;
+    GLint target;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+    copy(fbo_, target, w_, h_);
+}
@@ -0,0 +1,152 @@
+// File  : Framebuffer.h
+// Author: Cole Schwandt
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/freeglut.h>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // ScaledFramebuffer
+    //
+    // Draws a frame into a color + depth framebuffer object and blits it
+    // onto the window, at the window's resolution or, for when filling
+    // every pixel costs too much (software rasterizers), at a fraction of
+    // it. begin() binds a buffer of scale * w x scale * h (w x h at scale
+    // 1 or more) and sets the viewport to it; end() blits it onto the
+    // window's w x h back buffer, with linear filtering if it is smaller,
+    // and puts the window's framebuffer and viewport back. The projection
+    // does not change, since the aspect ratio is kept.
+    //
+    // Drawing through a buffer at full size costs one blit, and gives
+    // every frame the same framebuffer to rasterize into, one whose
+    // depth a StaticLayer can copy exactly (DEPTH_COMPONENT24, no
+    // stencil).
+    //
+    // The buffer is made on the first frame and remade when the size
+    // changes. The context must be current in every call, including the
+    // destructor.
+    //
+    // USAGE:
+    // mygllib::ScaledFramebuffer scaled;
+    // void display()
+    // {
+    //     scaled.begin(w, h, 0.5f);
+    //     ... draw the scene ...
+    //     scaled.end();
+    //     ... draw the HUD at full resolution ...
+    //     glutSwapBuffers();
+    // }
+    //-------------------------------------------------------------------------
+    class ScaledFramebuffer
+    {
+    public:
+        ScaledFramebuffer();
+        ~ScaledFramebuffer();
+
+        void begin(int w, int h, float scale);
+        void end();
+
+        // size drawn at by the current frame
+        int width() const  { return active_ ? bw_ : w_; }
+        int height() const { return active_ ? bh_ : h_; }
+
+    private:
+        ScaledFramebuffer(const ScaledFramebuffer &);
+        ScaledFramebuffer & operator=(const ScaledFramebuffer &);
+
+        void release();
+
+        GLuint fbo_, color_, depth_;
+        int w_, h_;                     // window
+        int bw_, bh_;                   // buffer
+        bool active_;
+    };
+
+    //-------------------------------------------------------------------------
+    // StaticLayer
+    //
+    // Keeps the part of a frame that does not change from one frame to
+    // the next (floor, base), color and depth, so a still
+    // camera does not redraw it every frame. The caller describes what
+    // the layer depends on with a key, any n floats (camera, size, base
+    // position). begin() returns true when the layer has to be drawn:
+    // the key changed, invalidate() or invalidate_all() was called, or
+    // nothing is cached yet. The caller then draws the static part into
+    // the frame as usual and calls end(), which blits color and depth
+    // into the layer. Otherwise restore() blits them back into the frame.
+    // Either way the moving part goes on top, depth-tested against the
+    // static one.
+    //
+    // A restored frame is the same, byte for byte, as one drawn in full:
+    // the static part is always drawn into the frame's own framebuffer,
+    // and the layer's buffers have the frame's formats, so both blits
+    // copy exactly. (Mesa's blit from the window's packed depth-stencil
+    // rounds some depths, and a framebuffer object of the layer's own
+    // can break rasterization ties differently from the window.) So the
+    // frame must be drawn into a framebuffer object with a depth
+    // renderbuffer, such as ScaledFramebuffer's. If it is not, or it is
+    // multisampled, nothing is cached: begin() always returns true and
+    // end() does nothing.
+    //
+    // Camera keys and window resizes call invalidate_all(). The context
+    // must be current in every call, including the destructor.
+    //
+    // USAGE:
+    // mygllib::StaticLayer layer;
+    // void display()
+    // {
+    //     scaled.begin(w, h, 1.0f);
+    //     const float key[] = { ... camera, w, h, base ... };
+    //     if (layer.begin(w, h, key, sizeof(key) / sizeof(key[0])))
+    //     {
+    //         ... clear, draw the floor and base ...
+    //         layer.end();
+    //     }
+    //     else
+    //     {
+    //         layer.restore();
+    //     }
+    //     ... draw the arm ...
+    //     scaled.end();
+    // }
+    //-------------------------------------------------------------------------
+    class StaticLayer
+    {
+    public:
+        StaticLayer();
+        ~StaticLayer();
+
+        bool begin(int w, int h, const float * key, int n);
+        void end();
+        void restore();
+
+        void invalidate()            { valid_ = false; }
+        static void invalidate_all() { ++generation_; }
+
+        uint64_t draws() const    { return draws_; }    // layer drawn
+        uint64_t restores() const { return restores_; } // layer reused
+
+    private:
+        StaticLayer(const StaticLayer &);
+        StaticLayer & operator=(const StaticLayer &);
+
+        void release();
+
+        GLuint fbo_, color_, depth_;    // renderbuffers in the frame's formats
+        GLint color_format_, depth_format_;
+        int w_, h_;
+        std::vector< float > key_;
+        uint64_t seen_generation_;
+        bool valid_, drawing_, uncached_;
+        uint64_t draws_, restores_;
+
+        static uint64_t generation_;
+    };
+}
+
+#endif
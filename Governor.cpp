@@ -0,0 +1,74 @@
+// File  : Governor.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include "Governor.h"
+
+namespace
+{
+    const int MAX_HOLD_WINDOWS = 16;
+}
+
+mygllib::QualityGovernor::QualityGovernor(double target_ms, int levels,
+                                          int window, double raise_below)
+    : target_ms_(target_ms), raise_below_(raise_below),
+      levels_(std::max(levels, 1)), window_(std::max(window, 1)), level_(0),
+      hold_(3 * window_), ms_(MAX_HOLD_WINDOWS * window_, 0.0), next_(0),
+      count_(0), since_raise_(-1), changes_(0)
+{}
+
+double mygllib::QualityGovernor::mean_ms(size_t n) const
+{
+    n = std::min(n, count_);
+    if (n == 0) return 0.0;
+    double sum = 0.0;
+    for (size_t i = 1; i <= n; ++i)
+        sum += ms_[(next_ + ms_.size() - i) % ms_.size()];
+    return sum / n;
+}
+
+double mygllib::QualityGovernor::mean_ms() const
+{
+    return mean_ms(window_);
+}
+
+void mygllib::QualityGovernor::change(int level)
+{
+    level_ = level;
+    count_ = 0;
+    ++changes_;
+}
+
+bool mygllib::QualityGovernor::frame(double ms)
+{
+    ms_[next_] = ms;
+    next_ = (next_ + 1) % ms_.size();
+    ++count_;
+    if (since_raise_ >= 0) ++since_raise_;
+
+    if (count_ >= size_t(window_) && mean_ms(window_) > target_ms_
+        && level_ < levels_ - 1)
+    {
+        // the last raise did not hold: wait longer before the next one
+        if (since_raise_ >= 0 && since_raise_ < hold_)
+            hold_ = std::min(2 * hold_, MAX_HOLD_WINDOWS * window_);
+        since_raise_ = -1;
+        change(level_ + 1);
+        return true;
+    }
+
+    if (since_raise_ >= hold_)
+    {
+        hold_ = std::max(hold_ / 2, 3 * window_);
+        since_raise_ = -1;
+    }
+
+    if (count_ >= size_t(hold_) && mean_ms(hold_) < raise_below_ * target_ms_
+        && level_ > 0)
+    {
+        since_raise_ = 0;
+        change(level_ - 1);
+        return true;
+    }
+    return false;
+}
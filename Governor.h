@@ -0,0 +1,71 @@
+// File  : Governor.h
+// Author: Cole Schwandt
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <vector>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // QualityGovernor
+    //
+    // Picks a quality level, 0 (best) to levels - 1 (cheapest), that keeps
+    // the frame time at or under target_ms. The caller feeds it every
+    // frame's time and maps levels to whatever they cost (tessellation,
+    // resolution, ...), most expensive first.
+    //
+    // Hysteresis, so the level does not flip back and forth around the
+    // target:
+    //
+    //   - it drops a level once the mean over the last `window` frames is
+    //     over the target, and only raises one once the mean over a longer
+    //     hold is under raise_below * target;
+    //   - after a change it forgets the old samples, so the next decision
+    //     is made on frames of the new level only;
+    //   - a raise that has to be taken back within one hold doubles the
+    //     hold before the next raise (up to 16 windows), and a raise that
+    //     lasts halves it again.
+    //
+    // USAGE:
+    // mygllib::QualityGovernor governor(16.6, 5);
+    // void display()
+    // {
+    //     const int64_t t0 = mygllib::now_ns();
+    //     ... draw at governor.level() ...
+    //     glutSwapBuffers();
+    //     governor.frame(mygllib::ns_to_ms(mygllib::now_ns() - t0));
+    // }
+    //-------------------------------------------------------------------------
+    class QualityGovernor
+    {
+    public:
+        QualityGovernor(double target_ms, int levels, int window=30,
+                        double raise_below=0.7);
+
+        // One frame's time; true if the level changed.
+        bool frame(double ms);
+
+        int level() const          { return level_; }
+        int levels() const         { return levels_; }
+        double target_ms() const   { return target_ms_; }
+        double mean_ms() const;    // over the last window (or fewer) frames
+        int changes() const        { return changes_; }
+
+    private:
+        double mean_ms(size_t n) const;
+        void change(int level);
+
+        double target_ms_, raise_below_;
+        int levels_, window_;
+        int level_;
+        int hold_;                      // frames under target before a raise
+        std::vector< double > ms_;      // ring of the last hold_ frames
+        size_t next_, count_;
+        long since_raise_;              // frames since the last raise, or -1
+        int changes_;
+    };
+}
+
+#endif
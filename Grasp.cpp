@@ -0,0 +1,207 @@
+// File  : Grasp.cpp
+// Author: Cole Schwandt
+
+#include <cstring>
+#include "Grasp.h"
+
+namespace cfg
+{
+    // -------- grasp object --------
+    const GLfloat GRASP_R     = 0.24f;     // sphere/capsule radius
+    const GLfloat GRASP_HALF  = 0.22f;    // box half extent
+    const GLfloat GRASP_LEN   = 0.8f;     // capsule axis length (along z)
+    const GLfloat GRASP_AT_Y  = 0.9f;     // above the palm center
+
+    // -------- contact search --------
+    const int MARCH_STEPS  = 16;
+    const int BISECT_STEPS = 10;          // 1/16/1024 of full closure
+}
+
+namespace
+{
+    // Phalanx capsules of finger i on a fixed palm.
+    void phalanges(const arm::Mat4 & palm, int i, const FingerAngles & a,
+                   arm::Capsule & proximal, arm::Capsule & distal)
+    {
+        arm::Mat4 knuckle, middle, dist, tip;
+        arm::finger_kinematics(palm, i, a, knuckle, middle, dist, tip);
+        proximal.a = knuckle.origin();
+        proximal.b = middle.origin();
+        proximal.r = cfg::FINGER_DIGIT_R;
+        distal.a   = dist.origin();
+        distal.b   = tip.origin();
+        distal.r   = cfg::FINGER_DIGIT_R;
+    }
+
+    //---------------------------------------------------------------------
+    // March lo -> hi in fixed steps until touch(t), then bisect between the
+    // last free step and the first touching one. free_t is the furthest
+    // closure known to be free, hit_t the touching one. Returns false (and
+    // free_t = hi) if nothing is touched.
+    //---------------------------------------------------------------------
+    template < typename Touch >
+    bool first_contact(GLfloat lo, GLfloat hi, Touch touch,
+                       GLfloat & free_t, GLfloat & hit_t)
+    {
+        if (touch(lo))
+        {
+            free_t = hit_t = lo;
+            return true;
+        }
+        const GLfloat step = (hi - lo) / cfg::MARCH_STEPS;
+        GLfloat a = lo;
+        for (int k = 1; k <= cfg::MARCH_STEPS; ++k)
+        {
+            const GLfloat b = (k == cfg::MARCH_STEPS ? hi : lo + step * k);
+            if (touch(b))
+            {
+                GLfloat t = b;
+                for (int j = 0; j < cfg::BISECT_STEPS; ++j)
+                {
+                    const GLfloat m = 0.5f * (a + t);
+                    if (touch(m)) t = m; else a = m;
+                }
+                free_t = a;
+                hit_t = t;
+                return true;
+            }
+            a = b;
+        }
+        free_t = hit_t = hi;
+        return false;
+    }
+}
+
+arm::GraspObject arm::grasp_object(GraspObject::Shape shape)
+{
+    Pose rest;
+    memset(&rest, 0, sizeof(rest));
+    Frames f;
+    forward_kinematics(rest, f);
+    const Vec3 c = f.palm.point(Vec3(0.0f, cfg::GRASP_AT_Y, 0.0f));
+
+    GraspObject obj;
+    obj.shape = shape;
+    obj.sphere.c = c;
+    obj.sphere.r = cfg::GRASP_R;
+    const Vec3 half(cfg::GRASP_HALF, cfg::GRASP_HALF, cfg::GRASP_HALF);
+    obj.box.lo = c - half;
+    obj.box.hi = c + half;
+    // lying across the fingers, which close in the XY plane of the palm
+    const Vec3 axis(0.0f, 0.0f, 0.5f * cfg::GRASP_LEN);
+    obj.capsule.a = c - axis;
+    obj.capsule.b = c + axis;
+    obj.capsule.r = cfg::GRASP_R;
+    return obj;
+}
+
+bool arm::parse_shape(const char * name, GraspObject::Shape & shape)
+{
+    if (strcmp(name, "sphere") == 0)       shape = GraspObject::SPHERE;
+    else if (strcmp(name, "box") == 0)     shape = GraspObject::BOX;
+    else if (strcmp(name, "capsule") == 0) shape = GraspObject::CAPSULE;
+    else return false;
+    return true;
+}
+
+bool arm::overlap(const Capsule & c, const GraspObject & obj)
+{
+    switch (obj.shape)
+    {
+        case GraspObject::SPHERE:  return overlap(c, obj.sphere);
+        case GraspObject::BOX:     return overlap(c, obj.box);
+        case GraspObject::CAPSULE: return overlap(c, obj.capsule);
+        default:                   return false;
+    }
+}
+
+arm::Vec3 arm::contact_point(const Capsule & c, const GraspObject & obj)
+{
+    switch (obj.shape)
+    {
+        case GraspObject::SPHERE:
+        {
+            const Sphere & s = obj.sphere;
+            const Vec3 p = c.a + (c.b - c.a) * closest_t(c.a, c.b, s.c);
+            return s.c + normalize(p - s.c) * s.r;
+        }
+        case GraspObject::BOX:
+        {
+            float t;
+            segment_box_dist2(c.a, c.b, obj.box, t);
+            return closest_point(c.a + (c.b - c.a) * t, obj.box);
+        }
+        case GraspObject::CAPSULE:
+        {
+            const Capsule & d = obj.capsule;
+            float s, t;
+            segment_segment_dist2(c.a, c.b, d.a, d.b, s, t);
+            const Vec3 p = c.a + (c.b - c.a) * s;
+            const Vec3 q = d.a + (d.b - d.a) * t;
+            return q + normalize(p - q) * d.r;
+        }
+        default:
+            return c.a;
+    }
+}
+
+void arm::resolve_grasp(const Mat4 & palm, GLfloat grip,
+                        const GraspObject & obj, Grasp & grasp)
+{
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        FingerContact & fc = grasp.finger[i];
+        fc.touching = 0;
+        fc.proximal = fc.distal = grip;
+
+        if (obj.shape != GraspObject::NONE)
+        {
+            Capsule prox, dist;
+
+            // both phalanges together until either touches
+            GLfloat t, hit;
+            const bool touched = first_contact(0.0f, grip,
+                [&](GLfloat c)
+                {
+                    phalanges(palm, i, finger_angles(i, c, c), prox, dist);
+                    return overlap(prox, obj) || overlap(dist, obj);
+                }, t, hit);
+            fc.proximal = fc.distal = t;
+
+            if (touched)
+            {
+                phalanges(palm, i, finger_angles(i, hit, hit), prox, dist);
+                if (overlap(prox, obj))
+                {
+                    fc.touching |= FingerContact::PROXIMAL;
+
+                    // proximal is blocked; the distal phalanx keeps curling
+                    const GLfloat p = t;
+                    GLfloat d;
+                    if (first_contact(p, grip,
+                            [&](GLfloat c)
+                            {
+                                phalanges(palm, i, finger_angles(i, p, c),
+                                          prox, dist);
+                                return overlap(dist, obj);
+                            }, d, hit))
+                        fc.touching |= FingerContact::DISTAL;
+                    fc.distal = d;
+                }
+                else
+                {
+                    fc.touching |= FingerContact::DISTAL;
+                }
+            }
+
+            if (fc.touching)
+            {
+                phalanges(palm, i, finger_angles(i, fc.proximal, fc.distal),
+                          prox, dist);
+                fc.point[0] = contact_point(prox, obj);
+                fc.point[1] = contact_point(dist, obj);
+            }
+        }
+        grasp.angles[i] = finger_angles(i, fc.proximal, fc.distal);
+    }
+}
@@ -0,0 +1,86 @@
+// File  : Grasp.h
+// Author: Cole Schwandt
+
+#ifndef GRASP_H
+#define GRASP_H
+
+#include "Collision.h"
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // GraspObject
+    //
+    // One free object in the world the gripper can close on. Only the
+    // primitive matching shape is used.
+    //-------------------------------------------------------------------------
+    struct GraspObject
+    {
+        enum Shape { NONE, SPHERE, BOX, CAPSULE };
+
+        Shape   shape;
+        Sphere  sphere;
+        Box     box;
+        Capsule capsule;
+    };
+
+    // An object of the given shape held where the fingers of the rest pose
+    // meet, so closing the gripper without moving the arm grasps it.
+    GraspObject grasp_object(GraspObject::Shape shape);
+
+    // "sphere", "box", "capsule" -> shape; false if unknown.
+    bool parse_shape(const char * name, GraspObject::Shape & shape);
+
+    bool overlap(const Capsule & c, const GraspObject & obj);
+
+    // Point on the object's surface nearest the axis of c.
+    Vec3 contact_point(const Capsule & c, const GraspObject & obj);
+
+    //-------------------------------------------------------------------------
+    // FingerContact
+    //
+    // How far each phalanx of one finger got, as a closure in [0, grip]
+    // (0 = OPEN_F*, 1 = CLOSED_F*), and where it touches the object.
+    //-------------------------------------------------------------------------
+    struct FingerContact
+    {
+        enum { PROXIMAL = 1, DISTAL = 2 };
+
+        GLfloat proximal;
+        GLfloat distal;
+        int     touching;     // PROXIMAL | DISTAL bits
+        Vec3    point[2];     // contact on the object, valid if touching
+
+        // fraction of full closure reached, averaged over both phalanges
+        GLfloat closure() const { return 0.5f * (proximal + distal); }
+    };
+
+    struct Grasp
+    {
+        FingerContact finger[NUM_FINGERS];
+        FingerAngles  angles[NUM_FINGERS];   // for forward_kinematics/draw_arm
+    };
+
+    //-------------------------------------------------------------------------
+    // resolve_grasp
+    //
+    // Closes each finger from open towards grip, stopping every phalanx at
+    // its first contact with obj. Both phalanges close together until one
+    // touches. A blocked distal phalanx stops the whole finger; a blocked
+    // proximal one lets the distal phalanx keep curling until it touches
+    // too (an underactuated finger wrapping around the object).
+    //
+    // Each search marches a fixed number of steps and refines the first
+    // contact by bisection, so the cost is bounded and nothing is
+    // allocated: cheap enough to run on every 1 kHz sim tick.
+    //
+    // USAGE:
+    // arm::Grasp grasp;
+    // arm::resolve_grasp(frames.palm, pose.grip, object, grasp);
+    // arm::forward_kinematics(pose, frames, grasp.angles);
+    //-------------------------------------------------------------------------
+    void resolve_grasp(const Mat4 & palm, GLfloat grip,
+                       const GraspObject & obj, Grasp & grasp);
+}
+
+#endif
@@ -0,0 +1,107 @@
+// File  : Headless.cpp
+// Author: Cole Schwandt
+
+#define EGL_NO_X11
+#include <iostream>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "Headless.h"
+
+namespace
+{
+    // One EGL display for the process, initialized on first use (C++11
+    // guarantees this is thread-safe).
+    EGLDisplay egl_display()
+    {
+        static EGLDisplay display = []()
+        {
+            EGLDisplay d = EGL_NO_DISPLAY;
+            PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+                eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (get_platform_display != NULL)
+            {
+                d = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                                         EGL_DEFAULT_DISPLAY, NULL);
+            }
+            if (d == EGL_NO_DISPLAY) d = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            if (d == EGL_NO_DISPLAY || !eglInitialize(d, NULL, NULL))
+            {
+                std::cout << "EGL: cannot initialize display" << std::endl;
+                return EGL_NO_DISPLAY;
+            }
+            eglBindAPI(EGL_OPENGL_API);
+            return d;
+        }();
+        return display;
+    }
+}
+
+mygllib::OffscreenContext::OffscreenContext(int w, int h)
+    : context_(EGL_NO_CONTEXT), surface_(EGL_NO_SURFACE), w_(w), h_(h)
+{
+    EGLDisplay d = egl_display();
+    if (d == EGL_NO_DISPLAY) throw OffscreenError();
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint n = 0;
+    if (!eglChooseConfig(d, config_attribs, &config, 1, &n) || n == 0)
+    {
+        std::cout << "EGL: no pbuffer config" << std::endl;
+        throw OffscreenError();
+    }
+
+    // eglBindAPI() is per thread
+    eglBindAPI(EGL_OPENGL_API);
+    // EGL 1.5 debug context; older EGLs reject the attribute
+    const EGLint debug_attribs[] = { EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+                                     EGL_NONE };
+    context_ = EGL_NO_CONTEXT;
+    if (GL_DEBUG)
+        context_ = eglCreateContext(d, config, EGL_NO_CONTEXT, debug_attribs);
+    if (context_ == EGL_NO_CONTEXT)
+        context_ = eglCreateContext(d, config, EGL_NO_CONTEXT, NULL);
+    const EGLint pbuffer_attribs[] = { EGL_WIDTH, w, EGL_HEIGHT, h, EGL_NONE };
+    surface_ = eglCreatePbufferSurface(d, config, pbuffer_attribs);
+    if (context_ == EGL_NO_CONTEXT || surface_ == EGL_NO_SURFACE)
+    {
+        std::cout << "EGL: cannot create " << w << 'x' << h
+                  << " offscreen context" << std::endl;
+        if (context_ != EGL_NO_CONTEXT) eglDestroyContext(d, context_);
+        if (surface_ != EGL_NO_SURFACE) eglDestroySurface(d, surface_);
+        throw OffscreenError();
+    }
+}
+
+mygllib::OffscreenContext::~OffscreenContext()
+{
+    EGLDisplay d = egl_display();
+    if (eglGetCurrentContext() == context_)
+        eglMakeCurrent(d, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroySurface(d, surface_);
+    eglDestroyContext(d, context_);
+}
+
+void mygllib::OffscreenContext::make_current() const
+{
+    eglBindAPI(EGL_OPENGL_API);
+    if (!eglMakeCurrent(egl_display(), surface_, surface_, context_))
+    {
+        std::cout << "EGL: eglMakeCurrent failed" << std::endl;
+        throw OffscreenError();
+    }
+}
+
+void mygllib::OffscreenContext::release() const
+{
+    eglMakeCurrent(egl_display(), EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+}
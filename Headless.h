@@ -0,0 +1,67 @@
+// File  : Headless.h
+// Author: Cole Schwandt
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <GL/freeglut.h>
+#include "config.h"
+
+namespace mygllib
+{
+    class OffscreenError
+    {};
+
+    //-------------------------------------------------------------------------
+    // GLUT calls that abort when there is no window. Input handlers and
+    // display callbacks use these so they can also be driven headless.
+    //-------------------------------------------------------------------------
+    inline
+    void post_redisplay()
+    {
+        if (!HEADLESS) glutPostRedisplay();
+    }
+
+    inline
+    void swap_buffers()
+    {
+        if (!HEADLESS) glutSwapBuffers();
+    }
+
+    //-------------------------------------------------------------------------
+    // OffscreenContext
+    //
+    // A compatibility-profile OpenGL context rendering into a w x h EGL
+    // pbuffer, for running without a window or X server (Mesa llvmpipe
+    // works). Each thread that renders needs its own context; a context is
+    // current on at most one thread at a time.
+    //
+    // USAGE:
+    // mygllib::HEADLESS = true;
+    // mygllib::OffscreenContext ctx(400, 400);
+    // ctx.make_current();
+    // ... draw, glReadPixels() ...
+    //-------------------------------------------------------------------------
+    class OffscreenContext
+    {
+    public:
+        OffscreenContext(int w, int h);
+        ~OffscreenContext();
+
+        void make_current() const;
+        void release() const;
+
+        int width() const  { return w_; }
+        int height() const { return h_; }
+
+    private:
+        OffscreenContext(const OffscreenContext &);
+        OffscreenContext & operator=(const OffscreenContext &);
+
+        void * context_; // EGLContext
+        void * surface_; // EGLSurface
+        int w_, h_;
+    };
+}
+
+#endif
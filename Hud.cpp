@@ -0,0 +1,83 @@
+// File  : Hud.cpp
+// Author: Cole Schwandt
+
+#include <iostream>
+#include <string>
+#include <GL/freeglut.h>
+#include "config.h"
+#include "Hud.h"
+
+namespace
+{
+    // stroke font units to pixels: about 12 px per line
+    const GLfloat HUD_TEXT_SCALE = 0.1f;
+
+    // captured on first use, when a GLUT context is current
+    const mygllib::StrokeFont & roman()
+    {
+        static const mygllib::StrokeFont font(GLUT_STROKE_ROMAN);
+        return font;
+    }
+}
+
+mygllib::Hud::~Hud()
+{
+    delete batch_;
+}
+
+void mygllib::Hud::add(const std::string & s)
+{
+    if (n_ == lines_.size()) lines_.push_back(s);
+    else lines_[n_] = s;
+    ++n_;
+}
+
+void mygllib::Hud::label(GLfloat x, GLfloat y, const std::string & s)
+{
+    if (m_ == labels_.size()) labels_.push_back(Label());
+    Label & l = labels_[m_++];
+    l.x = x;
+    l.y = y;
+    l.s = s;
+}
+
+void mygllib::Hud::draw()
+{
+    if (HEADLESS || (n_ == 0 && m_ == 0)) return;
+    GL_SCOPE("hud");
+    if (batch_ == NULL) batch_ = new TextBatch(roman());
+
+    GLint vp[4];
+    glGetIntegerv(GL_VIEWPORT, vp);
+
+    batch_->begin();
+    for (size_t i = 0; i < n_; ++i)
+    {
+        const int y = vp[3] - margin_ - int(i + 1) * line_height_;
+        batch_->add(margin_, y, HUD_TEXT_SCALE, lines_[i]);
+    }
+    for (size_t i = 0; i < m_; ++i)
+        batch_->add(labels_[i].x, labels_[i].y, HUD_TEXT_SCALE, labels_[i].s);
+
+    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LINE_BIT);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_DEPTH_TEST);
+    glColor3f(0.0f, 0.0f, 0.0f);
+    glLineWidth(1.0f);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, vp[2], 0, vp[3], -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    batch_->draw();
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopAttrib();
+}
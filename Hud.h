@@ -0,0 +1,71 @@
+// File  : Hud.h
+// Author: Cole Schwandt
+
+#ifndef HUD_H
+#define HUD_H
+
+#include <string>
+#include <vector>
+#include <GL/freeglut.h>
+#include "TextBatch.h"
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // Hud
+    //
+    // Lines of text drawn over the scene in window coordinates, top-left
+    // first, plus free labels at any window position (e.g. projected
+    // joints). Everything goes through one TextBatch, so the whole HUD is
+    // one draw call and unchanged strings are not re-tessellated. The
+    // glyphs are captured from the GLUT stroke font, so the HUD only
+    // works with a GLUT window; draw() does nothing when HEADLESS.
+    //
+    // USAGE:
+    // mygllib::Hud hud;
+    // void display()
+    // {
+    //     ... draw scene ...
+    //     hud.clear();
+    //     hud.add("hello");
+    //     hud.label(x, y, "elbow");
+    //     hud.draw();
+    // }
+    //-------------------------------------------------------------------------
+    class Hud
+    {
+    public:
+        Hud(int margin=10, int line_height=16)
+            : margin_(margin), line_height_(line_height), n_(0), m_(0),
+              batch_(NULL)
+        {}
+        ~Hud();
+
+        void clear() { n_ = m_ = 0; }
+        void add(const std::string & s);
+        void label(GLfloat x, GLfloat y, const std::string & s);
+        void draw();
+
+        // strings re-tessellated by the last draw()
+        size_t rebuilt() const { return batch_ ? batch_->rebuilt() : 0; }
+
+    private:
+        Hud(const Hud &);
+        Hud & operator=(const Hud &);
+
+        struct Label
+        {
+            GLfloat x, y;
+            std::string s;
+        };
+
+        int margin_, line_height_;
+        size_t n_;                      // lines in use; buffers are reused
+        std::vector< std::string > lines_;
+        size_t m_;                      // labels in use
+        std::vector< Label > labels_;
+        TextBatch * batch_;             // created on the first draw()
+    };
+}
+
+#endif
@@ -0,0 +1,175 @@
+// File  : Jacobian.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Jacobian.h"
+
+namespace cfg
+{
+    // |cos(yaw)| below this: pitch and roll axes (nearly) coincide
+    const GLfloat GIMBAL_COS = 0.1f;
+}
+
+namespace
+{
+    //---------------------------------------------------------------------
+    // Cyclic Jacobi eigen-decomposition of a symmetric N x N matrix. a is
+    // destroyed; eigenvalues end up on its diagonal, eigenvectors in the
+    // columns of v. Converges quadratically; a handful of sweeps is plenty
+    // for N <= 6.
+    //---------------------------------------------------------------------
+    template < int N >
+    void jacobi(double a[N][N], double v[N][N])
+    {
+        for (int i = 0; i < N; ++i)
+            for (int k = 0; k < N; ++k)
+                v[i][k] = (i == k ? 1.0 : 0.0);
+
+        for (int sweep = 0; sweep < 16; ++sweep)
+        {
+            double off = 0.0, diag = 0.0;
+            for (int p = 0; p < N; ++p)
+            {
+                diag += a[p][p] * a[p][p];
+                for (int q = p + 1; q < N; ++q) off += a[p][q] * a[p][q];
+            }
+            if (off <= 1e-24 * diag) break;
+
+            for (int p = 0; p < N; ++p)
+            {
+                for (int q = p + 1; q < N; ++q)
+                {
+                    if (a[p][q] == 0.0) continue;
+                    const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0)
+                        / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0);
+                    const double s = t * c;
+                    for (int k = 0; k < N; ++k)
+                    {
+                        const double akp = a[k][p], akq = a[k][q];
+                        a[k][p] = c * akp - s * akq;
+                        a[k][q] = s * akp + c * akq;
+                    }
+                    for (int k = 0; k < N; ++k)
+                    {
+                        const double apk = a[p][k], aqk = a[q][k];
+                        a[p][k] = c * apk - s * aqk;
+                        a[q][k] = s * apk + c * aqk;
+                    }
+                    for (int k = 0; k < N; ++k)
+                    {
+                        const double vkp = v[k][p], vkq = v[k][q];
+                        v[k][p] = c * vkp - s * vkq;
+                        v[k][q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void arm::palm_jacobian(const Pose & pose, Jacobian & j)
+{
+    const float link_y = cfg::JOINT_R + cfg::LINK_GAP();
+    const float elbow_y = link_y + cfg::ARM_L - cfg::LINK_GAP();
+    const float palm_y = link_y + cfg::ARM_L + 0.5f * cfg::PALM_SIZE;
+
+    // the same rotation sequence forward_kinematics() applies
+    const Mat4 s1 = Mat4::rotate(pose.shoulder_pitch, 1.0f, 0.0f, 0.0f);
+    const Mat4 s2 = s1 * Mat4::rotate(pose.shoulder_yaw, 0.0f, 1.0f, 0.0f);
+    const Mat4 s3 = s2 * Mat4::rotate(pose.shoulder_roll, 0.0f, 0.0f, 1.0f);
+    const Mat4 e1 = s3 * Mat4::rotate(pose.elbow_pitch, 1.0f, 0.0f, 0.0f);
+    const Mat4 e2 = e1 * Mat4::rotate(pose.elbow_yaw, 0.0f, 1.0f, 0.0f);
+    const Mat4 e3 = e2 * Mat4::rotate(pose.elbow_roll, 0.0f, 0.0f, 1.0f);
+
+    const Vec3 elbow = s3.vector(Vec3(0.0f, elbow_y, 0.0f));
+    const Vec3 palm = elbow + e3.vector(Vec3(0.0f, palm_y, 0.0f));
+
+    const Vec3 axis[NUM_JOINTS] =
+    {
+        Vec3(1.0f, 0.0f, 0.0f), s1.yaxis(), s2.zaxis(),
+        s3.xaxis(), e1.yaxis(), e2.zaxis(),
+    };
+    for (int i = 0; i < NUM_JOINTS; ++i)
+    {
+        const Vec3 o = (i < 3 ? Vec3() : elbow);
+        const Vec3 v = cross(axis[i], palm - o);
+        j.m[0][i] = v.x;
+        j.m[1][i] = v.y;
+        j.m[2][i] = v.z;
+        j.m[3][i] = axis[i].x;
+        j.m[4][i] = axis[i].y;
+        j.m[5][i] = axis[i].z;
+    }
+}
+
+void arm::manipulability(const Pose & pose, const Jacobian & j,
+                         Manipulability & m)
+{
+    const int N = NUM_JOINTS;
+
+    // singular values: eigenvalues of Js^T Js, Js with scaled linear rows
+    double js[6][N];
+    for (int r = 0; r < 6; ++r)
+        for (int c = 0; c < N; ++c)
+            js[r][c] = j.m[r][c] * (r < 3 ? 1.0 / cfg::JACOBIAN_LENGTH : 1.0);
+
+    double a[N][N], v[N][N];
+    for (int p = 0; p < N; ++p)
+    {
+        for (int q = p; q < N; ++q)
+        {
+            double s = 0.0;
+            for (int r = 0; r < 6; ++r) s += js[r][p] * js[r][q];
+            a[p][q] = a[q][p] = s;
+        }
+    }
+    jacobi< N >(a, v);
+
+    for (int i = 0; i < N; ++i)
+        m.sigma[i] = float(std::sqrt(a[i][i] > 0.0 ? a[i][i] : 0.0));
+    for (int i = 1; i < N; ++i)             // few enough for insertion sort
+        for (int k = i; k > 0 && m.sigma[k] > m.sigma[k - 1]; --k)
+            std::swap(m.sigma[k], m.sigma[k - 1]);
+
+    m.w = 1.0f;
+    for (int i = 0; i < JACOBIAN_RANK; ++i) m.w *= m.sigma[i];
+    const float lo = m.sigma[JACOBIAN_RANK - 1], hi = m.sigma[0];
+    m.condition = lo > 1e-6f * hi ? hi / lo
+                                  : std::numeric_limits< float >::infinity();
+    m.shoulder_gimbal_lock =
+        std::fabs(std::cos(mygllib::deg2rad(pose.shoulder_yaw))) < cfg::GIMBAL_COS;
+    m.elbow_gimbal_lock =
+        std::fabs(std::cos(mygllib::deg2rad(pose.elbow_yaw))) < cfg::GIMBAL_COS;
+
+    // linear velocity ellipsoid: eigen-decomposition of J_v J_v^T
+    double b[3][3], u[3][3];
+    for (int p = 0; p < 3; ++p)
+    {
+        for (int q = p; q < 3; ++q)
+        {
+            double s = 0.0;
+            for (int c = 0; c < N; ++c) s += double(j.m[p][c]) * j.m[q][c];
+            b[p][q] = b[q][p] = s;
+        }
+    }
+    jacobi< 3 >(b, u);
+    for (int k = 0; k < 3; ++k)
+    {
+        m.ellipsoid_axis[k] = Vec3(u[0][k], u[1][k], u[2][k]);
+        m.ellipsoid_radius[k] = float(std::sqrt(b[k][k] > 0.0 ? b[k][k] : 0.0));
+    }
+
+    const float * r = m.ellipsoid_radius;
+    const float rlo = std::min(std::min(r[0], r[1]), r[2]);
+    const float rhi = std::max(std::max(r[0], r[1]), r[2]);
+    m.position_w = r[0] * r[1] * r[2];
+    m.position_condition = rlo > 1e-6f * rhi
+        ? rhi / rlo : std::numeric_limits< float >::infinity();
+
+    m.near_singular = lo < cfg::SINGULAR_WARN * hi
+                   || rlo < cfg::SINGULAR_WARN * rhi;
+}
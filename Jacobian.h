@@ -0,0 +1,88 @@
+// File  : Jacobian.h
+// Author: Cole Schwandt
+
+#ifndef JACOBIAN_H
+#define JACOBIAN_H
+
+#include "Kinematics.h"
+
+namespace cfg
+{
+    // -------- singularity monitor --------
+    // Linear rows are divided by this length (about the arm's reach) so
+    // they are commensurate with the angular rows.
+    const GLfloat JACOBIAN_LENGTH = 6.0f;
+    // warn when sigma_min / sigma_max drops below this
+    const GLfloat SINGULAR_WARN = 0.05f;
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // Jacobian
+    //
+    // Palm twist per joint rate: rows vx vy vz (scene units/rad) and
+    // wx wy wz (rad/rad) in world coordinates, one column per joint.
+    // Every joint is revolute, so column i is (a_i x (p - o_i), a_i) for
+    // joint axis a_i through o_i and palm center p.
+    //-------------------------------------------------------------------------
+    struct Jacobian
+    {
+        float m[6][NUM_JOINTS];
+    };
+
+    void palm_jacobian(const Pose & pose, Jacobian & j);
+
+    // Both the shoulder and the elbow are spherical (three concurrent
+    // axes), so spinning the upper arm about its own axis can always be
+    // undone at the elbow: J has a one-dimensional null space in every
+    // pose. Only the other five singular values say anything about the
+    // pose.
+    const int JACOBIAN_RANK = NUM_JOINTS - 1;
+
+    //-------------------------------------------------------------------------
+    // Manipulability
+    //
+    // Singular values of the Jacobian (linear rows scaled by
+    // 1/JACOBIAN_LENGTH), Yoshikawa's measure w (product of the
+    // JACOBIAN_RANK nonzero ones, i.e. sqrt of the pseudo-determinant of
+    // J J^T) and the condition number over the same ones.
+    //
+    // The same for the linear rows alone: ellipsoid_axis/radius describe
+    // the palm's velocity ellipsoid {J_v qd : |qd| = 1} in scene units.
+    // A straight elbow flattens it (no radial motion) without changing
+    // the rank of the full J, so both are checked.
+    //-------------------------------------------------------------------------
+    struct Manipulability
+    {
+        float sigma[NUM_JOINTS];       // descending; the last is always ~0
+        float w;
+        float condition;               // sigma[0] / sigma[RANK - 1], inf if 0
+        float position_w;              // product of ellipsoid radii
+        float position_condition;      // longest / shortest radius
+        bool  near_singular;           // either 1 / condition < SINGULAR_WARN
+        bool  shoulder_gimbal_lock;    // shoulder yaw near +-90
+        bool  elbow_gimbal_lock;       // elbow yaw near +-90
+
+        Vec3  ellipsoid_axis[3];
+        float ellipsoid_radius[3];
+    };
+
+    //-------------------------------------------------------------------------
+    // manipulability
+    //
+    // Fixed-size Jacobi eigen-solves (6x6 and 3x3), no allocation; a few
+    // microseconds, so it can run on every sim tick.
+    //
+    // USAGE:
+    // arm::Jacobian j;
+    // arm::Manipulability m;
+    // arm::palm_jacobian(pose, j);
+    // arm::manipulability(pose, j, m);
+    // if (m.near_singular) ...
+    //-------------------------------------------------------------------------
+    void manipulability(const Pose & pose, const Jacobian & j,
+                        Manipulability & m);
+}
+
+#endif
@@ -5,9 +5,13 @@
 #include "View.h"
 #include "SingletonView.h"
 #include "Keyboard.h"
+#include "Latency.h"
+#include "Framebuffer.h"
+#include "Windows.h"
 
 void mygllib::Keyboard::keyboard(unsigned char key, int w, int h)
 {
+    InputLatency::input(InputLatency::KEY);
     mygllib::View & view = *(mygllib::SingletonView::getInstance());
 
     switch (key)
@@ -40,6 +44,7 @@ void mygllib::Keyboard::keyboard(unsigned char key, int w, int h)
 
     view.set_projection();
     view.lookat();
+    StaticLayer::invalidate_all();
     //light.set_position();
-    glutPostRedisplay();
+    mygllib::Windows::redisplay();      // only this window's camera moved
 }
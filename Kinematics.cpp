@@ -0,0 +1,140 @@
+// File  : Kinematics.cpp
+// Author: Cole Schwandt
+
+#include "Kinematics.h"
+
+namespace
+{
+    const FingerAngles OPEN_F[arm::NUM_FINGERS]   = { OPEN_F0, OPEN_F1, OPEN_F2 };
+    const FingerAngles CLOSED_F[arm::NUM_FINGERS] = { CLOSED_F0, CLOSED_F1, CLOSED_F2 };
+
+    template < typename Blend >
+    arm::Pose blend(const arm::Pose & a, const arm::Pose & b, float t,
+                    Blend rotation)
+    {
+        arm::Pose p = a;                    // Euler angles near a's
+        arm::set_shoulder_rotation(p, rotation(arm::shoulder_rotation(a),
+                                               arm::shoulder_rotation(b), t));
+        arm::set_elbow_rotation(p, rotation(arm::elbow_rotation(a),
+                                            arm::elbow_rotation(b), t));
+        p.grip = lerp(a.grip, b.grip, t);
+        p.xb = lerp(a.xb, b.xb, t);
+        p.yb = lerp(a.yb, b.yb, t);
+        p.zb = lerp(a.zb, b.zb, t);
+        return p;
+    }
+}
+
+void arm::joint_angles(const Pose & pose, float q[NUM_JOINTS])
+{
+    q[0] = mygllib::deg2rad(pose.shoulder_pitch);
+    q[1] = mygllib::deg2rad(pose.shoulder_yaw);
+    q[2] = mygllib::deg2rad(pose.shoulder_roll);
+    q[3] = mygllib::deg2rad(pose.elbow_pitch);
+    q[4] = mygllib::deg2rad(pose.elbow_yaw);
+    q[5] = mygllib::deg2rad(pose.elbow_roll);
+}
+
+arm::Quat arm::shoulder_rotation(const Pose & pose)
+{
+    return Quat::rotate_xyz(pose.shoulder_pitch, pose.shoulder_yaw,
+                            pose.shoulder_roll);
+}
+
+arm::Quat arm::elbow_rotation(const Pose & pose)
+{
+    return Quat::rotate_xyz(pose.elbow_pitch, pose.elbow_yaw, pose.elbow_roll);
+}
+
+void arm::set_shoulder_rotation(Pose & pose, const Quat & q)
+{
+    float a[3] = { pose.shoulder_pitch, pose.shoulder_yaw, pose.shoulder_roll };
+    mygllib::euler_xyz(q, a);
+    pose.shoulder_pitch = a[0];
+    pose.shoulder_yaw = a[1];
+    pose.shoulder_roll = a[2];
+}
+
+void arm::set_elbow_rotation(Pose & pose, const Quat & q)
+{
+    float a[3] = { pose.elbow_pitch, pose.elbow_yaw, pose.elbow_roll };
+    mygllib::euler_xyz(q, a);
+    pose.elbow_pitch = a[0];
+    pose.elbow_yaw = a[1];
+    pose.elbow_roll = a[2];
+}
+
+arm::Pose arm::slerp(const Pose & a, const Pose & b, float t)
+{
+    return blend(a, b, t, mygllib::slerp);
+}
+
+arm::Pose arm::nlerp(const Pose & a, const Pose & b, float t)
+{
+    return blend(a, b, t, mygllib::nlerp);
+}
+
+arm::Vec3 arm::finger_mount(int i)
+{
+    switch (i)
+    {
+        case 0:  return Vec3(+cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, 0.0f);
+        case 1:  return Vec3(-cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, +cfg::FINGER_OFFSET_Z);
+        default: return Vec3(-cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, -cfg::FINGER_OFFSET_Z);
+    }
+}
+
+FingerAngles arm::finger_angles(int i, GLfloat grip)
+{
+    return mix(OPEN_F[i], CLOSED_F[i], -grip);
+}
+
+FingerAngles arm::finger_angles(int i, GLfloat proximal, GLfloat distal)
+{
+    FingerAngles a;
+    a.baseZ  = lerp(OPEN_F[i].baseZ,  CLOSED_F[i].baseZ,  -proximal);
+    a.jointZ = lerp(OPEN_F[i].jointZ, CLOSED_F[i].jointZ, -distal);
+    a.tipY   = lerp(OPEN_F[i].tipY,   CLOSED_F[i].tipY,   -distal);
+    return a;
+}
+
+void arm::finger_kinematics(const Mat4 & palm, int i, const FingerAngles & a,
+                            Mat4 & knuckle, Mat4 & middle, Mat4 & distal,
+                            Mat4 & fingertip)
+{
+    const Vec3 p = finger_mount(i);
+    knuckle = palm * Mat4::translate(p.x, p.y, p.z)
+                   * Mat4::rotate(a.baseZ, 0.0f, 0.0f, 1.0f);
+    middle = knuckle * Mat4::translate(0.0f, cfg::FINGER_DIGIT_L, 0.0f)
+                     * Mat4::rotate(a.jointZ, 0.0f, 0.0f, 1.0f);
+    distal = middle * Mat4::rotate(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f)
+                    * Mat4::rotate(a.tipY, 0.0f, 1.0f, 0.0f);
+    fingertip = distal * Mat4::translate(0.0f, 0.0f, cfg::FINGER_DIGIT_L);
+}
+
+void arm::forward_kinematics(const Pose & pose, Frames & f,
+                             const FingerAngles * fingers)
+{
+    f.shoulder = Mat4::rotate(shoulder_rotation(pose));
+
+    f.upper_arm = f.shoulder
+                * Mat4::translate(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
+
+    f.elbow = f.upper_arm
+            * Mat4::translate(0.0f, cfg::ARM_L - cfg::LINK_GAP(), 0.0f)
+            * Mat4::rotate(elbow_rotation(pose));
+
+    f.forearm = f.elbow
+              * Mat4::translate(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
+
+    f.palm = f.forearm
+           * Mat4::translate(0.0f, cfg::ARM_L + 0.5f * cfg::PALM_SIZE, 0.0f);
+
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        finger_kinematics(f.palm, i,
+                          fingers ? fingers[i] : finger_angles(i, pose.grip),
+                          f.knuckle[i], f.middle[i], f.distal[i],
+                          f.fingertip[i]);
+    }
+}
@@ -0,0 +1,106 @@
+// File  : Kinematics.h
+// Author: Cole Schwandt
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include "Math3d.h"
+#include "ArmConfig.h"
+
+namespace arm
+{
+    using mygllib::Vec3;
+    using mygllib::Mat4;
+    using mygllib::Quat;
+
+    const int NUM_FINGERS = 3;
+
+    // shoulder pitch/yaw/roll, elbow pitch/yaw/roll (the glRotatef order)
+    const int NUM_JOINTS = 6;
+
+    //-------------------------------------------------------------------------
+    // Pose
+    //
+    // Everything display() needs to draw one arm: the six joint angles in
+    // degrees, the grip and the base position.
+    //-------------------------------------------------------------------------
+    struct Pose
+    {
+        GLfloat shoulder_pitch, shoulder_yaw, shoulder_roll;
+        GLfloat elbow_pitch, elbow_yaw, elbow_roll;
+        GLfloat grip;
+        GLfloat xb, yb, zb;
+    };
+
+    // Joint angles of a pose, in radians, in joint order.
+    void joint_angles(const Pose & pose, float q[NUM_JOINTS]);
+
+    //-------------------------------------------------------------------------
+    // Ball joints as quaternions
+    //
+    // The shoulder and elbow are each one orientation; the Euler angles in
+    // Pose are how they are shown, commanded and stored. The setters pick
+    // the Euler triple closest to the one already in the pose.
+    //
+    // slerp/nlerp blend two poses joint by joint along the shorter arc of
+    // each ball joint (grip and base lerp). Blending the Euler angles
+    // instead swings the arm through poses that are in neither end, and
+    // stalls at gimbal lock.
+    //
+    // USAGE:
+    // arm::Quat s = arm::shoulder_rotation(pose) * arm::Quat::rotate(2, 1, 0, 0);
+    // arm::set_shoulder_rotation(pose, s);       // 2 degrees about its own X
+    // arm::Pose mid = arm::slerp(from, to, 0.5f);
+    //-------------------------------------------------------------------------
+    Quat shoulder_rotation(const Pose & pose);
+    Quat elbow_rotation(const Pose & pose);
+    void set_shoulder_rotation(Pose & pose, const Quat & q);
+    void set_elbow_rotation(Pose & pose, const Quat & q);
+
+    Pose slerp(const Pose & a, const Pose & b, float t);
+    Pose nlerp(const Pose & a, const Pose & b, float t);
+
+    // Where finger i sits on the palm, in palm coordinates.
+    Vec3 finger_mount(int i);
+
+    // Finger i's angles for a given grip. Same blend display() draws.
+    FingerAngles finger_angles(int i, GLfloat grip);
+
+    // Same blend, but with the two phalanges closed by different amounts:
+    // proximal drives the base bend, distal the middle joint and tip twist.
+    // finger_angles(i, g) == finger_angles(i, g, g).
+    FingerAngles finger_angles(int i, GLfloat proximal, GLfloat distal);
+
+    //-------------------------------------------------------------------------
+    // Frames
+    //
+    // World transforms of every part, built with the same sequence of
+    // translate/rotate calls that display() issues on the modelview stack
+    // (without the camera). Link frames have the link running along +Y from
+    // the frame origin; distal phalanges run along +Z (see draw_finger()).
+    //-------------------------------------------------------------------------
+    struct Frames
+    {
+        Mat4 shoulder;               // shoulder joint sphere
+        Mat4 upper_arm;              // base of upper arm cylinder
+        Mat4 elbow;                  // elbow joint sphere
+        Mat4 forearm;                // base of forearm cylinder
+        Mat4 palm;                   // center of palm cube
+        Mat4 knuckle[NUM_FINGERS];   // first finger joint, after base bend
+        Mat4 middle[NUM_FINGERS];    // middle finger joint
+        Mat4 distal[NUM_FINGERS];    // base of tip phalanx (+Z)
+        Mat4 fingertip[NUM_FINGERS]; // end of tip phalanx
+    };
+
+    // fingers, if given, overrides the grip blend (e.g. with the angles a
+    // grasp stopped at); one entry per finger.
+    void forward_kinematics(const Pose & pose, Frames & f,
+                            const FingerAngles * fingers=NULL);
+
+    // Only the finger part, for callers that move fingers on a fixed palm.
+    void finger_kinematics(const Mat4 & palm, int i, const FingerAngles & a,
+                           Mat4 & knuckle, Mat4 & middle, Mat4 & distal,
+                           Mat4 & fingertip);
+}
+
+#endif
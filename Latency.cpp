@@ -0,0 +1,109 @@
+// File  : Latency.cpp
+// Author: Cole Schwandt
+
+#include <iomanip>
+#include <GL/freeglut.h>
+#include "Clock.h"
+#include "Latency.h"
+
+std::vector< mygllib::InputLatency::Event > mygllib::InputLatency::pending_;
+std::vector< mygllib::InputLatency::Event > mygllib::InputLatency::drawn_;
+int64_t mygllib::InputLatency::frame_ns_ = 0;
+bool mygllib::InputLatency::finish_ = false;
+FILE * mygllib::InputLatency::csv_ = NULL;
+uint64_t mygllib::InputLatency::count_ = 0;
+double mygllib::InputLatency::last_ms_ = 0.0;
+double mygllib::InputLatency::sum_ms_ = 0.0;
+double mygllib::InputLatency::max_ms_ = 0.0;
+uint64_t mygllib::InputLatency::buckets_[BUCKETS] = { 0 };
+
+namespace
+{
+    const char * source_name(mygllib::InputLatency::Source s)
+    {
+        switch (s)
+        {
+            case mygllib::InputLatency::KEY:     return "key";
+            case mygllib::InputLatency::SPECIAL: return "special";
+            default:                             return "mouse";
+        }
+    }
+}
+
+void mygllib::InputLatency::input(Source source)
+{
+    const Event e = { source, now_ns() };
+    pending_.push_back(e);
+}
+
+void mygllib::InputLatency::frame()
+{
+    frame_ns_ = now_ns();
+    drawn_.insert(drawn_.end(), pending_.begin(), pending_.end());
+    pending_.clear();
+}
+
+void mygllib::InputLatency::presented()
+{
+    if (drawn_.empty()) return;
+    const int64_t swap_ns = now_ns();
+    int64_t finish_ns = 0;
+    if (finish_)
+    {
+        glFinish();
+        finish_ns = now_ns();
+    }
+
+    for (size_t i = 0; i < drawn_.size(); ++i)
+    {
+        const Event & e = drawn_[i];
+        const double ms = ns_to_ms((finish_ ? finish_ns : swap_ns) - e.input_ns);
+        int b = 0;
+        while (b < BUCKETS - 1 && ms >= bucket_ms(b)) ++b;
+        ++buckets_[b];
+        ++count_;
+        last_ms_ = ms;
+        sum_ms_ += ms;
+        if (ms > max_ms_) max_ms_ = ms;
+
+        if (!csv_) continue;
+        fprintf(csv_, "%llu,%s,%lld,%.3f,%.3f,", (unsigned long long) count_,
+                source_name(e.source), (long long) e.input_ns,
+                ns_to_ms(frame_ns_ - e.input_ns), ns_to_ms(swap_ns - e.input_ns));
+        if (finish_) fprintf(csv_, "%.3f", ns_to_ms(finish_ns - e.input_ns));
+        fputc('\n', csv_);
+    }
+    drawn_.clear();
+}
+
+bool mygllib::InputLatency::open_csv(const char * path)
+{
+    close_csv();
+    csv_ = fopen(path, "w");
+    if (!csv_)
+    {
+        std::cout << "latency: cannot write " << path << std::endl;
+        return false;
+    }
+    fprintf(csv_, "event,source,input_ns,to_frame_ms,to_swap_ms,to_finish_ms\n");
+    return true;
+}
+
+void mygllib::InputLatency::close_csv()
+{
+    if (!csv_) return;
+    fclose(csv_);
+    csv_ = NULL;
+}
+
+void mygllib::InputLatency::report(std::ostream & out)
+{
+    out << "input to " << (finish_ ? "glFinish" : "swap") << ": " << count_
+        << " events, mean " << mean_ms() << " ms, max " << max_ms_ << " ms\n";
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        if (i < BUCKETS - 1) out << "   < " << std::setw(2) << bucket_ms(i);
+        else                 out << "  >= " << std::setw(2) << bucket_ms(i - 1);
+        out << " ms  " << buckets_[i] << '\n';
+    }
+}
@@ -0,0 +1,91 @@
+// File  : Latency.h
+// Author: Cole Schwandt
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // InputLatency
+    //
+    // Input-to-photon latency: from an operator's key press or drag to the
+    // first presented frame that shows it. Input handlers call input() on entry,
+    // which stamps the event. A handler changes the sim state (joints,
+    // grip, camera) before it returns, so the stamp waits with that state
+    // until the next frame is drawn from it: the display callback calls
+    // frame() before it draws, which hands it the waiting stamps, and
+    // presented() once glutSwapBuffers() has returned.
+    //
+    // The swap only queues the frame, so with finish(true) presented()
+    // also calls glFinish() and times when it returns, which is closer to
+    // the pixels being out. Latencies are then taken to the finish,
+    // otherwise to the swap.
+    //
+    // Every event goes into a histogram with power-of-two buckets
+    // (under 1 ms, 1-2 ms, ..., 64 ms and over) and, with open_csv(), one
+    // CSV row per event.
+    //
+    // USAGE:
+    // void keyboard(unsigned char key, int x, int y)
+    // {
+    //     mygllib::InputLatency::input(mygllib::InputLatency::KEY);
+    //     ...
+    // }
+    // void display()
+    // {
+    //     mygllib::InputLatency::frame();
+    //     ... draw ...
+    //     glutSwapBuffers();
+    //     mygllib::InputLatency::presented();
+    // }
+    //-------------------------------------------------------------------------
+    class InputLatency
+    {
+    public:
+        enum Source { KEY, SPECIAL, MOUSE };
+        static const int BUCKETS = 8;
+
+        static void input(Source source);
+        static void frame();
+        static void presented();
+
+        static void finish(bool on) { finish_ = on; }
+        static bool open_csv(const char * path);
+        static void close_csv();
+
+        // all in ms, over every event so far
+        static uint64_t count()      { return count_; }
+        static double last_ms()      { return last_ms_; }
+        static double mean_ms()      { return count_ ? sum_ms_ / count_ : 0.0; }
+        static double max_ms()       { return max_ms_; }
+        static uint64_t bucket(int i) { return buckets_[i]; }
+        static double bucket_ms(int i) { return double(1 << i); } // upper edge
+
+        static void report(std::ostream & out);
+
+    private:
+        struct Event
+        {
+            Source source;
+            int64_t input_ns;
+        };
+
+        static std::vector< Event > pending_;   // waiting for a frame
+        static std::vector< Event > drawn_;     // in the frame being drawn
+        static int64_t frame_ns_;
+        static bool finish_;
+        static FILE * csv_;
+
+        static uint64_t count_;
+        static double last_ms_, sum_ms_, max_ms_;
+        static uint64_t buckets_[BUCKETS];
+    };
+}
+
+#endif
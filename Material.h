@@ -73,31 +73,31 @@ namespace mygllib
         GLenum face_;
     };
     
-    const int         Material::EMERALD =  0;
-    const int            Material::JADE =  1;
-    const int        Material::OBSIDIAN =  2;
-    const int           Material::PEARL =  3;
-    const int            Material::RUBY =  4;
-    const int       Material::TURQUOISE =  5;
-    const int           Material::BRASS =  6;
-    const int          Material::BRONZE =  7;
-    const int          Material::CHROME =  8;
-    const int          Material::COPPER =  9;
-    const int            Material::GOLD = 10;
-    const int          Material::SILVER = 11;
-    const int   Material::BLACK_PLASTIC = 12;
-    const int    Material::CYAN_PLASTIC = 13;
-    const int   Material::GREEN_PLASTIC = 14;
-    const int     Material::RED_PLASTIC = 15;
-    const int   Material::WHITE_PLASTIC = 16;
-    const int  Material::YELLOW_PLASTIC = 17;
-    const int    Material::BLACK_RUBBER = 18;
-    const int     Material::CYAN_RUBBER = 19;
-    const int    Material::GREEN_RUBBER = 20;
-    const int      Material::RED_RUBBER = 21;
-    const int    Material::WHITE_RUBBER = 22;
-    const int   Material::YELLOW_RUBBER = 23;
-    float Material::material[] = {
+    inline const int         Material::EMERALD =  0;
+    inline const int            Material::JADE =  1;
+    inline const int        Material::OBSIDIAN =  2;
+    inline const int           Material::PEARL =  3;
+    inline const int            Material::RUBY =  4;
+    inline const int       Material::TURQUOISE =  5;
+    inline const int           Material::BRASS =  6;
+    inline const int          Material::BRONZE =  7;
+    inline const int          Material::CHROME =  8;
+    inline const int          Material::COPPER =  9;
+    inline const int            Material::GOLD = 10;
+    inline const int          Material::SILVER = 11;
+    inline const int   Material::BLACK_PLASTIC = 12;
+    inline const int    Material::CYAN_PLASTIC = 13;
+    inline const int   Material::GREEN_PLASTIC = 14;
+    inline const int     Material::RED_PLASTIC = 15;
+    inline const int   Material::WHITE_PLASTIC = 16;
+    inline const int  Material::YELLOW_PLASTIC = 17;
+    inline const int    Material::BLACK_RUBBER = 18;
+    inline const int     Material::CYAN_RUBBER = 19;
+    inline const int    Material::GREEN_RUBBER = 20;
+    inline const int      Material::RED_RUBBER = 21;
+    inline const int    Material::WHITE_RUBBER = 22;
+    inline const int   Material::YELLOW_RUBBER = 23;
+    inline float Material::material[] = {
   0.0215,   0.1745,   0.0215, 1,  0.07568,    0.61424,    0.07568, 1,      0.633,   0.727811,      0.633, 1,        0.6 * 128,
    0.135,   0.2225,   0.1575, 1,     0.54,       0.89,       0.63, 1,   0.316228,   0.316228,   0.316228, 1,        0.1 * 128,
  0.05375,     0.05,  0.06625, 1,  0.18275,       0.17,    0.22525, 1,   0.332741,   0.328634,   0.346435, 1,        0.3 * 128,
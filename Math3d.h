@@ -0,0 +1,295 @@
+// File  : Math3d.h
+// Author: Cole Schwandt
+
+#ifndef MATH3D_H
+#define MATH3D_H
+
+#include <cmath>
+
+namespace mygllib
+{
+    const float PI = 3.14159265358979f;
+
+    inline float deg2rad(float d) { return d * (PI / 180.0f); }
+    inline float rad2deg(float r) { return r * (180.0f / PI); }
+
+    //-------------------------------------------------------------------------
+    // Vec3
+    //-------------------------------------------------------------------------
+    struct Vec3
+    {
+        float x, y, z;
+
+        Vec3(float x_=0, float y_=0, float z_=0)
+            : x(x_), y(y_), z(z_)
+        {}
+
+        Vec3 operator+(const Vec3 & v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
+        Vec3 operator-(const Vec3 & v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
+        Vec3 operator*(float s) const        { return Vec3(x * s, y * s, z * s); }
+        Vec3 operator-() const               { return Vec3(-x, -y, -z); }
+        Vec3 & operator+=(const Vec3 & v)    { x += v.x; y += v.y; z += v.z; return *this; }
+        Vec3 & operator-=(const Vec3 & v)    { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    };
+
+    inline float dot(const Vec3 & a, const Vec3 & b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline Vec3 cross(const Vec3 & a, const Vec3 & b)
+    {
+        return Vec3(a.y * b.z - a.z * b.y,
+                    a.z * b.x - a.x * b.z,
+                    a.x * b.y - a.y * b.x);
+    }
+
+    inline float length2(const Vec3 & v) { return dot(v, v); }
+    inline float length(const Vec3 & v)  { return std::sqrt(dot(v, v)); }
+
+    inline Vec3 normalize(const Vec3 & v)
+    {
+        const float l = length(v);
+        return l > 0 ? v * (1.0f / l) : v;
+    }
+
+    //-------------------------------------------------------------------------
+    // Quat
+    //
+    // Unit quaternion w + xi + yj + zk for a rotation. rotate() and
+    // rotate_xyz() match glRotatef(), and q * r applies r first, like
+    // multiplying the matrices, so
+    //
+    //     glRotatef(a, 1, 0, 0); glRotatef(b, 0, 1, 0);
+    //
+    // is Mat4::rotate(Quat::rotate(a, 1, 0, 0) * Quat::rotate(b, 0, 1, 0)).
+    // Composing and turning a quaternion into a matrix need no trig.
+    //-------------------------------------------------------------------------
+    struct Quat
+    {
+        float w, x, y, z;
+
+        Quat(float w_=1, float x_=0, float y_=0, float z_=0)
+            : w(w_), x(x_), y(y_), z(z_)
+        {}
+
+        // angle in degrees about a unit axis
+        static Quat rotate(float deg, float x, float y, float z)
+        {
+            const float h = 0.5f * deg2rad(deg);
+            const float s = std::sin(h);
+            return Quat(std::cos(h), s * x, s * y, s * z);
+        }
+
+        // rotate(a, X) * rotate(b, Y) * rotate(c, Z), degrees: the Euler
+        // triple the joints are displayed and commanded in
+        static Quat rotate_xyz(float a, float b, float c)
+        {
+            const float ha = 0.5f * deg2rad(a), hb = 0.5f * deg2rad(b),
+                        hc = 0.5f * deg2rad(c);
+            const float cx = std::cos(ha), sx = std::sin(ha);
+            const float cy = std::cos(hb), sy = std::sin(hb);
+            const float cz = std::cos(hc), sz = std::sin(hc);
+            return Quat(cx * cy * cz - sx * sy * sz,
+                        sx * cy * cz + cx * sy * sz,
+                        cx * sy * cz - sx * cy * sz,
+                        cx * cy * sz + sx * sy * cz);
+        }
+
+        Quat operator*(const Quat & q) const
+        {
+            return Quat(w * q.w - x * q.x - y * q.y - z * q.z,
+                        w * q.x + x * q.w + y * q.z - z * q.y,
+                        w * q.y - x * q.z + y * q.w + z * q.x,
+                        w * q.z + x * q.y - y * q.x + z * q.w);
+        }
+
+        Quat conjugate() const { return Quat(w, -x, -y, -z); }
+    };
+
+    inline float dot(const Quat & a, const Quat & b)
+    {
+        return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline Quat normalize(const Quat & q)
+    {
+        const float l = std::sqrt(dot(q, q));
+        return l > 0 ? Quat(q.w / l, q.x / l, q.y / l, q.z / l) : Quat();
+    }
+
+    // q and -q are the same rotation: both blends take the shorter way.
+    // nlerp is a normalized lerp: exact ends, constant-speed only for
+    // small angles, no trig.
+    inline Quat nlerp(const Quat & a, const Quat & b, float t)
+    {
+        const float s = dot(a, b) < 0 ? -t : t;
+        return normalize(Quat(a.w + (s * b.w - t * a.w), a.x + (s * b.x - t * a.x),
+                              a.y + (s * b.y - t * a.y), a.z + (s * b.z - t * a.z)));
+    }
+
+    // constant angular speed along the great arc
+    inline Quat slerp(const Quat & a, const Quat & b, float t)
+    {
+        float d = dot(a, b);
+        const float sign = d < 0 ? -1.0f : 1.0f;
+        d *= sign;
+        if (d > 0.9995f) return nlerp(a, b, t);     // sin(theta) ~ 0
+        const float theta = std::acos(d);
+        const float s = 1.0f / std::sin(theta);
+        const float ka = std::sin((1.0f - t) * theta) * s;
+        const float kb = std::sin(t * theta) * s * sign;
+        return Quat(ka * a.w + kb * b.w, ka * a.x + kb * b.x,
+                    ka * a.y + kb * b.y, ka * a.z + kb * b.z);
+    }
+
+    // x + k 360 closest to near
+    inline float unwrap_deg(float x, float near)
+    {
+        return x + 360.0f * std::floor((near - x) / 360.0f + 0.5f);
+    }
+
+    //-------------------------------------------------------------------------
+    // Inverse of Quat::rotate_xyz(). Every rotation has two Euler triples,
+    // (a, b, c) and (a + 180, 180 - b, c + 180), plus multiples of 360; the
+    // one closest to angle[] replaces it, so angles shown for a rotation
+    // that changes a little never jump.
+    //-------------------------------------------------------------------------
+    inline void euler_xyz(const Quat & q, float angle[3])
+    {
+        const float sb = 2.0f * (q.x * q.z + q.w * q.y);
+        const float b = rad2deg(std::asin(sb < -1.0f ? -1.0f : (sb > 1.0f ? 1.0f : sb)));
+        float a, c;
+        if (std::fabs(sb) < 0.9999f)
+        {
+            a = rad2deg(std::atan2(2.0f * (q.w * q.x - q.y * q.z),
+                                   1.0f - 2.0f * (q.x * q.x + q.y * q.y)));
+            c = rad2deg(std::atan2(2.0f * (q.w * q.z - q.x * q.y),
+                                   1.0f - 2.0f * (q.y * q.y + q.z * q.z)));
+        }
+        else
+        {
+            // gimbal lock: only a +- c is defined; keep a
+            a = angle[0];
+            const Quat rest = Quat::rotate_xyz(a, b, 0.0f).conjugate() * q;
+            c = rad2deg(2.0f * std::atan2(rest.z, rest.w));
+        }
+
+        const float cand[2][3] = { { a, b, c },
+                                   { a + 180.0f, 180.0f - b, c + 180.0f } };
+        float e[2][3], cost[2] = { 0.0f, 0.0f };
+        for (int k = 0; k < 2; ++k)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                e[k][i] = unwrap_deg(cand[k][i], angle[i]);
+                cost[k] += std::fabs(e[k][i] - angle[i]);
+            }
+        }
+        const int k = cost[1] < cost[0] ? 1 : 0;
+        for (int i = 0; i < 3; ++i) angle[i] = e[k][i];
+    }
+
+    //-------------------------------------------------------------------------
+    // Mat4
+    //
+    // 4x4 affine transform stored column-major like OpenGL, so m can be
+    // handed straight to glMultMatrixf()/glLoadMatrixf(). translate() and
+    // rotate() build the same matrices as glTranslatef()/glRotatef(), so
+    //
+    //     glRotatef(a, 1, 0, 0); glTranslatef(0, l, 0);
+    //
+    // is M = M * Mat4::rotate(a, 1, 0, 0) * Mat4::translate(0, l, 0).
+    //-------------------------------------------------------------------------
+    struct Mat4
+    {
+        float m[16];
+
+        float & operator()(int row, int col)       { return m[col * 4 + row]; }
+        float   operator()(int row, int col) const { return m[col * 4 + row]; }
+
+        static Mat4 identity()
+        {
+            Mat4 r;
+            for (int i = 0; i < 16; ++i) r.m[i] = (i % 5 == 0 ? 1.0f : 0.0f);
+            return r;
+        }
+
+        static Mat4 translate(float x, float y, float z)
+        {
+            Mat4 r = identity();
+            r.m[12] = x; r.m[13] = y; r.m[14] = z;
+            return r;
+        }
+
+        static Mat4 scale(float x, float y, float z)
+        {
+            Mat4 r = identity();
+            r.m[0] = x; r.m[5] = y; r.m[10] = z;
+            return r;
+        }
+
+        // angle in degrees about a unit axis
+        static Mat4 rotate(float deg, float x, float y, float z)
+        {
+            const float a = deg2rad(deg);
+            const float c = std::cos(a), s = std::sin(a), t = 1.0f - c;
+            Mat4 r = identity();
+            r(0, 0) = t * x * x + c;     r(0, 1) = t * x * y - s * z; r(0, 2) = t * x * z + s * y;
+            r(1, 0) = t * x * y + s * z; r(1, 1) = t * y * y + c;     r(1, 2) = t * y * z - s * x;
+            r(2, 0) = t * x * z - s * y; r(2, 1) = t * y * z + s * x; r(2, 2) = t * z * z + c;
+            return r;
+        }
+
+        // rotation matrix of a unit quaternion
+        static Mat4 rotate(const Quat & q)
+        {
+            const float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z;
+            const float xx = q.x * x2, yy = q.y * y2, zz = q.z * z2;
+            const float xy = q.x * y2, xz = q.x * z2, yz = q.y * z2;
+            const float wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+            Mat4 r = identity();
+            r(0, 0) = 1.0f - yy - zz; r(0, 1) = xy - wz;        r(0, 2) = xz + wy;
+            r(1, 0) = xy + wz;        r(1, 1) = 1.0f - xx - zz; r(1, 2) = yz - wx;
+            r(2, 0) = xz - wy;        r(2, 1) = yz + wx;        r(2, 2) = 1.0f - xx - yy;
+            return r;
+        }
+
+        Mat4 operator*(const Mat4 & b) const
+        {
+            Mat4 r;
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int row = 0; row < 4; ++row)
+                {
+                    r.m[c * 4 + row] = m[row]      * b.m[c * 4]
+                                     + m[4 + row]  * b.m[c * 4 + 1]
+                                     + m[8 + row]  * b.m[c * 4 + 2]
+                                     + m[12 + row] * b.m[c * 4 + 3];
+                }
+            }
+            return r;
+        }
+
+        Vec3 point(const Vec3 & p) const
+        {
+            return Vec3(m[0] * p.x + m[4] * p.y + m[8]  * p.z + m[12],
+                        m[1] * p.x + m[5] * p.y + m[9]  * p.z + m[13],
+                        m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+        }
+
+        Vec3 vector(const Vec3 & v) const
+        {
+            return Vec3(m[0] * v.x + m[4] * v.y + m[8]  * v.z,
+                        m[1] * v.x + m[5] * v.y + m[9]  * v.z,
+                        m[2] * v.x + m[6] * v.y + m[10] * v.z);
+        }
+
+        Vec3 origin() const { return Vec3(m[12], m[13], m[14]); }
+        Vec3 xaxis() const  { return Vec3(m[0], m[1], m[2]); }
+        Vec3 yaxis() const  { return Vec3(m[4], m[5], m[6]); }
+        Vec3 zaxis() const  { return Vec3(m[8], m[9], m[10]); }
+    };
+}
+
+#endif
@@ -0,0 +1,138 @@
+// File  : Mesh.cpp
+// Author: Cole Schwandt
+
+#include <cmath>
+#include "debug.h"
+#include "Mesh.h"
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+}
+
+void mygllib::Mesh::add(GLfloat x, GLfloat y, GLfloat z,
+                        GLfloat nx, GLfloat ny, GLfloat nz)
+{
+    vertices_.push_back(x);  vertices_.push_back(y);  vertices_.push_back(z);
+    normals_.push_back(nx);  normals_.push_back(ny);  normals_.push_back(nz);
+}
+
+mygllib::Mesh mygllib::Mesh::sphere(GLfloat r, GLint slices, GLint stacks)
+{
+    Mesh m;
+    m.vertices_.reserve(slices * stacks * 18);
+    m.normals_.reserve(slices * stacks * 18);
+
+    for (int i = 0; i < stacks; ++i)
+    {
+        const double t0 = PI * i / stacks, t1 = PI * (i + 1) / stacks;
+        for (int j = 0; j < slices; ++j)
+        {
+            const double p0 = 2 * PI * j / slices, p1 = 2 * PI * (j + 1) / slices;
+
+            // unit normals at the quad corners a (t0,p0), b (t1,p0),
+            // c (t1,p1), d (t0,p1)
+            const GLfloat a[3] = { GLfloat(cos(p0) * sin(t0)), GLfloat(sin(p0) * sin(t0)), GLfloat(cos(t0)) };
+            const GLfloat b[3] = { GLfloat(cos(p0) * sin(t1)), GLfloat(sin(p0) * sin(t1)), GLfloat(cos(t1)) };
+            const GLfloat c[3] = { GLfloat(cos(p1) * sin(t1)), GLfloat(sin(p1) * sin(t1)), GLfloat(cos(t1)) };
+            const GLfloat d[3] = { GLfloat(cos(p1) * sin(t0)), GLfloat(sin(p1) * sin(t0)), GLfloat(cos(t0)) };
+
+            if (i != stacks - 1)
+            {
+                m.add(r * a[0], r * a[1], r * a[2], a[0], a[1], a[2]);
+                m.add(r * b[0], r * b[1], r * b[2], b[0], b[1], b[2]);
+                m.add(r * c[0], r * c[1], r * c[2], c[0], c[1], c[2]);
+            }
+            if (i != 0)
+            {
+                m.add(r * a[0], r * a[1], r * a[2], a[0], a[1], a[2]);
+                m.add(r * c[0], r * c[1], r * c[2], c[0], c[1], c[2]);
+                m.add(r * d[0], r * d[1], r * d[2], d[0], d[1], d[2]);
+            }
+        }
+    }
+    return m;
+}
+
+mygllib::Mesh mygllib::Mesh::cylinder(GLfloat r, GLfloat h,
+                                      GLint slices, GLint stacks)
+{
+    Mesh m;
+    m.vertices_.reserve(slices * (stacks + 1) * 18);
+    m.normals_.reserve(slices * (stacks + 1) * 18);
+
+    for (int j = 0; j < slices; ++j)
+    {
+        const double p0 = 2 * PI * j / slices, p1 = 2 * PI * (j + 1) / slices;
+        const GLfloat c0 = cos(p0), s0 = sin(p0), c1 = cos(p1), s1 = sin(p1);
+
+        // side
+        for (int k = 0; k < stacks; ++k)
+        {
+            const GLfloat z0 = h * k / stacks, z1 = h * (k + 1) / stacks;
+            m.add(r * c0, r * s0, z0, c0, s0, 0);
+            m.add(r * c1, r * s1, z0, c1, s1, 0);
+            m.add(r * c1, r * s1, z1, c1, s1, 0);
+            m.add(r * c0, r * s0, z0, c0, s0, 0);
+            m.add(r * c1, r * s1, z1, c1, s1, 0);
+            m.add(r * c0, r * s0, z1, c0, s0, 0);
+        }
+
+        // caps
+        m.add(0, 0, 0, 0, 0, -1);
+        m.add(r * c1, r * s1, 0, 0, 0, -1);
+        m.add(r * c0, r * s0, 0, 0, 0, -1);
+        m.add(0, 0, h, 0, 0, 1);
+        m.add(r * c0, r * s0, h, 0, 0, 1);
+        m.add(r * c1, r * s1, h, 0, 0, 1);
+    }
+    return m;
+}
+
+mygllib::Mesh mygllib::Mesh::cube(GLfloat size)
+{
+    // face normal n with tangents u, v where u x v = n
+    static const GLfloat faces[6][9] = {
+        { +1, 0, 0,   0, 1, 0,   0, 0, 1 },
+        { -1, 0, 0,   0, 0, 1,   0, 1, 0 },
+        { 0, +1, 0,   0, 0, 1,   1, 0, 0 },
+        { 0, -1, 0,   1, 0, 0,   0, 0, 1 },
+        { 0, 0, +1,   1, 0, 0,   0, 1, 0 },
+        { 0, 0, -1,   0, 1, 0,   1, 0, 0 },
+    };
+    static const GLfloat corners[6][2] = {
+        { -1, -1 }, { +1, -1 }, { +1, +1 },
+        { -1, -1 }, { +1, +1 }, { -1, +1 },
+    };
+
+    Mesh m;
+    m.vertices_.reserve(6 * 6 * 3);
+    m.normals_.reserve(6 * 6 * 3);
+    const GLfloat s = 0.5f * size;
+    for (int f = 0; f < 6; ++f)
+    {
+        const GLfloat * n = faces[f];
+        const GLfloat * u = faces[f] + 3;
+        const GLfloat * v = faces[f] + 6;
+        for (int k = 0; k < 6; ++k)
+        {
+            const GLfloat a = corners[k][0], b = corners[k][1];
+            m.add(s * (n[0] + a * u[0] + b * v[0]),
+                  s * (n[1] + a * u[1] + b * v[1]),
+                  s * (n[2] + a * u[2] + b * v[2]),
+                  n[0], n[1], n[2]);
+        }
+    }
+    return m;
+}
+
+void mygllib::Mesh::draw() const
+{
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, vertices());
+    glNormalPointer(GL_FLOAT, 0, normals());
+    GL_CALL(glDrawArrays(GL_TRIANGLES, 0, GLsizei(vertex_count())));
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
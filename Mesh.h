@@ -0,0 +1,52 @@
+// File  : Mesh.h
+// Author: Cole Schwandt
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <vector>
+#include <GL/freeglut.h>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // Mesh
+    //
+    // Triangle soup with per-vertex normals, tessellated once on the CPU.
+    // Stands in for glutSolidSphere/Cylinder/Cube (same shapes, placement
+    // and slices/stacks meaning) but needs no GLUT window, so it also draws
+    // in offscreen contexts. A const Mesh may be shared by any number of
+    // threads and contexts: draw() only reads it through client-side
+    // vertex arrays.
+    //
+    // USAGE:
+    // const mygllib::Mesh ball = mygllib::Mesh::sphere(1.0f, 20, 20);
+    // ball.draw();
+    //-------------------------------------------------------------------------
+    class Mesh
+    {
+    public:
+        // centered at the origin, poles on the z-axis
+        static Mesh sphere(GLfloat r, GLint slices, GLint stacks);
+        // base on z=0, extends to z=h, capped at both ends
+        static Mesh cylinder(GLfloat r, GLfloat h, GLint slices, GLint stacks);
+        // centered at the origin
+        static Mesh cube(GLfloat size);
+
+        void draw() const;
+
+        size_t vertex_count() const   { return vertices_.size() / 3; }
+        size_t triangle_count() const { return vertices_.size() / 9; }
+        const GLfloat * vertices() const { return &vertices_[0]; }
+        const GLfloat * normals() const  { return &normals_[0]; }
+
+    private:
+        void add(GLfloat x, GLfloat y, GLfloat z,
+                 GLfloat nx, GLfloat ny, GLfloat nz);
+
+        std::vector< GLfloat > vertices_; // x,y,z per vertex, 3 per triangle
+        std::vector< GLfloat > normals_;
+    };
+}
+
+#endif
@@ -0,0 +1,275 @@
+// File  : Picking.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Jacobian.h"
+#include "Picking.h"
+
+namespace
+{
+    using arm::Vec3;
+    using arm::Mat4;
+    using arm::Quat;
+
+    //==============================================================
+    // Rotations
+    //==============================================================
+    // shortest-arc rotation taking direction u to direction v
+    Quat arc(const Vec3 & u, const Vec3 & v)
+    {
+        const Vec3 a = normalize(u), b = normalize(v);
+        const Vec3 axis = cross(a, b);
+        if (length2(axis) < 1e-12f) return Quat();
+        // half-way quaternion: (1 + cos, sin * axis), normalized
+        return mygllib::normalize(Quat(1.0f + dot(a, b),
+                                       axis.x, axis.y, axis.z));
+    }
+
+    //==============================================================
+    // Chain (same sequence as forward_kinematics())
+    //==============================================================
+    struct Chain
+    {
+        Quat shoulder, elbow;  // world rotations of the two joints
+        Vec3 elbow_origin, palm;
+    };
+
+    Chain chain(const arm::Pose & p)
+    {
+        const float link_y = cfg::JOINT_R + cfg::LINK_GAP();
+        const float elbow_y = link_y + cfg::ARM_L - cfg::LINK_GAP();
+        const float palm_y = link_y + cfg::ARM_L + 0.5f * cfg::PALM_SIZE;
+
+        Chain c;
+        c.shoulder = arm::shoulder_rotation(p);
+        c.elbow = c.shoulder * arm::elbow_rotation(p);
+        c.elbow_origin = Mat4::rotate(c.shoulder).vector(Vec3(0.0f, elbow_y, 0.0f));
+        c.palm = c.elbow_origin
+               + Mat4::rotate(c.elbow).vector(Vec3(0.0f, palm_y, 0.0f));
+        return c;
+    }
+
+    // 3x3 solve by Cramer's rule; A is symmetric positive definite here
+    Vec3 solve3(const float a[3][3], const Vec3 & b)
+    {
+        const float det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                        - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                        + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+        const Vec3 c0(a[0][0], a[1][0], a[2][0]);
+        const Vec3 c1(a[0][1], a[1][1], a[2][1]);
+        const Vec3 c2(a[0][2], a[1][2], a[2][2]);
+        return Vec3(dot(b, cross(c1, c2)), dot(c0, cross(b, c2)),
+                    dot(c0, cross(c1, b))) * (1.0f / det);
+    }
+}
+
+//==============================================================
+// Rays
+//==============================================================
+arm::Ray arm::view_ray(const mygllib::View & view, int x, int y, int w, int h)
+{
+    const Vec3 eye(view.eyex(), view.eyey(), view.eyez());
+    const Vec3 ref(view.refx(), view.refy(), view.refz());
+    const Vec3 up(view.upx(), view.upy(), view.upz());
+    const Vec3 f = normalize(ref - eye);
+    const Vec3 r = normalize(cross(f, up));
+    const Vec3 u = cross(r, f);
+
+    // pixel center to normalized device coordinates, then to the image
+    // plane at distance 1 (gluPerspective's frustum)
+    const float th = std::tan(0.5f * mygllib::deg2rad(view.fovy()));
+    const float nx = (2.0f * (x + 0.5f) / w - 1.0f) * th * view.aspect();
+    const float ny = (1.0f - 2.0f * (y + 0.5f) / h) * th;
+
+    Ray ray = { eye, normalize(f + r * nx + u * ny) };
+    return ray;
+}
+
+bool arm::raycast(const Ray & ray, const Sphere & s, float & t)
+{
+    const Vec3 oc = ray.o - s.c;
+    const float b = dot(oc, ray.d);
+    const float c = dot(oc, oc) - s.r * s.r;
+    const float disc = b * b - c;
+    if (disc < 0.0f) return false;
+    const float root = std::sqrt(disc);
+    t = -b - root;
+    if (t < 0.0f) t = -b + root;            // starts inside
+    return t >= 0.0f;
+}
+
+// The side of the cylinder (quadratic in t after projecting out the
+// axis), then the two end spheres.
+bool arm::raycast(const Ray & ray, const Capsule & c, float & t)
+{
+    bool hit = false;
+    t = std::numeric_limits< float >::max();
+
+    const Vec3 ab = c.b - c.a, ao = ray.o - c.a;
+    const float l2 = dot(ab, ab);
+    const float dab = dot(ray.d, ab), oab = dot(ao, ab);
+    const float qa = l2 - dab * dab;
+    if (l2 > 0.0f && qa > 1e-9f * l2)
+    {
+        const float qb = l2 * dot(ao, ray.d) - oab * dab;
+        const float qc = l2 * (dot(ao, ao) - c.r * c.r) - oab * oab;
+        const float disc = qb * qb - qa * qc;
+        if (disc >= 0.0f)
+        {
+            const float tt = (-qb - std::sqrt(disc)) / qa;
+            const float s = oab + tt * dab;
+            if (tt >= 0.0f && s >= 0.0f && s <= l2)
+            {
+                t = tt;
+                hit = true;
+            }
+        }
+    }
+
+    float tt;
+    const Sphere cap[2] = { { c.a, c.r }, { c.b, c.r } };
+    for (int i = 0; i < 2; ++i)
+    {
+        if (raycast(ray, cap[i], tt) && tt < t)
+        {
+            t = tt;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+//==============================================================
+// Picking
+//==============================================================
+bool arm::pick(const Ray & ray, const ArmShapes & s, Pick & p)
+{
+    p.part = Pick::NONE;
+    p.finger = -1;
+    p.t = std::numeric_limits< float >::max();
+
+    float t;
+    if (raycast(ray, s.shoulder, t) && t < p.t)  { p.t = t; p.part = Pick::SHOULDER; }
+    if (raycast(ray, s.upper_arm, t) && t < p.t) { p.t = t; p.part = Pick::UPPER_ARM; }
+    if (raycast(ray, s.elbow, t) && t < p.t)     { p.t = t; p.part = Pick::ELBOW; }
+    if (raycast(ray, s.forearm, t) && t < p.t)   { p.t = t; p.part = Pick::FOREARM; }
+    if (raycast(ray, s.palm, t) && t < p.t)      { p.t = t; p.part = Pick::PALM; }
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        if ((raycast(ray, s.proximal[i], t) && t < p.t)
+            || (raycast(ray, s.distal[i], t) && t < p.t))
+        {
+            p.t = t;
+            p.part = Pick::FINGER;
+            p.finger = i;
+        }
+    }
+
+    if (p.part == Pick::NONE) return false;
+    p.point = ray.o + ray.d * p.t;
+    return true;
+}
+
+const char * arm::part_name(Pick::Part part)
+{
+    switch (part)
+    {
+        case Pick::SHOULDER:  return "shoulder";
+        case Pick::UPPER_ARM: return "upper arm";
+        case Pick::ELBOW:     return "elbow";
+        case Pick::FOREARM:   return "forearm";
+        case Pick::PALM:      return "palm";
+        case Pick::FINGER:    return "finger";
+        default:              return "none";
+    }
+}
+
+//==============================================================
+// DragPose
+//==============================================================
+arm::DragPose::DragPose()
+{
+    pick_.part = Pick::NONE;
+}
+
+bool arm::DragPose::begin(const Ray & ray, const ArmShapes & s)
+{
+    if (!arm::pick(ray, s, pick_)) return false;
+    normal_ = ray.d;
+    grab_ = pick_.point;
+    return true;
+}
+
+void arm::DragPose::move(const Ray & ray, Pose & pose)
+{
+    if (!active()) return;
+
+    // where the ray crosses the drag plane
+    const float dn = dot(ray.d, normal_);
+    if (std::fabs(dn) < 1e-6f) return;
+    const float t = dot(grab_ - ray.o, normal_) / dn;
+    if (t <= 0.0f) return;
+    const Vec3 target = ray.o + ray.d * t;
+
+    const Chain c = chain(pose);
+    switch (pick_.part)
+    {
+        case Pick::SHOULDER:
+        case Pick::UPPER_ARM:
+        {
+            // shoulder at the origin: R' = D R
+            const Quat d = arc(grab_, target);
+            set_shoulder_rotation(pose, mygllib::normalize(d * c.shoulder));
+            grab_ = Mat4::rotate(d).vector(grab_);
+            break;
+        }
+        case Pick::ELBOW:
+        case Pick::FOREARM:
+        {
+            // world rotation D about the elbow: S E' = D S E
+            const Vec3 from = grab_ - c.elbow_origin;
+            const Quat d = arc(from, target - c.elbow_origin);
+            set_elbow_rotation(pose, mygllib::normalize(c.shoulder.conjugate()
+                                                        * d * c.elbow));
+            grab_ = c.elbow_origin + Mat4::rotate(d).vector(from);
+            break;
+        }
+        default:
+        {
+            // palm follows the mouse: dq = Jv^T (Jv Jv^T + l^2 I)^-1 e
+            const Vec3 goal = c.palm + (target - grab_);
+            GLfloat * q[NUM_JOINTS] =
+            {
+                &pose.shoulder_pitch, &pose.shoulder_yaw, &pose.shoulder_roll,
+                &pose.elbow_pitch, &pose.elbow_yaw, &pose.elbow_roll,
+            };
+            const float l2 = cfg::DRAG_IK_DAMPING * cfg::DRAG_IK_DAMPING;
+            Jacobian j;
+            for (int step = 0; step < cfg::DRAG_IK_STEPS; ++step)
+            {
+                const Vec3 e = goal - chain(pose).palm;
+                if (length2(e) < 1e-8f) break;
+                palm_jacobian(pose, j);
+                float a[3][3];
+                for (int r = 0; r < 3; ++r)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        float s = (r == k ? l2 : 0.0f);
+                        for (int i = 0; i < NUM_JOINTS; ++i)
+                            s += j.m[r][i] * j.m[k][i];
+                        a[r][k] = s;
+                    }
+                }
+                const Vec3 y = solve3(a, e);
+                for (int i = 0; i < NUM_JOINTS; ++i)
+                    *q[i] += mygllib::rad2deg(j.m[0][i] * y.x + j.m[1][i] * y.y
+                                              + j.m[2][i] * y.z);
+            }
+            grab_ += chain(pose).palm - c.palm;
+            break;
+        }
+    }
+}
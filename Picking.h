@@ -0,0 +1,105 @@
+// File  : Picking.h
+// Author: Cole Schwandt
+
+#ifndef PICKING_H
+#define PICKING_H
+
+#include "View.h"
+#include "Collision.h"
+
+namespace cfg
+{
+    // -------- drag to pose --------
+    const int     DRAG_IK_STEPS = 8;      // damped least-squares steps per motion
+    const GLfloat DRAG_IK_DAMPING = 0.5f; // lambda, scene units
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // Ray
+    //
+    // o + t d, t >= 0, d unit length. view_ray() is the ray through window
+    // pixel (x, y) (GLUT mouse coordinates: origin top left) of a w x h
+    // window, built from the View's camera alone: no GL state is read.
+    //-------------------------------------------------------------------------
+    struct Ray
+    {
+        Vec3 o, d;
+    };
+
+    Ray view_ray(const mygllib::View & view, int x, int y, int w, int h);
+
+    // nearest t >= 0 where the ray enters the shape
+    bool raycast(const Ray & ray, const Sphere & s, float & t);
+    bool raycast(const Ray & ray, const Capsule & c, float & t);
+
+    //-------------------------------------------------------------------------
+    // Pick
+    //
+    // The part of an arm a ray hits first. finger is set for the
+    // phalanges only.
+    //-------------------------------------------------------------------------
+    struct Pick
+    {
+        enum Part
+        {
+            NONE, SHOULDER, UPPER_ARM, ELBOW, FOREARM, PALM, FINGER
+        };
+
+        Part part;
+        int finger;
+        float t;
+        Vec3 point;
+    };
+
+    bool pick(const Ray & ray, const ArmShapes & s, Pick & p);
+    const char * part_name(Pick::Part part);
+
+    //-------------------------------------------------------------------------
+    // DragPose
+    //
+    // Click-and-drag posing. The grabbed point follows the mouse on the
+    // plane through it facing the camera:
+    //   shoulder, upper arm  the shoulder turns (pitch/yaw/roll) so the
+    //                        point lies toward the mouse
+    //   elbow, forearm       the same for the elbow
+    //   palm, finger         inverse kinematics on all six joints
+    //                        (damped least squares on the palm Jacobian)
+    //                        moves the palm by the mouse motion
+    // Rotations are the shortest arc, converted back to the Euler angles
+    // draw_arm() takes, continuous with the previous ones.
+    //
+    // USAGE:
+    // arm::DragPose drag;
+    // void mouse(int button, int state, int x, int y)  // GLUT callbacks
+    // {
+    //     if (state == GLUT_DOWN) drag.begin(view_ray(...), shapes, pose);
+    //     else drag.end();
+    // }
+    // void motion(int x, int y)
+    // {
+    //     if (drag.active()) drag.move(view_ray(...), pose);
+    // }
+    //-------------------------------------------------------------------------
+    class DragPose
+    {
+    public:
+        DragPose();
+
+        // false, and not active, if the ray misses the arm
+        bool begin(const Ray & ray, const ArmShapes & s);
+        void move(const Ray & ray, Pose & pose);
+        void end() { pick_.part = Pick::NONE; }
+
+        bool active() const { return pick_.part != Pick::NONE; }
+        const Pick & pick() const { return pick_; }
+
+    private:
+        Pick pick_;
+        Vec3 normal_;       // drag plane through the grabbed point
+        Vec3 grab_;         // where the grabbed point is now
+    };
+}
+
+#endif
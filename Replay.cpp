@@ -0,0 +1,296 @@
+// File  : Replay.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <GL/freeglut.h>
+#include "Clock.h"
+#include "debug.h"
+#include "Replay.h"
+
+namespace
+{
+    struct KeyName
+    {
+        const char * name;
+        int key;
+    };
+
+    const KeyName SPECIAL_KEYS[] = {
+        { "F1", GLUT_KEY_F1 },   { "F2", GLUT_KEY_F2 },   { "F3", GLUT_KEY_F3 },
+        { "F4", GLUT_KEY_F4 },   { "F5", GLUT_KEY_F5 },   { "F6", GLUT_KEY_F6 },
+        { "F7", GLUT_KEY_F7 },   { "F8", GLUT_KEY_F8 },   { "F9", GLUT_KEY_F9 },
+        { "F10", GLUT_KEY_F10 }, { "F11", GLUT_KEY_F11 }, { "F12", GLUT_KEY_F12 },
+        { "UP", GLUT_KEY_UP },   { "DOWN", GLUT_KEY_DOWN },
+        { "LEFT", GLUT_KEY_LEFT }, { "RIGHT", GLUT_KEY_RIGHT },
+    };
+
+    std::string describe(const arm::ReplayEvent & e)
+    {
+        std::ostringstream s;
+        if (e.kind == arm::ReplayEvent::KEY)
+        {
+            s << "key " << char(e.key);
+        }
+        else if (e.kind != arm::ReplayEvent::SPECIAL)
+        {
+            const char * name[] = { "", "", "press", "drag", "release" };
+            s << name[e.kind] << ' ' << e.x << ' ' << e.y;
+        }
+        else
+        {
+            s << "special ";
+            for (size_t i = 0; i < sizeof(SPECIAL_KEYS) / sizeof(SPECIAL_KEYS[0]); ++i)
+                if (SPECIAL_KEYS[i].key == e.key) s << SPECIAL_KEYS[i].name;
+        }
+        s << " (line " << e.line << ')';
+        return s.str();
+    }
+
+    void sleep_until(int64_t t_ns)
+    {
+        timespec ts;
+        ts.tv_sec  = t_ns / 1000000000LL;
+        ts.tv_nsec = t_ns % 1000000000LL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+
+    double percentile_ms(const std::vector< int64_t > & sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        const size_t i = size_t(p * (sorted.size() - 1) + 0.5);
+        return mygllib::ns_to_ms(sorted[i]);
+    }
+}
+
+uint64_t arm::hash_pixels(const unsigned char * p, size_t n)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+arm::Replay::Replay(const std::string & script)
+    : script_(script), mouse_(NULL), motion_(NULL), wall_ns_(0)
+{
+    std::ifstream in(script.c_str());
+    if (!in)
+    {
+        std::cout << "replay: cannot open " << script << std::endl;
+        throw ReplayError();
+    }
+
+    std::string line;
+    for (int n = 1; std::getline(in, line); ++n)
+    {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream s(line);
+        double t_ms;
+        std::string kind, key;
+        if (!(s >> t_ms)) continue;           // blank or comment line
+        if (!(s >> kind >> key))
+        {
+            std::cout << script << ':' << n
+                      << ": expected <ms> key|special <key> or <ms> press|drag|release <x> <y>"
+                      << std::endl;
+            throw ReplayError();
+        }
+
+        ReplayEvent e;
+        e.t_ns = int64_t(t_ms * 1e6);
+        e.line = n;
+        e.x = e.y = 0;
+        if (kind == "press" || kind == "drag" || kind == "release")
+        {
+            e.kind = kind == "press" ? ReplayEvent::PRESS
+                   : (kind == "drag" ? ReplayEvent::DRAG : ReplayEvent::RELEASE);
+            e.key = GLUT_LEFT_BUTTON;
+            e.x = atoi(key.c_str());
+            if (!(s >> e.y))
+            {
+                std::cout << script << ':' << n << ": expected <ms> " << kind
+                          << " <x> <y>" << std::endl;
+                throw ReplayError();
+            }
+        }
+        else if (kind == "key" && key.size() == 1)
+        {
+            e.kind = ReplayEvent::KEY;
+            e.key = (unsigned char) key[0];
+        }
+        else if (kind == "special")
+        {
+            e.kind = ReplayEvent::SPECIAL;
+            e.key = -1;
+            for (size_t i = 0; i < sizeof(SPECIAL_KEYS) / sizeof(SPECIAL_KEYS[0]); ++i)
+                if (key == SPECIAL_KEYS[i].name) e.key = SPECIAL_KEYS[i].key;
+            if (e.key < 0)
+            {
+                std::cout << script << ':' << n << ": unknown special key "
+                          << key << std::endl;
+                throw ReplayError();
+            }
+        }
+        else
+        {
+            std::cout << script << ':' << n << ": bad event '" << kind << ' '
+                      << key << "'" << std::endl;
+            throw ReplayError();
+        }
+        if (!events_.empty() && e.t_ns < events_.back().t_ns)
+        {
+            std::cout << script << ':' << n << ": timestamps must not decrease"
+                      << std::endl;
+            throw ReplayError();
+        }
+        events_.push_back(e);
+    }
+}
+
+void arm::Replay::run(int w, int h, DisplayFunc display, KeyboardFunc keyboard,
+                      SpecialFunc special, bool realtime)
+{
+    std::vector< unsigned char > pixels(size_t(w) * h * 4);
+    hashes_.clear();
+    frame_ns_.clear();
+    first_event_.clear();
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    const int64_t start = mygllib::now_ns();
+    size_t i = 0;
+    for (int frame = 0; frame == 0 || i < events_.size(); ++frame)
+    {
+        int64_t t0;
+        if (frame == 0)
+        {
+            t0 = mygllib::now_ns();
+            first_event_.push_back(-1);
+        }
+        else
+        {
+            if (realtime) sleep_until(start + events_[i].t_ns);
+            t0 = mygllib::now_ns();
+            first_event_.push_back(int(i));
+            const int64_t t = events_[i].t_ns;
+            for ( ; i < events_.size() && events_[i].t_ns == t; ++i)
+            {
+                const ReplayEvent & e = events_[i];
+                switch (e.kind)
+                {
+                    case ReplayEvent::KEY:
+                        keyboard((unsigned char) e.key, 0, 0);
+                        break;
+                    case ReplayEvent::SPECIAL:
+                        special(e.key, 0, 0);
+                        break;
+                    case ReplayEvent::PRESS:
+                    case ReplayEvent::RELEASE:
+                        if (mouse_)
+                            mouse_(e.key, e.kind == ReplayEvent::PRESS
+                                   ? GLUT_DOWN : GLUT_UP, e.x, e.y);
+                        break;
+                    case ReplayEvent::DRAG:
+                        if (motion_) motion_(e.x, e.y);
+                        break;
+                }
+            }
+        }
+
+        display();
+        GL_CALL(glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+        frame_ns_.push_back(mygllib::now_ns() - t0);
+        hashes_.push_back(hash_pixels(&pixels[0], pixels.size()));
+    }
+    wall_ns_ = mygllib::now_ns() - start;
+}
+
+void arm::Replay::report(std::ostream & out) const
+{
+    std::vector< int64_t > sorted(frame_ns_);
+    std::sort(sorted.begin(), sorted.end());
+    const double p50 = percentile_ms(sorted, 0.5);
+
+    out << "replay " << script_ << ": " << events_.size() << " events, "
+        << frame_ns_.size() << " frames in " << mygllib::ns_to_ms(wall_ns_)
+        << " ms\n"
+        << "frame time (ms): p50 " << p50
+        << "  p90 " << percentile_ms(sorted, 0.9)
+        << "  p99 " << percentile_ms(sorted, 0.99)
+        << "  p99.9 " << percentile_ms(sorted, 0.999)
+        << "  max " << percentile_ms(sorted, 1.0) << '\n';
+
+    // stalls: frames over twice the median, worst first
+    std::vector< size_t > order(frame_ns_.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [this](size_t a, size_t b) { return frame_ns_[a] > frame_ns_[b]; });
+    size_t stalls = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+        if (mygllib::ns_to_ms(frame_ns_[order[i]]) > 2 * p50) ++stalls;
+    out << "stalls (> 2x p50): " << stalls << '\n';
+    for (size_t i = 0; i < order.size() && i < 5; ++i)
+    {
+        const size_t f = order[i];
+        out << "  frame " << f << ": " << mygllib::ns_to_ms(frame_ns_[f]) << " ms";
+        if (first_event_[f] >= 0) out << " after " << describe(events_[first_event_[f]]);
+        else out << " (initial frame)";
+        out << '\n';
+    }
+    out.flush();
+}
+
+int arm::Replay::check_golden(const std::string & path, std::ostream & out) const
+{
+    std::ifstream in(path.c_str());
+    std::vector< uint64_t > golden;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        golden.push_back(strtoull(line.c_str(), NULL, 16));
+    }
+
+    int bad = 0;
+    for (size_t f = 0; f < hashes_.size(); ++f)
+    {
+        if (f < golden.size() && golden[f] == hashes_[f]) continue;
+        if (bad < 10)
+        {
+            out << "golden mismatch: frame " << f;
+            if (first_event_[f] >= 0) out << " after " << describe(events_[first_event_[f]]);
+            out << '\n';
+        }
+        ++bad;
+    }
+    if (golden.size() != hashes_.size())
+    {
+        out << "golden has " << golden.size() << " frames, replay rendered "
+            << hashes_.size() << '\n';
+        if (bad == 0) bad = 1;
+    }
+    out << (bad ? "golden check FAILED: " : "golden check passed: ")
+        << hashes_.size() - std::min(size_t(bad), hashes_.size()) << '/'
+        << hashes_.size() << " frames match " << path << std::endl;
+    return bad;
+}
+
+void arm::Replay::write_golden(const std::string & path) const
+{
+    std::ofstream out(path.c_str());
+    out << "# frame hashes for " << script_ << '\n';
+    char buf[32];
+    for (size_t f = 0; f < hashes_.size(); ++f)
+    {
+        snprintf(buf, sizeof(buf), "%016llx", (unsigned long long) hashes_[f]);
+        out << buf << '\n';
+    }
+}
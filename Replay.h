@@ -0,0 +1,110 @@
+// File  : Replay.h
+// Author: Cole Schwandt
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace arm
+{
+    class ReplayError
+    {};
+
+    //-------------------------------------------------------------------------
+    // ReplayEvent
+    //
+    // One recorded key press or left-button mouse event. Script lines are
+    //
+    //     <time ms> key <char>           e.g.  250 key X
+    //     <time ms> special <name>       e.g.  300 special F1
+    //     <time ms> press <x> <y>        e.g.  400 press 310 220
+    //     <time ms> drag <x> <y>         (motion with the button held)
+    //     <time ms> release <x> <y>
+    //
+    // where <name> is F1..F12, UP, DOWN, LEFT or RIGHT and x, y are window
+    // pixels from the top left as GLUT reports them. '#' starts a comment.
+    //-------------------------------------------------------------------------
+    struct ReplayEvent
+    {
+        enum Kind
+        {
+            KEY, SPECIAL, PRESS, DRAG, RELEASE
+        };
+
+        int64_t t_ns;
+        Kind kind;
+        int key;
+        int x, y;
+        int line;
+    };
+
+    //-------------------------------------------------------------------------
+    // Replay
+    //
+    // Feeds a recorded script into the GLUT input callbacks and renders one
+    // frame per distinct timestamp (events with the same time are coalesced,
+    // as one glutPostRedisplay() would). The caller provides a current GL
+    // context of size w x h. Each frame is timed from the first injected
+    // event until its pixels have been read back, and hashed.
+    //
+    // USAGE:
+    // arm::Replay replay("replay/demo.script");
+    // replay.mouse(mouse, motion);                 // if the script clicks
+    // replay.run(w, h, display, mygllib::Keyboard::keyboard, specialkeyboard);
+    // replay.report(std::cout);
+    // replay.check_golden("replay/demo.golden");
+    //-------------------------------------------------------------------------
+    class Replay
+    {
+    public:
+        typedef void (*DisplayFunc)();
+        typedef void (*KeyboardFunc)(unsigned char, int, int);
+        typedef void (*SpecialFunc)(int, int, int);
+        typedef void (*MouseFunc)(int, int, int, int);
+        typedef void (*MotionFunc)(int, int);
+
+        Replay(const std::string & script);
+
+        // where mouse events go; scripts with mouse events need both
+        void mouse(MouseFunc mouse, MotionFunc motion)
+        {
+            mouse_ = mouse;
+            motion_ = motion;
+        }
+
+        // realtime: wait for each event's timestamp; otherwise back to back
+        void run(int w, int h, DisplayFunc display, KeyboardFunc keyboard,
+                 SpecialFunc special, bool realtime=true);
+
+        void report(std::ostream & out) const;
+
+        // Returns the number of frames whose hash differs from the golden
+        // file (a missing or short file counts every unmatched frame).
+        int check_golden(const std::string & path, std::ostream & out) const;
+        void write_golden(const std::string & path) const;
+
+        const std::vector< uint64_t > & hashes() const     { return hashes_; }
+        const std::vector< int64_t > & frame_times() const { return frame_ns_; }
+
+    private:
+        std::string script_;
+        std::vector< ReplayEvent > events_;
+        MouseFunc mouse_;
+        MotionFunc motion_;
+
+        // per frame; frame 0 is the initial frame before any input
+        std::vector< uint64_t > hashes_;
+        std::vector< int64_t > frame_ns_;
+        std::vector< int > first_event_;   // index into events_, -1 for frame 0
+        int64_t wall_ns_;
+    };
+
+    // 64-bit FNV-1a of a pixel buffer
+    uint64_t hash_pixels(const unsigned char * p, size_t n);
+}
+
+#endif
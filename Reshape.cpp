@@ -2,15 +2,15 @@
 // Author: smaug
 
 #include "View.h"
-#include "SingletonView.h"
+#include "Framebuffer.h"
+#include "Windows.h"
 #include "Reshape.h"
 
 void mygllib::Reshape::reshape(int w, int h)
 {
     if (h == 0) h = 1;
-    glViewport(0, 0, w, h);
-    mygllib::View * pview = mygllib::SingletonView::getInstance();
-    pview->aspect() = double(w) / h;
-    pview->set_projection();
-    pview->lookat();
+    Windows::resize(w, h);
+    StaticLayer::invalidate_all();
+    Windows::apply();
+    Windows::view().lookat();
 }
@@ -4,12 +4,20 @@
 #ifndef RESHAPE_H
 #define RESHAPE_H
 
+#include "Windows.h"
+
 namespace mygllib
 {
     class Reshape
     {
     public:
+        // for the current window, whose View it keeps the aspect of
         static void reshape(int w, int h);
+
+        // size given to the last reshape() of the current window, e.g. for
+        // mouse coordinates
+        static int width()  { return Windows::width(); }
+        static int height() { return Windows::height(); }
     };
 }
 
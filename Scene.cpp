@@ -0,0 +1,467 @@
+// File  : Scene.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Drawing of the robotic arm scene. Used by the GLUT window and by the
+// headless/offscreen paths, so nothing here may call GLUT.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <GL/freeglut.h>
+#include "gl3d.h"
+#include "Material.h"
+#include "Light.h"
+#include "Scene.h"
+
+//==============================================================
+// Config
+//==============================================================
+namespace cfg
+{
+    // -------- clear/depth --------
+    const GLfloat CLEAR_R = 1.0f;
+    const GLfloat CLEAR_G = 1.0f;
+    const GLfloat CLEAR_B = 1.0f;
+    const GLfloat CLEAR_A = 0.0f;
+    const GLfloat CLEAR_DEPTH = 1.0f;
+
+    // -------- materials --------
+    const int MAT_JOINT = mygllib::Material::CHROME;
+    const int MAT_LINKS = mygllib::Material::PEARL;
+    const int MAT_GRASP = mygllib::Material::RUBY;
+    const int MAT_CONTACT = mygllib::Material::GOLD;
+    const GLfloat CONTACT_R = 0.04f;
+
+    // -------- manipulability ellipsoid --------
+    const GLfloat ELLIPSOID_SCALE = 0.15f;   // scene units per unit/rad
+    const GLfloat ELLIPSOID_OK[3]   = { 0.1f, 0.6f, 0.1f };
+    const GLfloat ELLIPSOID_WARN[3] = { 0.9f, 0.1f, 0.1f };
+
+    // -------- light --------
+    const GLenum LIGHT_ID = GL_LIGHT0;
+    const GLfloat LIGHT_AMBIENT[4]  = { 0.5f, 0.5f, 0.5f, 0.5f };
+    const GLfloat LIGHT_DIFFUSE[4]  = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const GLfloat LIGHT_SPECULAR[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const GLfloat LIGHT_POS[4]      = { 4.0f, 6.0f, 3.0f, 1.0f };
+
+    // -------- planar shadows --------
+    const GLfloat SHADOW_COLOR[3] = { 0.75f, 0.75f, 0.75f };
+}
+
+namespace
+{
+    //==============================================================
+    // Lighting
+    //==============================================================
+    mygllib::Light light(
+        cfg::LIGHT_ID,
+        cfg::LIGHT_AMBIENT[0], cfg::LIGHT_AMBIENT[1], cfg::LIGHT_AMBIENT[2], cfg::LIGHT_AMBIENT[3],
+        cfg::LIGHT_DIFFUSE[0], cfg::LIGHT_DIFFUSE[1], cfg::LIGHT_DIFFUSE[2], cfg::LIGHT_DIFFUSE[3],
+        cfg::LIGHT_SPECULAR[0], cfg::LIGHT_SPECULAR[1], cfg::LIGHT_SPECULAR[2], cfg::LIGHT_SPECULAR[3],
+        cfg::LIGHT_POS[0], cfg::LIGHT_POS[1], cfg::LIGHT_POS[2], cfg::LIGHT_POS[3]
+    );
+
+    //==============================================================
+    // Material helpers
+    //==============================================================
+    void set_mat0()
+    {
+        mygllib::Material(cfg::MAT_JOINT).set();
+    }
+
+    void set_col1()
+    {
+        mygllib::Material(cfg::MAT_LINKS).set();
+    }
+
+    //==============================================================
+    // Robot part drawers
+    //==============================================================
+    void draw_base(const mygllib::Mesh & m)
+    {
+        set_col1();
+        m.draw();
+    }
+
+    void draw_joint(const mygllib::Mesh & m)
+    {
+        set_mat0();
+        m.draw();
+    }
+
+    void draw_link(const mygllib::Mesh & m)
+    {
+        set_col1();
+        m.draw();
+    }
+
+    void draw_finger(const arm::Vec3 & p, const FingerAngles & a,
+                     const arm::ArmMeshes & meshes)
+    {
+        glPushMatrix();
+        {
+            // place on palm
+            glTranslatef(p.x, p.y, p.z);
+            draw_joint(meshes.finger_joint);
+
+            // first phalanx: your Z-bend, then aim Z->Y and draw
+            glRotatef(a.baseZ, 0.0f, 0.0f, 1.0f);
+            glPushMatrix();
+            {
+                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
+                draw_link(meshes.digit);
+            }
+            glPopMatrix();
+
+            // middle joint block: walk L in (palm) Y, apply your joint Z, draw joint
+            glPushMatrix();
+            {
+                glTranslatef(0.0f, cfg::FINGER_DIGIT_L, 0.0f);
+                glRotatef(a.jointZ, 0.0f, 0.0f, 1.0f);
+                draw_joint(meshes.finger_joint);
+
+                // second phalanx: aim Z->Y then your Y-rotation, draw
+                glPushMatrix();
+                {
+                    glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
+                    glRotatef(a.tipY, 0.0f, 1.0f, 0.0f);
+                    draw_link(meshes.digit);
+                }
+                glPopMatrix();
+            }
+            glPopMatrix();
+        }
+        glPopMatrix();
+    }
+
+    //==============================================================
+    // Planar shadows: everything drawn between begin_shadow() and
+    // end_shadow() is flattened along the direction of the light
+    // onto the top of the base plates, where most of it falls, in
+    // one flat color pulled in front of what is already there. The
+    // light is taken as far away (w = 0): from a point light, arms
+    // that reach above it would cast shadows to infinity.
+    //==============================================================
+    void begin_shadow()
+    {
+        // plane y = h, or (0, 1, 0, -h); m = (plane . light) I - light plane^T
+        const GLfloat l[4] = { cfg::LIGHT_POS[0], cfg::LIGHT_POS[1],
+                               cfg::LIGHT_POS[2], 0.0f };
+        const GLfloat plane[4] = { 0.0f, 1.0f, 0.0f,
+                                   -0.5f * cfg::BASE_SY * cfg::BASE_SIZE };
+        arm::Mat4 m;
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int c = 0; c < 4; ++c)
+                m(r, c) = (r == c ? l[1] : 0.0f) - l[r] * plane[c];
+        }
+
+        glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_POLYGON_BIT);
+        glDisable(GL_LIGHTING);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.0f);
+        glColor3fv(cfg::SHADOW_COLOR);
+        glPushMatrix();
+        glMultMatrixf(m.m);
+    }
+
+    void end_shadow()
+    {
+        glPopMatrix();
+        glPopAttrib();
+    }
+
+    //==============================================================
+    // Frame setup: clear, camera, grid of +-extent, axes, light
+    //==============================================================
+    void camera_and_light(const mygllib::View & view)
+    {
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        view.lookat();
+
+        light.on();
+        glEnable(GL_NORMALIZE);
+        glShadeModel(GL_SMOOTH);
+        light.set_position();
+    }
+
+    void begin_scene(const mygllib::View & view, int extent, int grid_step)
+    {
+        GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        view.lookat();
+
+        mygllib::Light::all_off();
+        mygllib::draw_xz_plane(-extent, extent, -extent, extent,
+                               grid_step, grid_step);
+        mygllib::draw_axes();
+        mygllib::Light::all_on();
+
+        camera_and_light(view);
+    }
+}
+
+arm::ArmMeshes::ArmMeshes(GLint slices, GLint stacks)
+    : base(mygllib::Mesh::cube(cfg::BASE_SIZE)),
+      joint(mygllib::Mesh::sphere(cfg::JOINT_R, slices, stacks)),
+      link(mygllib::Mesh::cylinder(cfg::ARM_R, cfg::ARM_L, slices, stacks)),
+      palm(mygllib::Mesh::cube(cfg::PALM_SIZE)),
+      finger_joint(mygllib::Mesh::sphere(cfg::FINGER_JOINT_R, slices, stacks)),
+      digit(mygllib::Mesh::cylinder(cfg::FINGER_DIGIT_R, cfg::FINGER_DIGIT_L,
+                                    slices, stacks)),
+      ball(mygllib::Mesh::sphere(1.0f, slices, stacks)),
+      block(mygllib::Mesh::cube(1.0f)),
+      rod(mygllib::Mesh::cylinder(1.0f, 1.0f, slices, stacks))
+{}
+
+void arm::init_scene()
+{
+    glClearColor(cfg::CLEAR_R, cfg::CLEAR_G, cfg::CLEAR_B, cfg::CLEAR_A);
+    //glClearDepth(cfg::CLEAR_DEPTH);
+
+    light.set();
+    mygllib::Light::all_on();
+    light.on();
+    glEnable(GL_DEPTH_TEST);
+    glShadeModel(GL_SMOOTH);
+    glEnable(GL_NORMALIZE);
+}
+
+void arm::draw_arm(const Pose & pose, const ArmMeshes & meshes,
+                   const FingerAngles * fingers)
+{
+    // upper arm joint (shoulder)
+    glPushMatrix();
+    {
+        // one matrix for the ball joint instead of three glRotatef()s
+        glMultMatrixf(Mat4::rotate(shoulder_rotation(pose)).m);
+
+        draw_joint(meshes.joint);
+
+        // upper arm
+        glPushMatrix();
+        {
+            glTranslatef(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
+
+            glPushMatrix();
+            {
+                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
+                draw_link(meshes.link);
+            }
+            glPopMatrix();
+
+            // forearm joint (elbow)
+            glTranslatef(0.0f, cfg::ARM_L - cfg::LINK_GAP(), 0.0f);
+            glMultMatrixf(Mat4::rotate(elbow_rotation(pose)).m);
+
+            draw_joint(meshes.joint);
+
+            // forearm
+            glTranslatef(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
+            glPushMatrix();
+            {
+                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
+                draw_link(meshes.link);
+            }
+            glPopMatrix();
+
+            // palm: top of forearm plus half the palm cube
+            glTranslatef(0.0f, cfg::ARM_L + 0.5f * cfg::PALM_SIZE, 0.0f);
+            meshes.palm.draw();
+
+            // fingers: 0 (center), 1 (left, front-right), 2 (left, back-right)
+            for (int i = 0; i < NUM_FINGERS; ++i)
+            {
+                draw_finger(finger_mount(i),
+                            fingers ? fingers[i] : finger_angles(i, pose.grip),
+                            meshes);
+            }
+        }
+        glPopMatrix();
+    }
+    glPopMatrix();
+}
+
+void arm::draw_scene(const Pose & pose, const mygllib::View & view,
+                     const ArmMeshes & meshes, const FingerAngles * fingers,
+                     const SceneDetail & detail)
+{
+    GL_SCOPE("draw_scene");
+    draw_static(pose, view, meshes, detail);
+    draw_moving(pose, view, meshes, fingers, detail);
+}
+
+void arm::draw_static(const Pose & pose, const mygllib::View & view,
+                      const ArmMeshes & meshes, const SceneDetail & detail)
+{
+    begin_scene(view, 20, detail.grid_step);
+
+    glPushMatrix();
+    {
+        glTranslatef(pose.xb, pose.yb, pose.zb);
+        glScalef(cfg::BASE_SX, cfg::BASE_SY, cfg::BASE_SZ);
+        draw_base(meshes.base);
+    }
+    glPopMatrix();
+}
+
+void arm::draw_moving(const Pose & pose, const mygllib::View & view,
+                      const ArmMeshes & meshes, const FingerAngles * fingers,
+                      const SceneDetail & detail)
+{
+    camera_and_light(view);
+    draw_arm(pose, meshes, fingers);
+
+    if (detail.shadows)
+    {
+        begin_shadow();
+        draw_arm(pose, meshes, fingers);
+        end_shadow();
+    }
+}
+
+void arm::draw_fleet(const FleetState & state, const mygllib::View & view,
+                     const ArmMeshes & meshes, const SceneDetail & detail)
+{
+    GL_SCOPE("draw_fleet");
+    GLfloat extent = 20.0f;
+    for (size_t k = 0; k < state.size(); ++k)
+    {
+        extent = std::max(extent, std::fabs(state.x[k]) + cfg::FLEET_SPACING);
+        extent = std::max(extent, std::fabs(state.z[k]) + cfg::FLEET_SPACING);
+    }
+    begin_scene(view, int(std::ceil(extent)), detail.grid_step);
+
+    for (size_t k = 0; k < state.size(); ++k)
+    {
+        const Pose pose = state.pose(k);
+        glPushMatrix();
+        {
+            glTranslatef(pose.xb, pose.yb, pose.zb);
+            glPushMatrix();
+            glScalef(cfg::BASE_SX, cfg::BASE_SY, cfg::BASE_SZ);
+            draw_base(meshes.base);
+            glPopMatrix();
+
+            draw_arm(pose, meshes);
+        }
+        glPopMatrix();
+    }
+
+    if (!detail.shadows) return;
+    begin_shadow();
+    for (size_t k = 0; k < state.size(); ++k)
+    {
+        const Pose pose = state.pose(k);
+        glPushMatrix();
+        glTranslatef(pose.xb, pose.yb, pose.zb);
+        draw_arm(pose, meshes);
+        glPopMatrix();
+    }
+    end_shadow();
+}
+
+void arm::draw_grasp(const GraspObject & obj, const Grasp & grasp,
+                     const ArmMeshes & meshes)
+{
+    if (obj.shape == GraspObject::NONE) return;
+    GL_SCOPE("draw_grasp");
+
+    mygllib::Material(cfg::MAT_GRASP).set();
+    glPushMatrix();
+    switch (obj.shape)
+    {
+        case GraspObject::SPHERE:
+        {
+            const Sphere & s = obj.sphere;
+            glTranslatef(s.c.x, s.c.y, s.c.z);
+            glScalef(s.r, s.r, s.r);
+            meshes.ball.draw();
+            break;
+        }
+        case GraspObject::BOX:
+        {
+            const Vec3 c = (obj.box.lo + obj.box.hi) * 0.5f;
+            const Vec3 d = obj.box.hi - obj.box.lo;
+            glTranslatef(c.x, c.y, c.z);
+            glScalef(d.x, d.y, d.z);
+            meshes.block.draw();
+            break;
+        }
+        case GraspObject::CAPSULE:
+        {
+            const Capsule & c = obj.capsule;
+            const Vec3 axis = c.b - c.a;
+            const GLfloat len = length(axis);
+            // rotate the rod's +Z onto the axis
+            const Vec3 z(0.0f, 0.0f, 1.0f);
+            const Vec3 n = cross(z, axis);
+            glTranslatef(c.a.x, c.a.y, c.a.z);
+            if (length(n) > 1e-6f)
+                glRotatef(mygllib::rad2deg(std::atan2(length(n), dot(z, axis))),
+                          n.x, n.y, n.z);
+            else if (axis.z < 0.0f)
+                glRotatef(180.0f, 1.0f, 0.0f, 0.0f);
+            glPushMatrix();
+            glScalef(c.r, c.r, len);
+            meshes.rod.draw();
+            glPopMatrix();
+            glScalef(c.r, c.r, c.r);
+            meshes.ball.draw();
+            glTranslatef(0.0f, 0.0f, len / c.r);
+            meshes.ball.draw();
+            break;
+        }
+        default:
+            break;
+    }
+    glPopMatrix();
+
+    mygllib::Material(cfg::MAT_CONTACT).set();
+    for (int i = 0; i < NUM_FINGERS; ++i)
+    {
+        const FingerContact & fc = grasp.finger[i];
+        for (int k = 0; k < 2; ++k)
+        {
+            if (!(fc.touching & (k == 0 ? FingerContact::PROXIMAL
+                                        : FingerContact::DISTAL)))
+                continue;
+            const Vec3 & p = fc.point[k];
+            glPushMatrix();
+            glTranslatef(p.x, p.y, p.z);
+            glScalef(cfg::CONTACT_R, cfg::CONTACT_R, cfg::CONTACT_R);
+            meshes.ball.draw();
+            glPopMatrix();
+        }
+    }
+}
+
+void arm::draw_manipulability(const Vec3 & palm, const Manipulability & m,
+                              const ArmMeshes & meshes)
+{
+    GL_SCOPE("draw_manipulability");
+    // columns: ellipsoid axes scaled by their radii
+    Mat4 t = Mat4::translate(palm.x, palm.y, palm.z);
+    for (int k = 0; k < 3; ++k)
+    {
+        const Vec3 a = m.ellipsoid_axis[k]
+                     * (m.ellipsoid_radius[k] * cfg::ELLIPSOID_SCALE);
+        t(0, k) = a.x;
+        t(1, k) = a.y;
+        t(2, k) = a.z;
+    }
+
+    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_POLYGON_BIT);
+    glDisable(GL_LIGHTING);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glColor3fv(m.near_singular ? cfg::ELLIPSOID_WARN : cfg::ELLIPSOID_OK);
+    glPushMatrix();
+    glMultMatrixf(t.m);
+    meshes.ball.draw();
+    glPopMatrix();
+    glPopAttrib();
+}
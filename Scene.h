@@ -0,0 +1,100 @@
+// File  : Scene.h
+// Author: Cole Schwandt
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "View.h"
+#include "Mesh.h"
+#include "Grasp.h"
+#include "Jacobian.h"
+#include "Fleet.h"
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // ArmMeshes
+    //
+    // Every primitive the arm is drawn with, tessellated once at one level
+    // of detail. Immutable after construction, so one instance can be
+    // shared by all windows, offscreen contexts and threads.
+    //-------------------------------------------------------------------------
+    class ArmMeshes
+    {
+    public:
+        ArmMeshes(GLint slices=cfg::SLICES, GLint stacks=cfg::STACKS);
+
+        mygllib::Mesh base;          // unit cube, scaled by BASE_S*
+        mygllib::Mesh joint;         // shoulder/elbow sphere
+        mygllib::Mesh link;          // upper arm/forearm cylinder
+        mygllib::Mesh palm;
+        mygllib::Mesh finger_joint;
+        mygllib::Mesh digit;         // phalanx cylinder
+
+        // unit primitives for grasp objects, scaled when drawn
+        mygllib::Mesh ball;
+        mygllib::Mesh block;
+        mygllib::Mesh rod;           // r=1, z=0..1
+    };
+
+    //-------------------------------------------------------------------------
+    // SceneDetail
+    //
+    // What draw_scene() and draw_fleet() draw around the arms, for trading
+    // looks for frame time: the floor grid's line spacing (scene units) and
+    // planar shadows of the arms cast on the floor by the scene light.
+    //-------------------------------------------------------------------------
+    struct SceneDetail
+    {
+        int grid_step;
+        bool shadows;
+    };
+    const SceneDetail DEFAULT_DETAIL = { 1, false };
+
+    // GL state the scene expects (clear color, light, depth test). Call once
+    // per context.
+    void init_scene();
+
+    // Clears and draws the whole frame for pose as seen from view: grid,
+    // axes, base and arm. Does not swap. fingers, if given, overrides the
+    // grip blend as in forward_kinematics().
+    void draw_scene(const Pose & pose, const mygllib::View & view,
+                    const ArmMeshes & meshes,
+                    const FingerAngles * fingers=NULL,
+                    const SceneDetail & detail=DEFAULT_DETAIL);
+
+    // The two halves of draw_scene(), for callers that keep the first
+    // between frames: draw_static() clears and draws what only changes
+    // with the camera or the base (grid, axes, base); draw_moving() sets
+    // the camera and light and draws the arm and its shadow over whatever
+    // the buffers hold.
+    void draw_static(const Pose & pose, const mygllib::View & view,
+                     const ArmMeshes & meshes,
+                     const SceneDetail & detail=DEFAULT_DETAIL);
+    void draw_moving(const Pose & pose, const mygllib::View & view,
+                     const ArmMeshes & meshes,
+                     const FingerAngles * fingers=NULL,
+                     const SceneDetail & detail=DEFAULT_DETAIL);
+
+    // Clears and draws every arm of a fleet tick at its station, on a grid
+    // that covers the whole cell. Does not swap.
+    void draw_fleet(const FleetState & state, const mygllib::View & view,
+                    const ArmMeshes & meshes,
+                    const SceneDetail & detail=DEFAULT_DETAIL);
+
+    // Just the arm (shoulder to fingertips) in the current modelview frame.
+    void draw_arm(const Pose & pose, const ArmMeshes & meshes,
+                  const FingerAngles * fingers=NULL);
+
+    // The object (nothing for NONE) and, as small markers, the contacts of
+    // grasp. Call after draw_scene().
+    void draw_grasp(const GraspObject & obj, const Grasp & grasp,
+                    const ArmMeshes & meshes);
+
+    // Wireframe velocity ellipsoid of m centered on the palm; red when
+    // near a singularity.
+    void draw_manipulability(const Vec3 & palm, const Manipulability & m,
+                             const ArmMeshes & meshes);
+}
+
+#endif
@@ -0,0 +1,114 @@
+// File  : Script.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <cmath>
+#include "Script.h"
+
+namespace
+{
+    // degrees a ball joint turns going from a to b
+    float turn_deg(const arm::Quat & a, const arm::Quat & b)
+    {
+        const float d = std::min(1.0f, std::fabs(mygllib::dot(a, b)));
+        return mygllib::rad2deg(2.0f * std::acos(d));
+    }
+}
+
+arm::Motion arm::move_to(const Pose & pose)
+{
+    Motion m = { Motion::MOVE, pose, 0.0f, 0.0f };
+    return m;
+}
+
+arm::Motion arm::grip_to(float grip)
+{
+    Motion m = { Motion::GRIP, Pose(), std::max(0.0f, std::min(1.0f, grip)),
+                 0.0f };
+    return m;
+}
+
+arm::Motion arm::sleep(float ms)
+{
+    Motion m = { Motion::SLEEP, Pose(), 0.0f, ms * 1e-3f };
+    return m;
+}
+
+void arm::Script::promise_type::begin(const Motion & m)
+{
+    motion = m;
+    from = *pose;
+    t = 0.0f;
+    switch (m.kind)
+    {
+        case Motion::MOVE:
+        {
+            // joints only: grip and base stay where they are
+            motion.to.grip = from.grip;
+            motion.to.xb = from.xb;
+            motion.to.yb = from.yb;
+            motion.to.zb = from.zb;
+            const float deg = std::max(
+                turn_deg(shoulder_rotation(from), shoulder_rotation(m.to)),
+                turn_deg(elbow_rotation(from), elbow_rotation(m.to)));
+            duration = deg / cfg::SCRIPT_JOINT_SPEED;
+            break;
+        }
+        case Motion::GRIP:
+            duration = std::fabs(m.grip - from.grip) / cfg::SCRIPT_GRIP_SPEED;
+            break;
+        case Motion::SLEEP:
+            duration = m.seconds;
+            break;
+        default:
+            duration = 0.0f;
+            break;
+    }
+}
+
+bool arm::Script::promise_type::advance(float dt)
+{
+    t += dt;
+    const float s = duration > 0.0f ? std::min(1.0f, t / duration) : 1.0f;
+    if (motion.kind == Motion::MOVE)
+    {
+        *pose = slerp(from, motion.to, s * s * (3.0f - 2.0f * s));   // ease
+    }
+    else if (motion.kind == Motion::GRIP)
+    {
+        pose->grip = from.grip + s * (motion.grip - from.grip);
+    }
+    return t >= duration;
+}
+
+void arm::ScriptRunner::start(Script && s)
+{
+    scripts_.push_back(s.h_);
+    s.h_ = Script::Handle();
+}
+
+void arm::ScriptRunner::tick(float dt)
+{
+    for (size_t i = 0; i < scripts_.size(); )
+    {
+        Script::Handle h = scripts_[i];
+        if (h.promise().advance(dt))
+        {
+            h.resume();                 // to its next co_await, or the end
+            if (h.done())
+            {
+                h.destroy();
+                scripts_[i] = scripts_.back();
+                scripts_.pop_back();
+                continue;
+            }
+        }
+        ++i;
+    }
+}
+
+void arm::ScriptRunner::stop()
+{
+    for (size_t i = 0; i < scripts_.size(); ++i) scripts_[i].destroy();
+    scripts_.clear();
+}
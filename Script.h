@@ -0,0 +1,156 @@
+// File  : Script.h
+// Author: Cole Schwandt
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <coroutine>
+#include <exception>
+#include <vector>
+#include "Kinematics.h"
+
+namespace cfg
+{
+    const float SCRIPT_JOINT_SPEED = 90.0f;  // deg/s
+    const float SCRIPT_GRIP_SPEED  = 2.0f;   // full grip per s
+}
+
+namespace arm
+{
+    //-------------------------------------------------------------------------
+    // Motions a script waits on. Each one starts from wherever the arm is
+    // when the script reaches it:
+    //
+    //   move_to(pose)   both ball joints slerp to those of pose (grip and
+    //                   base stay), eased, at SCRIPT_JOINT_SPEED on the
+    //                   joint that turns furthest
+    //   grip_to(grip)   the grip goes to grip (0 open .. 1 closed) at
+    //                   SCRIPT_GRIP_SPEED
+    //   sleep(ms)       nothing moves for ms
+    //-------------------------------------------------------------------------
+    struct Motion
+    {
+        enum Kind { START, MOVE, GRIP, SLEEP };
+
+        Kind kind;
+        Pose to;                        // MOVE
+        float grip;                     // GRIP
+        float seconds;                  // SLEEP
+
+        bool await_ready() const { return false; }
+        template < typename Handle >
+        void await_suspend(Handle h) const { h.promise().begin(*this); }
+        void await_resume() const {}
+    };
+
+    Motion move_to(const Pose & pose);
+    Motion grip_to(float grip);
+    Motion sleep(float ms);
+
+    //-------------------------------------------------------------------------
+    // Script
+    //
+    // A motion script: a C++20 coroutine that drives one arm's Pose and
+    // suspends on each motion until the arm has made it. A script is a
+    // function returning arm::Script whose first parameter is the Pose it
+    // drives; the caller keeps that Pose alive and draws or simulates from
+    // it. Calling the function only creates the script (its coroutine
+    // frame, the one heap allocation it makes); it runs once handed to a
+    // ScriptRunner.
+    //
+    // USAGE:
+    // arm::Script pick(arm::Pose & arm, arm::Pose at, arm::Pose above)
+    // {
+    //     co_await arm::move_to(at);
+    //     co_await arm::grip_to(1.0f);
+    //     co_await arm::sleep(500);
+    //     co_await arm::move_to(above);
+    // }
+    //
+    // runner.start(pick(pose, at, above));
+    //-------------------------------------------------------------------------
+    class Script
+    {
+    public:
+        struct promise_type
+        {
+            template < typename... Args >
+            promise_type(Pose & pose, Args &&...)
+                : pose(&pose), from(pose), t(0.0f), duration(0.0f)
+            {
+                motion.kind = Motion::START;
+            }
+
+            Script get_return_object()
+            {
+                return Script(std::coroutine_handle< promise_type >::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+
+            // called by co_await: the motion starts from the arm's pose now
+            void begin(const Motion & m);
+            // dt seconds into the motion; true once it is made
+            bool advance(float dt);
+
+            Pose * pose;                // the arm being driven
+            Motion motion;
+            Pose from;
+            float t, duration;
+        };
+        typedef std::coroutine_handle< promise_type > Handle;
+
+        Script(Script && s) : h_(s.h_) { s.h_ = Handle(); }
+        ~Script()                      { if (h_) h_.destroy(); }
+
+    private:
+        explicit Script(Handle h) : h_(h) {}
+        Script(const Script &);
+        Script & operator=(const Script &);
+
+        Handle h_;
+        friend class ScriptRunner;
+    };
+
+    //-------------------------------------------------------------------------
+    // ScriptRunner
+    //
+    // Runs any number of scripts on the caller's simulation tick, with no
+    // threads: tick(dt) moves every script's arm dt further into its
+    // current motion and resumes the scripts whose motion is done, up to
+    // their next co_await. A finished script's frame is freed right away.
+    // Ticking allocates nothing, so thousands of scripts (one per arm of a
+    // fleet) cost only their motions.
+    //
+    // USAGE:
+    // arm::ScriptRunner runner;
+    // runner.start(pick(pose, at, above));
+    // void tick()
+    // {
+    //     runner.tick(0.001f);
+    //     ... use pose ...
+    // }
+    //-------------------------------------------------------------------------
+    class ScriptRunner
+    {
+    public:
+        ScriptRunner(size_t capacity=16) { scripts_.reserve(capacity); }
+        ~ScriptRunner()                  { stop(); }
+
+        void start(Script && s);
+        void tick(float dt);
+        void stop();                    // drops every script where it is
+
+        size_t running() const { return scripts_.size(); }
+
+    private:
+        ScriptRunner(const ScriptRunner &);
+        ScriptRunner & operator=(const ScriptRunner &);
+
+        std::vector< Script::Handle > scripts_;
+    };
+}
+
+#endif
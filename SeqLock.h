@@ -0,0 +1,48 @@
+// File  : SeqLock.h
+// Author: Cole Schwandt
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // Single-writer seqlock helpers for plain-data payloads that live next
+    // to their sequence counter (usually in shared memory). seq is odd while
+    // a write is in progress. Readers never block the writer.
+    //
+    // USAGE:
+    // seq_write(block->seq, block->data, sample);   // writer
+    //
+    // uint32_t s;
+    // if (seq_try_read(block->seq, block->data, copy, s)) ...  // reader
+    //-------------------------------------------------------------------------
+    template < typename T >
+    void seq_write(std::atomic< uint32_t > & seq, T & dst, const T & src)
+    {
+        const uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&dst, &src, sizeof(T));
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Returns false if a write is in progress or raced the copy; the caller
+    // decides whether to retry now or next time.
+    template < typename T >
+    bool seq_try_read(const std::atomic< uint32_t > & seq, const T & src,
+                      T & dst, uint32_t & s)
+    {
+        s = seq.load(std::memory_order_acquire);
+        if (s & 1) return false;
+        memcpy(&dst, &src, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq.load(std::memory_order_relaxed) == s;
+    }
+}
+
+#endif
@@ -0,0 +1,493 @@
+// File  : Shard.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <csignal>
+#include <new>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Clock.h"
+#include "Shard.h"
+
+namespace
+{
+    const float UNPACED_DT = 0.01f;         // sim step when period_ns is 0
+    const int BARRIER_SPIN = 2000;          // polls before sleeping
+    const long BARRIER_SLEEP_NS = 10000000; // then rechecks stop
+    const size_t MAX_SAMPLES = 1 << 20;     // tick times kept for stats
+
+    //==============================================================
+    // Shared memory layout:
+    // Header | ShardRecord x shards | SlotTotals x 2 x shards
+    //        | ArmSlot x 2 x arms
+    //==============================================================
+    struct Header
+    {
+        alignas(64) std::atomic< uint32_t > arrived;
+        alignas(64) std::atomic< uint32_t > generation;   // futex word
+        alignas(64) std::atomic< uint32_t > stop;
+        uint32_t shards;
+        uint32_t threads;
+        uint32_t seed;
+        uint64_t arms;
+        uint64_t ticks;
+        int64_t period_ns;
+        int64_t start_ns;
+    };
+
+    struct ShardRecord
+    {
+        alignas(64) std::atomic< uint64_t > started;      // last tick begun
+        std::atomic< uint64_t > completed;                // last tick written
+        std::atomic< int64_t > tick_ns;                   // of the last tick
+        std::atomic< int64_t > wait_ns;
+        uint64_t begin, end;                              // owned arms
+        arm::ShardStats stats;                            // written at exit
+    };
+
+    // a shard's share of one tick's fleet-wide numbers
+    struct SlotTotals
+    {
+        double t;
+        uint32_t candidate_pairs, contact_pairs;
+        double broadphase_ms, narrow_ms;
+    };
+
+    struct ArmSlot
+    {
+        GLfloat channel[arm::BLEND_CHANNELS];
+        GLfloat palm[3];
+        unsigned char colliding, touching;
+        arm::ArmShapes shapes;              // boundary arms only
+        arm::Box base;
+    };
+
+    struct Block
+    {
+        Header * h;
+        ShardRecord * shard;
+        SlotTotals * totals;                // [slot * shards + i]
+        ArmSlot * arm;                      // [slot * arms + k]
+    };
+
+    size_t align64(size_t n)
+    {
+        return (n + 63) & ~size_t(63);
+    }
+
+    // offsets of the parts and the total size
+    size_t layout(size_t arms, int shards, size_t offset[4])
+    {
+        offset[0] = 0;
+        offset[1] = align64(offset[0] + sizeof(Header));
+        offset[2] = align64(offset[1] + shards * sizeof(ShardRecord));
+        offset[3] = align64(offset[2] + 2 * shards * sizeof(SlotTotals));
+        return align64(offset[3] + 2 * arms * sizeof(ArmSlot));
+    }
+
+    Block block(void * p, size_t arms, int shards)
+    {
+        size_t offset[4];
+        layout(arms, shards, offset);
+        char * base = static_cast< char * >(p);
+        Block b;
+        b.h = reinterpret_cast< Header * >(base + offset[0]);
+        b.shard = reinterpret_cast< ShardRecord * >(base + offset[1]);
+        b.totals = reinterpret_cast< SlotTotals * >(base + offset[2]);
+        b.arm = reinterpret_cast< ArmSlot * >(base + offset[3]);
+        return b;
+    }
+
+    void futex_wake(std::atomic< uint32_t > & word)
+    {
+        syscall(SYS_futex, reinterpret_cast< uint32_t * >(&word), FUTEX_WAKE,
+                INT32_MAX, NULL, NULL, 0);
+    }
+
+    void futex_wait(std::atomic< uint32_t > & word, uint32_t value)
+    {
+        const timespec timeout = { 0, BARRIER_SLEEP_NS };
+        syscall(SYS_futex, reinterpret_cast< uint32_t * >(&word), FUTEX_WAIT,
+                value, &timeout, NULL, 0);
+    }
+
+    // Every shard waits here until all have arrived. Spins briefly (a
+    // shard on its own core is usually just behind), then sleeps on the
+    // generation word. False if the fleet is stopping: a shard that has
+    // exited will never arrive.
+    bool barrier(Header & h)
+    {
+        const uint32_t g = h.generation.load(std::memory_order_acquire);
+        if (h.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == h.shards)
+        {
+            h.arrived.store(0, std::memory_order_relaxed);
+            h.generation.fetch_add(1, std::memory_order_release);
+            futex_wake(h.generation);
+            return true;
+        }
+        for (int spin = 0; h.generation.load(std::memory_order_acquire) == g;
+             ++spin)
+        {
+            if (h.stop.load(std::memory_order_relaxed)) return false;
+            if (spin >= BARRIER_SPIN) futex_wait(h.generation, g);
+        }
+        return true;
+    }
+
+    struct Bounds
+    {
+        GLfloat x0, z0, x1, z1;
+    };
+
+    // stations of arms [begin, end), grown by the touch range
+    Bounds reach(size_t arms, size_t begin, size_t end)
+    {
+        Bounds b = { 1e30f, 1e30f, -1e30f, -1e30f };
+        for (size_t k = begin; k < end; ++k)
+        {
+            GLfloat x, z;
+            arm::fleet_station(arms, k, x, z);
+            b.x0 = std::min(b.x0, x);
+            b.z0 = std::min(b.z0, z);
+            b.x1 = std::max(b.x1, x);
+            b.z1 = std::max(b.z1, z);
+        }
+        const GLfloat range = cfg::FLEET_TOUCH_RANGE();
+        b.x0 -= range;
+        b.z0 -= range;
+        b.x1 += range;
+        b.z1 += range;
+        return b;
+    }
+
+    bool inside(const Bounds & b, GLfloat x, GLfloat z)
+    {
+        return b.x0 <= x && x <= b.x1 && b.z0 <= z && z <= b.z1;
+    }
+
+    double ms(int64_t ns)
+    {
+        return mygllib::ns_to_ms(ns);
+    }
+
+    //==============================================================
+    // A shard process: steps its arms until told to stop
+    //==============================================================
+    void run_shard(const Block & b, int me)
+    {
+        Header & h = *b.h;
+        ShardRecord & rec = b.shard[me];
+        const size_t n = h.arms;
+        arm::Fleet fleet(n, rec.begin, rec.end, h.seed);
+        mygllib::WorkPool pool(h.threads);
+
+        // arms of other shards that can reach ours, and ours that can
+        // reach theirs
+        std::vector< uint32_t > imports, exports;
+        std::vector< Bounds > bounds(h.shards);
+        for (uint32_t i = 0; i < h.shards; ++i)
+            bounds[i] = reach(n, b.shard[i].begin, b.shard[i].end);
+        for (size_t k = 0; k < n; ++k)
+        {
+            GLfloat x, z;
+            arm::fleet_station(n, k, x, z);
+            if (!fleet.owns(k))
+            {
+                if (inside(bounds[me], x, z)) imports.push_back(uint32_t(k));
+                continue;
+            }
+            for (uint32_t i = 0; i < h.shards; ++i)
+            {
+                if (int(i) != me && inside(bounds[i], x, z))
+                {
+                    exports.push_back(uint32_t(k));
+                    break;
+                }
+            }
+        }
+
+        const float dt = h.period_ns > 0 ? h.period_ns * 1e-9f : UNPACED_DT;
+        std::vector< double > ticks;
+        uint64_t run = 0;
+        double compute = 0.0, exchange = 0.0, wait = 0.0;
+
+        if (!barrier(h)) return;                // start together
+        for (uint64_t t = 1; h.ticks == 0 || t <= h.ticks; ++t)
+        {
+            if (h.stop.load(std::memory_order_relaxed)) break;
+            if (h.period_ns > 0)
+            {
+                const int64_t wake = h.start_ns + int64_t(t) * h.period_ns;
+                const int64_t now = mygllib::now_ns();
+                if (wake > now)
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(wake - now));
+            }
+
+            const int64_t t0 = mygllib::now_ns();
+            rec.started.store(t, std::memory_order_release);
+            ArmSlot * slot = b.arm + (t % 2) * n;
+            fleet.move(pool, dt);
+            const int64_t t1 = mygllib::now_ns();
+            for (size_t i = 0; i < exports.size(); ++i)
+            {
+                slot[exports[i]].shapes = fleet.shapes(exports[i]);
+                slot[exports[i]].base = fleet.base(exports[i]);
+            }
+            const int64_t t2 = mygllib::now_ns();
+            if (!barrier(h)) break;
+            const int64_t t3 = mygllib::now_ns();
+            for (size_t i = 0; i < imports.size(); ++i)
+            {
+                const ArmSlot & a = slot[imports[i]];
+                fleet.import(imports[i], a.shapes, a.base);
+            }
+            const int64_t t4 = mygllib::now_ns();
+            fleet.collide(pool);
+            fleet.acquire();
+            const int64_t t5 = mygllib::now_ns();
+
+            // own arms and totals for the viewer
+            const arm::FleetState & s = fleet.front();
+            for (size_t k = rec.begin; k < rec.end; ++k)
+            {
+                ArmSlot & a = slot[k];
+                for (int c = 0; c < arm::BLEND_CHANNELS; ++c)
+                    a.channel[c] = s.poses.channel[c][k];
+                for (int i = 0; i < 3; ++i) a.palm[i] = s.palm[i][k];
+                a.colliding = s.colliding[k];
+                a.touching = s.touching[k];
+            }
+            SlotTotals & tot = b.totals[(t % 2) * h.shards + me];
+            tot.t = s.t;
+            tot.candidate_pairs = s.candidate_pairs;
+            tot.contact_pairs = s.contact_pairs;
+            tot.broadphase_ms = s.broadphase_ms;
+            tot.narrow_ms = s.narrow_ms;
+            rec.completed.store(t, std::memory_order_release);
+            const int64_t t6 = mygllib::now_ns();
+
+            rec.tick_ns.store(t6 - t0, std::memory_order_relaxed);
+            rec.wait_ns.store(t3 - t2, std::memory_order_relaxed);
+            ++run;
+            if (ticks.size() < MAX_SAMPLES) ticks.push_back(ms(t6 - t0));
+            compute += ms((t1 - t0) + (t5 - t4));
+            exchange += ms((t2 - t1) + (t4 - t3) + (t6 - t5));
+            wait += ms(t3 - t2);
+        }
+
+        arm::ShardStats & st = rec.stats;
+        st.ticks = run;
+        st.arms = uint32_t(rec.end - rec.begin);
+        st.imported = uint32_t(imports.size());
+        st.exported = uint32_t(exports.size());
+        st.tick_mean = st.tick_p99 = st.tick_max = 0.0;
+        st.compute = st.exchange = st.wait = 0.0;
+        if (run == 0) return;
+        const double count = double(run);
+        st.tick_mean = (compute + exchange + wait) / count;
+        st.compute = compute / count;
+        st.exchange = exchange / count;
+        st.wait = wait / count;
+        std::sort(ticks.begin(), ticks.end());
+        st.tick_p99 = ticks[size_t(0.99 * (ticks.size() - 1))];
+        st.tick_max = ticks.back();
+    }
+}
+
+arm::ShardedFleet::ShardedFleet(size_t arms, int shards, int64_t period_ns,
+                                uint64_t ticks, int threads,
+                                unsigned int seed)
+    : n_(arms), shards_(shards), block_(NULL), bytes_(0)
+{
+    if (shards_ < 1) shards_ = 1;
+    if (size_t(shards_) > arms) shards_ = int(std::max(arms, size_t(1)));
+    shards = shards_;
+    size_t offset[4];
+    bytes_ = layout(arms, shards, offset);
+    block_ = mmap(NULL, bytes_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (block_ == MAP_FAILED)
+    {
+        block_ = NULL;
+        std::cout << "shards: cannot map " << bytes_ << " bytes: "
+                  << strerror(errno) << std::endl;
+        throw ShardError();
+    }
+    const Block b = block(block_, arms, shards);
+
+    Header * h = new (b.h) Header;
+    h->arrived.store(0);
+    h->generation.store(0);
+    h->stop.store(0);
+    h->shards = uint32_t(shards);
+    h->threads = uint32_t(std::max(threads, 1));
+    h->seed = seed;
+    h->arms = arms;
+    h->ticks = ticks;
+    h->period_ns = period_ns;
+    for (int i = 0; i < shards; ++i)
+    {
+        ShardRecord * rec = new (b.shard + i) ShardRecord;
+        rec->started.store(0);
+        rec->completed.store(0);
+        rec->tick_ns.store(0);
+        rec->wait_ns.store(0);
+        rec->begin = arms * i / shards;
+        rec->end = arms * (i + 1) / shards;
+        memset(&rec->stats, 0, sizeof(rec->stats));
+    }
+
+    // what acquire() fills in
+    front_.tick = 0;
+    front_.t = 0.0;
+    front_.x.resize(n_);
+    front_.z.resize(n_);
+    front_.poses.resize(n_);
+    for (int a = 0; a < 3; ++a) front_.palm[a].assign(n_, 0.0f);
+    front_.colliding.assign(n_, 0);
+    front_.touching.assign(n_, 0);
+    front_.candidate_pairs = front_.contact_pairs = 0;
+    front_.broadphase_ms = front_.narrow_ms = 0.0;
+    for (size_t k = 0; k < n_; ++k) fleet_station(n_, k, front_.x[k], front_.z[k]);
+
+    h->start_ns = mygllib::now_ns();
+    const pid_t parent = getpid();
+    for (int i = 0; i < shards; ++i)
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            // die with the viewer, however it ends (the check covers a
+            // parent gone before prctl)
+            if (prctl(PR_SET_PDEATHSIG, SIGKILL) < 0 || getppid() != parent)
+                _exit(1);
+            run_shard(b, i);
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            std::cout << "shards: fork failed: " << strerror(errno) << std::endl;
+            stop();
+            munmap(block_, bytes_);
+            throw ShardError();
+        }
+        pids_.push_back(pid);
+    }
+}
+
+arm::ShardedFleet::~ShardedFleet()
+{
+    stop();
+    munmap(block_, bytes_);
+}
+
+void arm::ShardedFleet::stop()
+{
+    const Block b = block(block_, n_, shards_);
+    b.h->stop.store(1);
+    futex_wake(b.h->generation);
+    wait();
+}
+
+void arm::ShardedFleet::wait()
+{
+    for (size_t i = 0; i < pids_.size(); ++i)
+    {
+        int status;
+        while (waitpid(pids_[i], &status, 0) < 0 && errno == EINTR)
+            ;
+    }
+    pids_.clear();
+}
+
+bool arm::ShardedFleet::acquire()
+{
+    const int shards = shards_;
+    const Block b = block(block_, n_, shards);
+
+    uint64_t done = UINT64_MAX;
+    for (int i = 0; i < shards; ++i)
+        done = std::min(done, b.shard[i].completed.load(std::memory_order_acquire));
+    if (done == 0 || done == front_.tick) return false;
+
+    const ArmSlot * slot = b.arm + (done % 2) * n_;
+    for (size_t k = 0; k < n_; ++k)
+    {
+        const ArmSlot & a = slot[k];
+        for (int c = 0; c < BLEND_CHANNELS; ++c)
+            front_.poses.channel[c][k] = a.channel[c];
+        for (int i = 0; i < 3; ++i) front_.palm[i][k] = a.palm[i];
+        front_.colliding[k] = a.colliding;
+        front_.touching[k] = a.touching;
+    }
+    const SlotTotals * tot = b.totals + (done % 2) * shards;
+    front_.t = tot[0].t;
+    front_.candidate_pairs = front_.contact_pairs = 0;
+    front_.broadphase_ms = front_.narrow_ms = 0.0;
+    for (int i = 0; i < shards; ++i)
+    {
+        front_.candidate_pairs += tot[i].candidate_pairs;
+        front_.contact_pairs += tot[i].contact_pairs;
+        front_.broadphase_ms = std::max(front_.broadphase_ms, tot[i].broadphase_ms);
+        front_.narrow_ms = std::max(front_.narrow_ms, tot[i].narrow_ms);
+    }
+
+    // a shard that has started tick done + 2 wrote this slot under us
+    std::atomic_thread_fence(std::memory_order_acquire);
+    for (int i = 0; i < shards; ++i)
+    {
+        if (b.shard[i].started.load(std::memory_order_relaxed) >= done + 2)
+            return false;
+    }
+    front_.tick = done;
+    return true;
+}
+
+void arm::ShardedFleet::last_tick(double & tick_ms, double & wait_ms) const
+{
+    const int shards = shards_;
+    const Block b = block(block_, n_, shards);
+    int64_t tick = 0, wait = 0;
+    for (int i = 0; i < shards; ++i)
+    {
+        tick = std::max(tick, b.shard[i].tick_ns.load(std::memory_order_relaxed));
+        wait += b.shard[i].wait_ns.load(std::memory_order_relaxed);
+    }
+    tick_ms = ms(tick);
+    wait_ms = ms(wait) / shards;
+}
+
+arm::ShardStats arm::ShardedFleet::stats(int shard) const
+{
+    return block(block_, n_, shards_).shard[shard].stats;
+}
+
+void arm::report(const ShardStats * stats, int shards, std::ostream & out)
+{
+    double tick = 0.0, p99 = 0.0, compute = 0.0, exchange = 0.0, wait = 0.0;
+    size_t imported = 0;
+    for (int i = 0; i < shards; ++i)
+    {
+        tick = std::max(tick, stats[i].tick_mean);
+        p99 = std::max(p99, stats[i].tick_p99);
+        compute += stats[i].compute / shards;
+        exchange += stats[i].exchange / shards;
+        wait += stats[i].wait / shards;
+        imported += stats[i].imported;
+    }
+    out << "shards: " << shards << " processes, tick " << tick << " ms (p99 "
+        << p99 << "), per shard: compute " << compute << " ms, exchange "
+        << exchange << " ms, barrier " << wait << " ms ("
+        << (tick > 0.0 ? 100.0 * (exchange + wait) / tick : 0.0)
+        << "% sync), " << imported / shards << " boundary arms in"
+        << std::endl;
+}
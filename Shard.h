@@ -0,0 +1,108 @@
+// File  : Shard.h
+// Author: Cole Schwandt
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <sys/types.h>
+#include "Fleet.h"
+
+namespace arm
+{
+    class ShardError
+    {};
+
+    //-------------------------------------------------------------------------
+    // ShardStats
+    //
+    // One shard process's timing over its run, in ms per tick. A tick is
+    // the lockstep period, from one barrier release to the next; it is
+    // spent computing (move() and collide()), exchanging (copying its own
+    // arms out and its neighbours' boundary arms in) and waiting at the
+    // barrier for the slowest shard.
+    //-------------------------------------------------------------------------
+    struct ShardStats
+    {
+        uint64_t ticks;
+        uint32_t arms;                  // owned
+        uint32_t imported;              // boundary arms read per tick
+        uint32_t exported;              // own arms other shards read
+        double tick_mean, tick_p99, tick_max;
+        double compute, exchange, wait; // means
+    };
+
+    //-------------------------------------------------------------------------
+    // ShardedFleet
+    //
+    // The Fleet split over `shards` child processes, each owning a band of
+    // consecutive arms (rows of stations) and stepping it in lockstep with
+    // the others. Everything goes through one shared memory mapping made
+    // before the fork:
+    //
+    //   - per arm, per tick parity, its pose, palm and collision flags (for
+    //     the viewer) and, for arms near another shard, its world-space
+    //     shapes (for that shard's pair tests);
+    //   - a barrier all shards pass once per tick, between writing their
+    //     own arms and reading their neighbours';
+    //   - per shard, the last tick it started and finished, and its stats.
+    //
+    // Tick t lives in slot t % 2, so a shard can start tick t + 1 while a
+    // slower one still reads tick t. The parent process is the viewer:
+    // acquire() copies the newest tick every shard has finished into
+    // front(), retrying if a shard overwrote it meanwhile, and never holds
+    // up the shards.
+    //
+    // Shards tick every period_ns (0: as fast as they can) and stop after
+    // `ticks` ticks (0: when the ShardedFleet is destroyed), or are killed
+    // when the parent process dies. Fork before the parent starts threads
+    // or a GL context.
+    //
+    // USAGE:
+    // arm::ShardedFleet fleet(5000, 8, 10000000);      // 100 Hz
+    // ...
+    // fleet.acquire();
+    // draw_fleet(fleet.front(), view, meshes);
+    //-------------------------------------------------------------------------
+    class ShardedFleet
+    {
+    public:
+        ShardedFleet(size_t arms, int shards, int64_t period_ns=0,
+                     uint64_t ticks=0, int threads=1, unsigned int seed=1);
+        ~ShardedFleet();
+
+        bool acquire();                 // true if front() changed
+        const FleetState & front() const { return front_; }
+
+        size_t size() const  { return n_; }
+        int shards() const   { return shards_; }
+
+        // last tick's time (slowest shard) and barrier wait (mean over
+        // the shards), in ms
+        void last_tick(double & tick_ms, double & wait_ms) const;
+
+        // Waits for every shard to exit (after `ticks` ticks); stop() first
+        // tells them to exit after their current tick. Stats are complete
+        // once either returns.
+        void wait();
+        void stop();
+        ShardStats stats(int shard) const;
+
+    private:
+        ShardedFleet(const ShardedFleet &);
+        ShardedFleet & operator=(const ShardedFleet &);
+
+        size_t n_;
+        int shards_;
+        void * block_;
+        size_t bytes_;
+        std::vector< pid_t > pids_;
+        FleetState front_;
+    };
+
+    void report(const ShardStats * stats, int shards, std::ostream & out);
+}
+
+#endif
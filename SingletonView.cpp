@@ -1,12 +1,11 @@
 // File  : SingletonView.cpp
 // Author: smaug
 
+#include "Windows.h"
 #include "SingletonView.h"
 
-mygllib::View * mygllib::SingletonView::instance_(new mygllib::View());
-
 
 mygllib::View * mygllib::SingletonView::getInstance()
 {
-    return instance_;
+    return &Windows::view();
 }
@@ -9,12 +9,11 @@
 
 namespace mygllib
 {
+    // The View of the current window (see Windows.h).
     class SingletonView
     {
     public:
         static mygllib::View * getInstance();
-    private:
-        static View * instance_;
     };
 }
 
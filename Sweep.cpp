@@ -0,0 +1,244 @@
+// File  : Sweep.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "Sweep.h"
+
+namespace
+{
+    // slerp falls back to nlerp for turns under ~3.6 degrees, which runs a
+    // hair faster than uniform mid-way; this covers it and float rounding
+    const float RATE_SLACK = 1.01f;
+
+    // radians a ball joint turns going from a to b
+    float turn_rad(const arm::Quat & a, const arm::Quat & b)
+    {
+        const float d = std::min(1.0f, std::fabs(mygllib::dot(a, b)));
+        return 2.0f * std::acos(d);
+    }
+
+    // How far, in radians, a segment turns each joint group per unit of s
+    struct Rates
+    {
+        float shoulder, elbow, fingers;
+    };
+
+    Rates rates(const arm::Pose & a, const arm::Pose & b)
+    {
+        Rates r;
+        r.shoulder = RATE_SLACK * turn_rad(arm::shoulder_rotation(a),
+                                           arm::shoulder_rotation(b));
+        r.elbow = RATE_SLACK * turn_rad(arm::elbow_rotation(a),
+                                        arm::elbow_rotation(b));
+
+        // finger angles are linear in the grip
+        r.fingers = 0.0f;
+        for (int i = 0; i < arm::NUM_FINGERS; ++i)
+        {
+            const FingerAngles f0 = arm::finger_angles(i, a.grip);
+            const FingerAngles f1 = arm::finger_angles(i, b.grip);
+            const float deg = std::fabs(f1.baseZ - f0.baseZ)
+                            + std::fabs(f1.jointZ - f0.jointZ)
+                            + std::fabs(f1.tipY - f0.tipY);
+            r.fingers = std::max(r.fingers, mygllib::deg2rad(deg));
+        }
+        r.fingers *= RATE_SLACK;
+        return r;
+    }
+
+    // furthest a capsule's axis gets from c (a sphere turning about its
+    // own center does not move)
+    float reach(const arm::Capsule & k, const arm::Vec3 & c)
+    {
+        return std::max(mygllib::length(k.a - c), mygllib::length(k.b - c));
+    }
+
+    // Grows every part by how far it can move within h of s either way;
+    // returns the largest growth. Distances from a joint to the parts it
+    // carries are taken as the longest they can get over the interval:
+    // the lengths of the rigid links in between, added up.
+    float grow(arm::ArmShapes & s, const Rates & r, float h)
+    {
+        const arm::Vec3 shoulder = s.shoulder.c, elbow = s.elbow.c;
+        const float ts = r.shoulder * h, te = r.elbow * h;
+        const float tf = r.fingers * h;
+
+        // rigid: shoulder to elbow, elbow to palm center
+        const float upper_l = mygllib::length(elbow - shoulder);
+        const float palm_l = mygllib::length(s.palm.c - elbow);
+
+        const float elbow_d = ts * upper_l;
+        const float upper_d = ts * reach(s.upper_arm, shoulder);
+        const float fore_d = ts * (upper_l + reach(s.forearm, elbow))
+                           + te * reach(s.forearm, elbow);
+        const float palm_d = ts * (upper_l + palm_l) + te * palm_l;
+        s.elbow.r += elbow_d;
+        s.upper_arm.r += upper_d;
+        s.forearm.r += fore_d;
+        s.palm.r += palm_d;
+
+        float most = std::max(std::max(elbow_d, upper_d),
+                              std::max(fore_d, palm_d));
+        for (int i = 0; i < arm::NUM_FINGERS; ++i)
+        {
+            // the proximal digit stays within one digit of its knuckle,
+            // the distal one within two
+            const float knuckle_l = mygllib::length(s.proximal[i].a - s.palm.c);
+            arm::Capsule * k[2] = { &s.proximal[i], &s.distal[i] };
+            for (int j = 0; j < 2; ++j)
+            {
+                const float finger_l = (j + 1) * cfg::FINGER_DIGIT_L;
+                const float from_elbow = palm_l + knuckle_l + finger_l;
+                const float d = ts * (upper_l + from_elbow)
+                              + te * from_elbow + tf * finger_l;
+                k[j]->r += d;
+                most = std::max(most, d);
+            }
+        }
+        return most;
+    }
+
+    // the base boxes at both ends of an interval and all in between
+    arm::Box hull(const arm::Box & p, const arm::Box & q)
+    {
+        arm::Box b = { arm::Vec3(std::min(p.lo.x, q.lo.x),
+                                 std::min(p.lo.y, q.lo.y),
+                                 std::min(p.lo.z, q.lo.z)),
+                       arm::Vec3(std::max(p.hi.x, q.hi.x),
+                                 std::max(p.hi.y, q.hi.y),
+                                 std::max(p.hi.z, q.hi.z)) };
+        return b;
+    }
+
+    bool blocked(const arm::ArmShapes & s, const arm::Box & base,
+                 const arm::Obstacles & obstacles)
+    {
+        return arm::in_collision(s, base) || arm::overlap(s, obstacles);
+    }
+
+    struct Interval
+    {
+        float s0, s1;
+        int depth;
+    };
+}
+
+bool arm::pose_blocked(const Pose & pose, const Obstacles & obstacles)
+{
+    Frames f;
+    ArmShapes s;
+    forward_kinematics(pose, f);
+    arm_shapes(f, s);
+    return blocked(s, base_box(pose), obstacles);
+}
+
+arm::SegmentCheck arm::segment_clear(const Pose & a, const Pose & b,
+                                     const Obstacles & obstacles)
+{
+    SegmentCheck check = { true, 0.0f, false, 0 };
+    const Rates r = rates(a, b);
+
+    // depth first, earlier half on top, so the first interval that cannot
+    // be cleared is the earliest one
+    Interval stack[cfg::SWEEP_MAX_DEPTH + 1];
+    int top = 0;
+    stack[top++] = Interval{ 0.0f, 1.0f, 0 };
+
+    Frames f;
+    ArmShapes shapes;
+    while (top > 0)
+    {
+        const Interval i = stack[--top];
+        const float mid = 0.5f * (i.s0 + i.s1);
+        const Pose pose = slerp(a, b, mid);
+        ++check.intervals;
+
+        forward_kinematics(pose, f);
+        arm_shapes(f, shapes);
+        const Box mid_base = base_box(pose);
+
+        ArmShapes grown = shapes;
+        const float most = grow(grown, r, 0.5f * (i.s1 - i.s0));
+        const Box base = hull(base_box(slerp(a, b, i.s0)),
+                              base_box(slerp(a, b, i.s1)));
+        if (!blocked(grown, base, obstacles)) continue;
+
+        check.s = mid;
+        if (blocked(shapes, mid_base, obstacles))
+        {
+            check.clear = false;
+            check.certain = true;
+            return check;
+        }
+        if (most < cfg::SWEEP_TOLERANCE || i.depth == cfg::SWEEP_MAX_DEPTH)
+        {
+            check.clear = false;
+            return check;
+        }
+        stack[top++] = Interval{ mid, i.s1, i.depth + 1 };
+        stack[top++] = Interval{ i.s0, mid, i.depth + 1 };
+    }
+    return check;
+}
+
+arm::TrajectoryCheck arm::check_trajectory(const std::vector< Pose > & waypoints,
+                                           const Obstacles & obstacles,
+                                           mygllib::WorkPool * pool)
+{
+    TrajectoryCheck check = { true, 0, 0.0f, false, 0 };
+    if (waypoints.empty()) return check;
+    if (waypoints.size() == 1)
+    {
+        check.clear = !pose_blocked(waypoints[0], obstacles);
+        check.certain = !check.clear;
+        return check;
+    }
+
+    const size_t n = waypoints.size() - 1;
+    if (pool == NULL)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const SegmentCheck c = segment_clear(waypoints[i], waypoints[i + 1],
+                                                 obstacles);
+            check.intervals += c.intervals;
+            if (!c.clear)
+            {
+                check.clear = false;
+                check.segment = i;
+                check.s = c.s;
+                check.certain = c.certain;
+                break;
+            }
+        }
+        return check;
+    }
+
+    // segments after one already found blocked are skipped
+    std::vector< SegmentCheck > result(n, SegmentCheck{ true, 0.0f, false, 0 });
+    std::atomic< size_t > first(n);
+    pool->parallel_for(n, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (i > first.load(std::memory_order_relaxed)) continue;
+            result[i] = segment_clear(waypoints[i], waypoints[i + 1], obstacles);
+            if (result[i].clear) continue;
+            size_t seen = first.load();
+            while (i < seen && !first.compare_exchange_weak(seen, i)) {}
+        }
+    });
+
+    for (size_t i = 0; i < n; ++i) check.intervals += result[i].intervals;
+    if (first < n)
+    {
+        const SegmentCheck & c = result[first];
+        check.clear = false;
+        check.segment = first;
+        check.s = c.s;
+        check.certain = c.certain;
+    }
+    return check;
+}
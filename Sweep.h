@@ -0,0 +1,89 @@
+// File  : Sweep.h
+// Author: Cole Schwandt
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <vector>
+#include "Collision.h"
+#include "WorkPool.h"
+
+namespace arm
+{
+    // True if the arm at pose hits its base, itself or an obstacle.
+    bool pose_blocked(const Pose & pose, const Obstacles & obstacles);
+
+    //-------------------------------------------------------------------------
+    // Continuous (swept-volume) collision
+    //
+    // Between two waypoints a and b the arm moves along slerp(a, b, s),
+    // s in [0, 1]: each ball joint turns at a constant rate about a fixed
+    // axis, and grip and base move linearly. Checking only the waypoints,
+    // or poses a few degrees apart, misses an obstacle the hand passes
+    // through in between; at the end of the arm a 2 degree step is already
+    // wider than a finger.
+    //
+    // segment_clear() bounds the whole sweep instead. Over an interval of
+    // s, no point of the arm moves further from where it is at the
+    // interval's middle than
+    //
+    //   (half the shoulder's turn) * (its reach from the shoulder)
+    //   + (half the elbow's turn) * (its reach from the elbow)
+    //   + (half the finger joints' turn) * (its reach from the knuckle)
+    //
+    // where a reach is the sum of the rigid link lengths in between: the
+    // furthest the point can get from that joint however the joints
+    // after it turn. (A turn of t radians moves a point at distance d by
+    // at most t d.) So each part, grown by its own bound, covers
+    // everything the part sweeps, and the base's box at both ends covers
+    // the base. If the grown arm at the middle is clear, so is the
+    // interval. If not, the interval is halved, earliest half first, until
+    // a half is clear, the arm at a middle pose really is blocked, or the
+    // bound is under SWEEP_TOLERANCE (reported as blocked: the arm comes
+    // that close). A clear answer is therefore never wrong; a blocked one
+    // may be off by the tolerance.
+    //
+    // check_trajectory() checks every segment of a waypoint list, in
+    // parallel over segments, and reports the first one that is blocked.
+    //
+    // USAGE:
+    // arm::Obstacles obstacles;
+    // obstacles.capsules.push_back(pole);
+    // const arm::TrajectoryCheck c = arm::check_trajectory(waypoints,
+    //                                                      obstacles, &pool);
+    // if (!c.clear) ... segment c.segment is blocked at s = c.s ...
+    //-------------------------------------------------------------------------
+    struct SegmentCheck
+    {
+        bool clear;
+        float s;                        // if blocked: where (0..1)
+        bool certain;                   // if blocked: the pose at s is too
+        int intervals;                  // intervals tested
+    };
+
+    SegmentCheck segment_clear(const Pose & a, const Pose & b,
+                               const Obstacles & obstacles);
+
+    struct TrajectoryCheck
+    {
+        bool clear;
+        size_t segment;                 // first blocked (waypoint index)
+        float s;
+        bool certain;
+        size_t intervals;               // over all segments checked
+    };
+
+    // Serial without a pool. Waypoints before a blocked segment are
+    // always fully checked; later segments may be skipped.
+    TrajectoryCheck check_trajectory(const std::vector< Pose > & waypoints,
+                                     const Obstacles & obstacles,
+                                     mygllib::WorkPool * pool=NULL);
+}
+
+namespace cfg
+{
+    const float SWEEP_TOLERANCE = 1e-3f;     // scene units
+    const int SWEEP_MAX_DEPTH = 24;          // halvings of a segment
+}
+
+#endif
@@ -0,0 +1,84 @@
+// File  : Telemetry.cpp
+// Author: Cole Schwandt
+
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "SeqLock.h"
+#include "Telemetry.h"
+
+arm::TelemetryPublisher::TelemetryPublisher(const char * shm_name)
+    : shm_name_(shm_name), block_(NULL)
+{
+    const int fd = shm_open(shm_name, O_CREAT | O_RDWR, 0644);
+    if (fd >= 0 && ftruncate(fd, sizeof(TelemetryBlock)) == 0)
+    {
+        void * p = mmap(NULL, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) block_ = static_cast< TelemetryBlock * >(p);
+    }
+    if (fd >= 0) close(fd);
+
+    if (block_ == NULL)
+    {
+        std::cout << "telemetry: cannot map " << shm_name << std::endl;
+        return;
+    }
+    // a block left by a writer that died mid-write has an odd seq; start
+    // even so readers see settled samples again
+    block_->seq.store(0, std::memory_order_relaxed);
+    block_->magic = TelemetryBlock::MAGIC;
+    block_->version = TelemetryBlock::VERSION;
+    block_->sample_size = sizeof(TelemetrySample);
+}
+
+arm::TelemetryPublisher::~TelemetryPublisher()
+{
+    if (block_ != NULL)
+    {
+        munmap(block_, sizeof(TelemetryBlock));
+        shm_unlink(shm_name_);
+    }
+}
+
+void arm::TelemetryPublisher::publish(const TelemetrySample & sample)
+{
+    if (block_ == NULL) return;
+    mygllib::seq_write(block_->seq, block_->sample, sample);
+}
+
+arm::TelemetryReader::TelemetryReader(const char * shm_name)
+    : block_(NULL)
+{
+    const int fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd >= 0)
+    {
+        void * p = mmap(NULL, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED,
+                        fd, 0);
+        close(fd);
+        if (p != MAP_FAILED) block_ = static_cast< const TelemetryBlock * >(p);
+    }
+
+    if (block_ == NULL || block_->magic != TelemetryBlock::MAGIC
+        || block_->version != TelemetryBlock::VERSION
+        || block_->sample_size != sizeof(TelemetrySample))
+    {
+        if (block_ != NULL)
+            munmap(const_cast< TelemetryBlock * >(block_), sizeof(TelemetryBlock));
+        std::cout << "telemetry: no compatible block " << shm_name
+                  << " (is the visualizer running?)" << std::endl;
+        throw TelemetryError();
+    }
+}
+
+arm::TelemetryReader::~TelemetryReader()
+{
+    munmap(const_cast< TelemetryBlock * >(block_), sizeof(TelemetryBlock));
+}
+
+bool arm::TelemetryReader::try_read(TelemetrySample & sample) const
+{
+    uint32_t s;
+    return mygllib::seq_try_read(block_->seq, block_->sample, sample, s);
+}
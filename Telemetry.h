@@ -0,0 +1,109 @@
+// File  : Telemetry.h
+// Author: Cole Schwandt
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace arm
+{
+    class TelemetryError
+    {};
+
+    const char * const TELEMETRY_SHM_NAME = "/robotarm_telemetry";
+
+    //-------------------------------------------------------------------------
+    // TelemetrySample
+    //
+    // Live arm state for one sim tick. Poses are column-major 4x4 world
+    // transforms (same layout as Mat4 / glLoadMatrixf). Plain data only:
+    // readers may be built without any of the GL headers.
+    //-------------------------------------------------------------------------
+    struct TelemetrySample
+    {
+        uint64_t tick;
+        int64_t  stamp_ns;            // CLOCK_MONOTONIC
+        float    joints[6];           // shoulder p/y/r, elbow p/y/r (deg)
+        float    grip;
+        uint32_t collision;           // 1 if in_collision()
+        float    palm[16];
+        float    fingertip[3][16];
+
+        // grasp (all zero when there is no object)
+        float    closure[3];          // per finger, 0 = open .. 1 = closed
+        uint32_t touching[3];         // bit 0 proximal, bit 1 distal
+        float    contact[3][2][3];    // finger, phalanx, world xyz
+    };
+
+    //-------------------------------------------------------------------------
+    // TelemetryBlock
+    //
+    // Shared-memory layout. The header and the seqlock counter each get
+    // their own cache line so readers polling seq do not false-share with
+    // anything else; the payload starts on the next line. Bump VERSION
+    // whenever TelemetrySample changes.
+    //-------------------------------------------------------------------------
+    struct TelemetryBlock
+    {
+        static const uint32_t MAGIC   = 0x41524d54; // "ARMT"
+        static const uint32_t VERSION = 2;
+
+        alignas(64) uint32_t magic;
+        uint32_t version;
+        uint32_t sample_size;
+
+        alignas(64) std::atomic< uint32_t > seq;
+
+        alignas(64) TelemetrySample sample;
+    };
+
+    //-------------------------------------------------------------------------
+    // TelemetryPublisher (visualizer side, single writer)
+    //-------------------------------------------------------------------------
+    class TelemetryPublisher
+    {
+    public:
+        TelemetryPublisher(const char * shm_name=TELEMETRY_SHM_NAME);
+        ~TelemetryPublisher();
+
+        bool ok() const { return block_ != 0; }
+        void publish(const TelemetrySample & sample);
+
+    private:
+        TelemetryPublisher(const TelemetryPublisher &);
+        TelemetryPublisher & operator=(const TelemetryPublisher &);
+
+        const char * shm_name_;
+        TelemetryBlock * block_;
+    };
+
+    //-------------------------------------------------------------------------
+    // TelemetryReader
+    //
+    // Any number of readers may map the block. try_read() is wait-free:
+    // it makes one attempt and returns false on a torn read.
+    //
+    // USAGE:
+    // arm::TelemetryReader reader;
+    // arm::TelemetrySample s;
+    // while (!reader.try_read(s)) ++retries;
+    //-------------------------------------------------------------------------
+    class TelemetryReader
+    {
+    public:
+        TelemetryReader(const char * shm_name=TELEMETRY_SHM_NAME);
+        ~TelemetryReader();
+
+        bool try_read(TelemetrySample & sample) const;
+
+    private:
+        TelemetryReader(const TelemetryReader &);
+        TelemetryReader & operator=(const TelemetryReader &);
+
+        const TelemetryBlock * block_;
+    };
+}
+
+#endif
@@ -0,0 +1,173 @@
+// File  : TextBatch.cpp
+// Author: Cole Schwandt
+
+#define GL_GLEXT_PROTOTYPES
+#include <GL/freeglut.h>
+#include <GL/glext.h>
+#include "debug.h"
+#include "TextBatch.h"
+
+namespace
+{
+    // Glyphs are drawn into [-R, R]^2 while capturing; the tallest stroke
+    // glyph is about 120 units high and 105 wide.
+    const GLfloat R = 256.0f;
+    const GLint FEEDBACK_SIZE = 1 << 15;
+}
+
+mygllib::StrokeFont::StrokeFont(void * font, void (*draw)(void *, int))
+{
+    GLint vp[4];
+    glGetIntegerv(GL_VIEWPORT, vp);
+    std::vector< GLfloat > fb(FEEDBACK_SIZE);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(-R, R, -R, R, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+
+    for (int c = FIRST; c <= LAST; ++c)
+    {
+        glLoadIdentity();
+        glFeedbackBuffer(FEEDBACK_SIZE, GL_2D, &fb[0]);
+        glRenderMode(GL_FEEDBACK);
+        draw(font, c);
+
+        GLfloat m[16];
+        glGetFloatv(GL_MODELVIEW_MATRIX, m);
+        advance_[c - FIRST] = m[12];
+        const GLint n = glRenderMode(GL_RENDER);
+
+        // window coordinates back to font units
+        std::vector< GLfloat > & g = glyphs_[c - FIRST];
+        for (GLint i = 0; i < n; )
+        {
+            const GLint token = GLint(fb[i++]);
+            if (token == GL_LINE_TOKEN || token == GL_LINE_RESET_TOKEN)
+            {
+                for (int k = 0; k < 2; ++k, i += 2)
+                {
+                    g.push_back(((fb[i] - vp[0]) * 2.0f / vp[2] - 1.0f) * R);
+                    g.push_back(((fb[i + 1] - vp[1]) * 2.0f / vp[3] - 1.0f) * R);
+                }
+            }
+            else if (token == GL_POLYGON_TOKEN)
+            {
+                i += 1 + 2 * GLint(fb[i]);
+            }
+            else if (token == GL_PASS_THROUGH_TOKEN)
+            {
+                i += 1;
+            }
+            else                            // point, bitmap, pixel tokens
+            {
+                i += 2;
+            }
+        }
+    }
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+const std::vector< GLfloat > &
+mygllib::StrokeFont::glyph(unsigned char c) const
+{
+    if (c < FIRST || c > LAST) c = '?';
+    return glyphs_[c - FIRST];
+}
+
+GLfloat mygllib::StrokeFont::advance(unsigned char c) const
+{
+    if (c < FIRST || c > LAST) c = '?';
+    return advance_[c - FIRST];
+}
+
+mygllib::TextBatch::TextBatch(const StrokeFont & font)
+    : font_(font), n_(0), drawn_n_(0), dirty_(true), rebuilt_(0),
+      vbo_(0), vbo_bytes_(0)
+{}
+
+mygllib::TextBatch::~TextBatch()
+{
+    if (vbo_ != 0) glDeleteBuffers(1, &vbo_);
+}
+
+void mygllib::TextBatch::begin()
+{
+    n_ = 0;
+    rebuilt_ = 0;
+}
+
+void mygllib::TextBatch::add(GLfloat x, GLfloat y, GLfloat scale,
+                             const std::string & s)
+{
+    if (n_ == labels_.size())
+    {
+        labels_.push_back(Label());
+        labels_.back().built = false;
+    }
+    Label & l = labels_[n_++];
+    if (l.built && l.s == s && l.x == x && l.y == y && l.scale == scale)
+        return;
+
+    l.s = s;
+    l.x = x;
+    l.y = y;
+    l.scale = scale;
+    l.vertices.clear();
+    GLfloat pen = 0.0f;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        const std::vector< GLfloat > & g = font_.glyph(s[i]);
+        for (size_t k = 0; k < g.size(); k += 2)
+        {
+            l.vertices.push_back(x + (pen + g[k]) * scale);
+            l.vertices.push_back(y + g[k + 1] * scale);
+        }
+        pen += font_.advance(s[i]);
+    }
+    l.built = true;
+    ++rebuilt_;
+    dirty_ = true;
+}
+
+void mygllib::TextBatch::draw()
+{
+    if (n_ != drawn_n_) dirty_ = true;
+    if (vbo_ == 0) glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+
+    if (dirty_)
+    {
+        vertices_.clear();
+        for (size_t i = 0; i < n_; ++i)
+            vertices_.insert(vertices_.end(), labels_[i].vertices.begin(),
+                             labels_[i].vertices.end());
+
+        const size_t bytes = vertices_.size() * sizeof(GLfloat);
+        if (bytes > vbo_bytes_)
+        {
+            vbo_bytes_ = 2 * bytes;
+            glBufferData(GL_ARRAY_BUFFER, vbo_bytes_, NULL, GL_DYNAMIC_DRAW);
+        }
+        if (bytes > 0)
+            GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, &vertices_[0]));
+        drawn_n_ = n_;
+        dirty_ = false;
+    }
+
+    if (!vertices_.empty())
+    {
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, 0);
+        GL_CALL(glDrawArrays(GL_LINES, 0, GLsizei(vertices_.size() / 2)));
+        glPopClientAttrib();
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,103 @@
+// File  : TextBatch.h
+// Author: Cole Schwandt
+
+#ifndef TEXTBATCH_H
+#define TEXTBATCH_H
+
+#include <string>
+#include <vector>
+#include <GL/freeglut.h>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // StrokeFont
+    //
+    // Line-segment geometry of the printable ASCII glyphs (32..126) of a
+    // stroke font, captured once with GL_FEEDBACK and kept on the CPU.
+    // draw is called as draw(font, c) and must draw glyph c with lines and
+    // advance the modelview like glutStrokeCharacter() does. Capturing
+    // needs a current context (and glutInit() for the GLUT fonts); the
+    // captured font is plain data and can be shared by any number of
+    // batches and contexts.
+    //-------------------------------------------------------------------------
+    class StrokeFont
+    {
+    public:
+        StrokeFont(void * font=GLUT_STROKE_ROMAN,
+                   void (*draw)(void *, int)=glutStrokeCharacter);
+
+        // x,y pairs, two per segment, in font units from the glyph origin
+        const std::vector< GLfloat > & glyph(unsigned char c) const;
+        GLfloat advance(unsigned char c) const;
+
+    private:
+        static const int FIRST = 32;
+        static const int LAST = 126;
+
+        std::vector< GLfloat > glyphs_[LAST - FIRST + 1];
+        GLfloat advance_[LAST - FIRST + 1];
+    };
+
+    //-------------------------------------------------------------------------
+    // TextBatch
+    //
+    // All strings of a frame in one vertex buffer, drawn with a single
+    // glDrawArrays(GL_LINES). Strings are added in the same order every
+    // frame; a string whose text, position and scale match the one added
+    // in its place last frame reuses its segments, and when nothing
+    // changed the buffer is not even re-uploaded.
+    //
+    // USAGE:
+    // mygllib::TextBatch batch(font);
+    // void display()
+    // {
+    //     batch.begin();
+    //     batch.add(10, 480, 0.1f, "title");       // window coordinates
+    //     batch.add(x, y, 0.1f, label);
+    //     ... pixel projection, color ...
+    //     batch.draw();
+    // }
+    //
+    // draw() must run in the context the batch was first drawn in.
+    //-------------------------------------------------------------------------
+    class TextBatch
+    {
+    public:
+        TextBatch(const StrokeFont & font);
+        ~TextBatch();
+
+        void begin();
+        void add(GLfloat x, GLfloat y, GLfloat scale, const std::string & s);
+        void draw();
+
+        // strings re-tessellated by the last begin()/add() round
+        size_t rebuilt() const { return rebuilt_; }
+        size_t vertex_count() const { return vertices_.size() / 2; }
+
+    private:
+        TextBatch(const TextBatch &);
+        TextBatch & operator=(const TextBatch &);
+
+        struct Label
+        {
+            std::string s;
+            GLfloat x, y, scale;
+            bool built;
+            std::vector< GLfloat > vertices;
+        };
+
+        const StrokeFont & font_;
+        std::vector< Label > labels_;   // slots are reused frame to frame
+        size_t n_;                      // slots used this frame
+        size_t drawn_n_;                // slots in the uploaded buffer
+        bool dirty_;
+        size_t rebuilt_;
+
+        std::vector< GLfloat > vertices_;
+        GLuint vbo_;
+        size_t vbo_bytes_;
+    };
+}
+
+#endif
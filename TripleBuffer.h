@@ -0,0 +1,69 @@
+// File  : TripleBuffer.h
+// Author: Cole Schwandt
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // TripleBuffer
+    //
+    // Hands whole frames of state from one writer thread to one reader
+    // thread without locks or copies. The writer fills back() and
+    // publish()es it; the reader's front() is the newest published frame
+    // and stays untouched until the reader calls acquire() again, however
+    // many frames the writer publishes meanwhile. Neither side ever waits.
+    //
+    // USAGE:
+    // mygllib::TripleBuffer< State > state;
+    // fill(state.back()); state.publish();          // writer
+    //
+    // state.acquire();                              // reader
+    // draw(state.front());
+    //-------------------------------------------------------------------------
+    template < typename T >
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer()
+            : back_(0), middle_(1), front_(2)
+        {}
+
+        T & back()              { return buf_[back_]; }
+        const T & front() const { return buf_[front_]; }
+        T & buffer(int i)       { return buf_[i]; }  // setup only
+
+        void publish()
+        {
+            back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel)
+                  & INDEX;
+        }
+
+        // false (and front() unchanged) if nothing new was published
+        bool acquire()
+        {
+            if (!(middle_.load(std::memory_order_relaxed) & FRESH))
+                return false;
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel)
+                   & INDEX;
+            return true;
+        }
+
+    private:
+        TripleBuffer(const TripleBuffer &);
+        TripleBuffer & operator=(const TripleBuffer &);
+
+        static const int INDEX = 3;
+        static const int FRESH = 4;
+
+        T buf_[3];
+        int back_;                  // writer's
+        std::atomic< int > middle_; // last published, FRESH until taken
+        int front_;                 // reader's
+    };
+}
+
+#endif
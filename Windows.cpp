@@ -0,0 +1,78 @@
+// File  : Windows.cpp
+// Author: Cole Schwandt
+
+#include <GL/freeglut.h>
+#include "Headless.h"
+#include "Windows.h"
+
+std::vector< mygllib::Windows::Window > mygllib::Windows::windows_;
+mygllib::Windows::Window mygllib::Windows::headless_ = { 0, View(), 1, 1 };
+
+int mygllib::Windows::open(const char * title, const View & view,
+                           int x, int y, int w, int h)
+{
+    if (!windows_.empty())
+        glutSetOption(GLUT_RENDERING_CONTEXT, GLUT_USE_CURRENT_CONTEXT);
+    glutInitWindowPosition(x, y);
+    glutInitWindowSize(w, h);
+
+    Window win = { glutCreateWindow(title), view, w, h };
+    win.view.aspect() = double(w) / h;
+    windows_.push_back(win);
+    return win.id;
+}
+
+mygllib::Windows::Window & mygllib::Windows::current()
+{
+    if (!HEADLESS && !windows_.empty())
+    {
+        const int id = glutGetWindow();
+        for (size_t i = 0; i < windows_.size(); ++i)
+        {
+            if (windows_[i].id == id) return windows_[i];
+        }
+    }
+    return headless_;
+}
+
+mygllib::View & mygllib::Windows::view()
+{
+    return current().view;
+}
+
+int mygllib::Windows::width()
+{
+    return current().w;
+}
+
+int mygllib::Windows::height()
+{
+    return current().h;
+}
+
+void mygllib::Windows::resize(int w, int h)
+{
+    Window & win = current();
+    win.w = w;
+    win.h = h;
+    win.view.aspect() = double(w) / h;
+}
+
+void mygllib::Windows::apply()
+{
+    const Window & win = current();
+    glViewport(0, 0, win.w, win.h);
+    win.view.set_projection();
+}
+
+void mygllib::Windows::redisplay()
+{
+    post_redisplay();
+}
+
+void mygllib::Windows::redisplay_all()
+{
+    if (HEADLESS) return;
+    for (size_t i = 0; i < windows_.size(); ++i)
+        glutPostWindowRedisplay(windows_[i].id);
+}
@@ -0,0 +1,80 @@
+// File  : Windows.h
+// Author: Cole Schwandt
+
+#ifndef WINDOWS_H
+#define WINDOWS_H
+
+#include <vector>
+#include "View.h"
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // Windows
+    //
+    // GLUT windows, each with its own View and size. The first window
+    // owns the GL context; every later window renders with that same
+    // context (GLUT_USE_CURRENT_CONTEXT), so meshes, materials, lights and
+    // buffers exist once whatever the number of windows. Viewport and
+    // projection are context state, so a display callback starts with
+    // apply() to put back its own window's.
+    //
+    // view(), width() and height() are those of the current GLUT window,
+    // which is the one an input or display callback was called for.
+    // Without windows (HEADLESS) they are one stand-in window, so the same
+    // callbacks also run offscreen.
+    //
+    // Redraws are posted per window: redisplay() for a change that only
+    // the current window sees (its camera), redisplay_all() for one that
+    // every window sees (the scene).
+    //
+    // USAGE:
+    // const int main = mygllib::Windows::open("arm", view, 0, 0, 400, 400);
+    // glutDisplayFunc(display);                // for the current window
+    // const int top = mygllib::Windows::open("overview", top_view, 420, 0,
+    //                                        300, 300);
+    // glutDisplayFunc(overview_display);
+    //
+    // void display()
+    // {
+    //     mygllib::Windows::apply();
+    //     ... draw with mygllib::Windows::view() ...
+    // }
+    //-------------------------------------------------------------------------
+    class Windows
+    {
+    public:
+        // Creates and makes current a window; returns its GLUT id.
+        static int open(const char * title, const View & view,
+                        int x, int y, int w, int h);
+
+        static View & view();
+        static int width();
+        static int height();
+        static size_t count() { return windows_.size(); }
+
+        // the current window's new size (from the reshape callback)
+        static void resize(int w, int h);
+
+        // viewport and projection of the current window
+        static void apply();
+
+        static void redisplay();
+        static void redisplay_all();
+
+    private:
+        struct Window
+        {
+            int id;
+            View view;
+            int w, h;
+        };
+
+        static Window & current();
+
+        static std::vector< Window > windows_;
+        static Window headless_;
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+// File  : WorkPool.cpp
+// Author: Cole Schwandt
+
+#include <algorithm>
+#include "WorkPool.h"
+
+mygllib::WorkPool::WorkPool(int threads)
+    : body_(NULL), remaining_(0), generation_(0), stop_(false)
+{
+    if (threads < 1) threads = 1;
+    for (int i = 0; i < threads; ++i) workers_.push_back(new Worker);
+    chunks_.assign(threads, 0);
+    steals_.assign(threads, 0);
+    for (int i = 1; i < threads; ++i)
+        threads_.push_back(std::thread(&WorkPool::run, this, i));
+}
+
+mygllib::WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard< std::mutex > lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i) threads_[i].join();
+    for (size_t i = 0; i < workers_.size(); ++i) delete workers_[i];
+}
+
+void mygllib::WorkPool::parallel_for(size_t n, size_t grain, const Body & body)
+{
+    if (n == 0) return;
+    if (grain < 1) grain = 1;
+    const int w = threads();
+    const size_t count = (n + grain - 1) / grain;
+
+    body_ = &body;
+    remaining_.store(count, std::memory_order_relaxed);
+    for (size_t c = 0; c < count; ++c)
+    {
+        Range r = { c * grain, std::min(n, (c + 1) * grain) };
+        Worker & worker = *workers_[c % w];
+        std::lock_guard< std::mutex > lock(worker.mutex);
+        worker.q.push_back(r);
+    }
+
+    if (w > 1)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            ++generation_;
+        }
+        wake_.notify_all();
+    }
+
+    drain(0);
+
+    // the last chunks may still be running on other workers
+    std::unique_lock< std::mutex > lock(mutex_);
+    done_.wait(lock, [this] { return remaining_.load() == 0; });
+    body_ = NULL;
+}
+
+void mygllib::WorkPool::run(int self)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock< std::mutex > lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        drain(self);
+    }
+}
+
+bool mygllib::WorkPool::pop(int self, Range & r)
+{
+    Worker & w = *workers_[self];
+    std::lock_guard< std::mutex > lock(w.mutex);
+    if (w.q.empty()) return false;
+    r = w.q.back();
+    w.q.pop_back();
+    return true;
+}
+
+bool mygllib::WorkPool::steal(int self, Range & r)
+{
+    const int w = threads();
+    for (int k = 1; k < w; ++k)
+    {
+        Worker & victim = *workers_[(self + k) % w];
+        std::lock_guard< std::mutex > lock(victim.mutex);
+        if (victim.q.empty()) continue;
+        r = victim.q.front();
+        victim.q.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void mygllib::WorkPool::drain(int self)
+{
+    Range r;
+    for (;;)
+    {
+        if (pop(self, r)) {}
+        else if (steal(self, r)) ++steals_[self];
+        else return;
+
+        (*body_)(r.begin, r.end);
+        ++chunks_[self];
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            done_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,90 @@
+// File  : WorkPool.h
+// Author: Cole Schwandt
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mygllib
+{
+    //-------------------------------------------------------------------------
+    // WorkPool
+    //
+    // Fork-join pool for data-parallel loops. parallel_for() cuts [0, n)
+    // into chunks of `grain`, deals them round-robin onto one deque per
+    // worker and returns when every chunk has run. A worker takes its own
+    // chunks from the back (the most recently dealt, still warm) and,
+    // when it runs dry, steals from the front of the others' deques, so
+    // uneven chunks even out without a central queue.
+    //
+    // The calling thread is worker 0; a pool of n threads starts n - 1.
+    // parallel_for() is not reentrant and must be called from one thread
+    // at a time.
+    //
+    // USAGE:
+    // mygllib::WorkPool pool(4);
+    // pool.parallel_for(n, 64, [&](size_t begin, size_t end)
+    // {
+    //     for (size_t i = begin; i < end; ++i) ...
+    // });
+    //-------------------------------------------------------------------------
+    class WorkPool
+    {
+    public:
+        typedef std::function< void (size_t, size_t) > Body;
+
+        WorkPool(int threads);
+        ~WorkPool();
+
+        void parallel_for(size_t n, size_t grain, const Body & body);
+
+        int threads() const { return int(workers_.size()); }
+
+        // chunks run and chunks stolen, per worker, since construction
+        const std::vector< uint64_t > & chunks() const { return chunks_; }
+        const std::vector< uint64_t > & steals() const { return steals_; }
+
+    private:
+        WorkPool(const WorkPool &);
+        WorkPool & operator=(const WorkPool &);
+
+        struct Range
+        {
+            size_t begin, end;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque< Range > q;
+        };
+
+        void run(int self);
+        bool pop(int self, Range & r);
+        bool steal(int self, Range & r);
+        void drain(int self);
+
+        std::vector< Worker * > workers_;
+        std::vector< std::thread > threads_;
+        std::vector< uint64_t > chunks_, steals_;
+
+        const Body * body_;
+        std::atomic< size_t > remaining_;
+
+        std::mutex mutex_;              // guards generation_, stop_
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        uint64_t generation_;
+        bool stop_;
+    };
+}
+
+#endif
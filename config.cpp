@@ -18,6 +18,9 @@ namespace mygllib
                               | GLUT_DEPTH
                               | GLUT_RGBA;
 
+    // Rendering into an offscreen context without GLUT (see Headless.h)
+    bool HEADLESS = false;
+
     // RGBA for clear color
     GLfloat CLEAR_COLOR_R = 1.0f;
     GLfloat CLEAR_COLOR_G = 1.0f;
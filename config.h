@@ -18,6 +18,9 @@ namespace mygllib
 
     // Display mode
     extern unsigned int DISPLAY_MODE;
+
+    // Rendering into an offscreen context without GLUT (see Headless.h)
+    extern bool HEADLESS;
  
     // RGBA for clear color
     extern GLfloat CLEAR_COLOR_R;
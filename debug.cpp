@@ -0,0 +1,236 @@
+// File  : debug.cpp
+// Author: Cole Schwandt
+
+#define GL_GLEXT_PROTOTYPES
+#include "debug.h"
+
+#ifdef MYGLLIB_GL_DEBUG
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <GL/glu.h>
+#include <GL/glext.h>
+#include "Clock.h"
+
+namespace
+{
+    std::atomic< uint64_t > messages(0);
+    std::atomic< uint64_t > frame(0);
+
+    // trace file; lines from different threads are whole, not interleaved
+    std::mutex trace_mutex;
+    FILE * trace = NULL;
+    std::atomic< bool > tracing(false);
+    int64_t trace_start = 0;
+
+    // per thread, because a context is current on one thread only
+    thread_local bool khr_debug = false;
+    thread_local int depth = 0;
+
+    unsigned int thread_id()
+    {
+        return unsigned(std::hash< std::thread::id >()(std::this_thread::get_id())
+                        & 0xffff);
+    }
+
+    const char * source_name(GLenum s)
+    {
+        switch (s)
+        {
+            case GL_DEBUG_SOURCE_API:             return "api";
+            case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "window";
+            case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader";
+            case GL_DEBUG_SOURCE_THIRD_PARTY:     return "third party";
+            case GL_DEBUG_SOURCE_APPLICATION:     return "application";
+            default:                              return "other";
+        }
+    }
+
+    const char * type_name(GLenum t)
+    {
+        switch (t)
+        {
+            case GL_DEBUG_TYPE_ERROR:               return "error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined";
+            case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+            case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+            default:                                return "other";
+        }
+    }
+
+    const char * severity_name(GLenum s)
+    {
+        switch (s)
+        {
+            case GL_DEBUG_SEVERITY_HIGH:   return "high";
+            case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+            case GL_DEBUG_SEVERITY_LOW:    return "low";
+            default:                       return "note";
+        }
+    }
+
+    void log_message(const char * what)
+    {
+        std::cout << "GL " << what << std::endl;
+        if (!tracing.load(std::memory_order_relaxed)) return;
+        std::lock_guard< std::mutex > lock(trace_mutex);
+        if (trace)
+            fprintf(trace, "%.1f %u %llu %d message %s\n",
+                    (mygllib::now_ns() - trace_start) * 1e-3, thread_id(),
+                    (unsigned long long) frame.load(), depth, what);
+    }
+
+    // called by the driver, possibly on its own thread
+    void GLAPIENTRY on_message(GLenum source, GLenum type, GLuint id,
+                               GLenum severity, GLsizei, const GLchar * text,
+                               const void *)
+    {
+        ++messages;
+        char line[1024];
+        snprintf(line, sizeof(line), "%s %s (%s, id %u): %s",
+                 severity_name(severity), type_name(type),
+                 source_name(source), id, text);
+        log_message(line);
+    }
+
+    bool has_extension(const char * name)
+    {
+        const char * all = (const char *) glGetString(GL_EXTENSIONS);
+        if (all == NULL) return false;
+        const size_t n = strlen(name);
+        for (const char * p = strstr(all, name); p; p = strstr(p + n, name))
+            if ((p == all || p[-1] == ' ') && (p[n] == ' ' || p[n] == '\0'))
+                return true;
+        return false;
+    }
+}
+
+void mygllib::debug()
+{
+    GLenum err;
+    bool error = false;
+    while ((err = glGetError()) != GL_NO_ERROR)
+    {
+        std::cout << "\nOpenGL error: [" << err << " -- "
+                  << gluErrorString(err) << ']' << std::endl;
+        error = true;
+    }
+    if (error)
+    {
+        throw OpenGLError();
+    }
+}
+
+void mygllib::debug_context()
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    khr_debug = major > 4 || (major == 4 && minor >= 3)
+             || has_extension("GL_KHR_debug");
+    if (!khr_debug)
+    {
+        std::cout << "GL debug: no KHR_debug, polling glGetError() once per frame"
+                  << std::endl;
+        return;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);              // asynchronous: no _SYNCHRONOUS
+    glDebugMessageCallback(on_message, NULL);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL,
+                          GL_TRUE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE,
+                          GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    std::cout << "GL debug: KHR_debug callback on "
+              << (const char *) glGetString(GL_RENDERER)
+              << ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) ? " (debug context)" : "")
+              << std::endl;
+}
+
+void mygllib::debug_frame()
+{
+    if (!khr_debug)
+    {
+        GLenum err;
+        while ((err = glGetError()) != GL_NO_ERROR)
+        {
+            ++messages;
+            char line[256];
+            snprintf(line, sizeof(line), "error %u (%s) during frame %llu",
+                     err, (const char *) gluErrorString(err),
+                     (unsigned long long) frame.load());
+            log_message(line);
+        }
+    }
+    ++frame;
+}
+
+uint64_t mygllib::debug_messages()
+{
+    return messages.load();
+}
+
+bool mygllib::trace_open(const char * path)
+{
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    if (trace) fclose(trace);
+    trace = fopen(path, "w");
+    if (trace == NULL)
+    {
+        std::cout << "GL trace: cannot open " << path << std::endl;
+        tracing.store(false);
+        return false;
+    }
+    fprintf(trace, "# start_us thread frame depth dur_us call\n");
+    trace_start = now_ns();
+    tracing.store(true);
+    return true;
+}
+
+void mygllib::trace_close()
+{
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    tracing.store(false);
+    if (trace) fclose(trace);
+    trace = NULL;
+}
+
+int64_t mygllib::trace_begin()
+{
+    return tracing.load(std::memory_order_relaxed) ? now_ns() : 0;
+}
+
+void mygllib::trace_end(const char * call, int64_t t0)
+{
+    const int64_t t1 = now_ns();
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    if (trace == NULL) return;
+    fprintf(trace, "%.1f %u %llu %d %.1f %s\n", (t0 - trace_start) * 1e-3,
+            thread_id(), (unsigned long long) frame.load(), depth,
+            (t1 - t0) * 1e-3, call);
+}
+
+mygllib::TraceScope::TraceScope(const char * name)
+    : name_(name), t0_(trace_begin())
+{
+    if (khr_debug)
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+    ++depth;
+}
+
+mygllib::TraceScope::~TraceScope()
+{
+    --depth;
+    if (khr_debug) glPopDebugGroup();
+    if (t0_) trace_end(name_, t0_);
+}
+
+#endif
@@ -1,30 +1,110 @@
+// File  : debug.h
+// Author: Cole Schwandt
+//
+// GL diagnostics. Unless the build defines MYGLLIB_GL_DEBUG (make DEBUG=1)
+// every function here is an empty inline and GL_CALL/GL_SCOPE expand to
+// the bare call, so release builds pay nothing.
 
 #ifndef DEBUG_H
 #define DEBUG_H
 
-#include <iostream>
+#include <cstdint>
+#include <GL/gl.h>
 
 namespace mygllib
 {
     class OpenGLError
     {};
-    
-    inline
-    void debug()
+
+#ifdef MYGLLIB_GL_DEBUG
+    const bool GL_DEBUG = true;
+
+    //-------------------------------------------------------------------------
+    // debug
+    //
+    // Drains glGetError() and throws OpenGLError if anything was set. Every
+    // call waits for the pipeline, so only drop it in temporarily to find
+    // the call that fails; debug_context() reports errors without that.
+    //-------------------------------------------------------------------------
+    void debug();
+
+    //-------------------------------------------------------------------------
+    // debug_context
+    //
+    // Call once per context, while it is current. With KHR_debug (GL 4.3
+    // or the extension) the driver reports errors, undefined behavior and
+    // performance warnings through a callback as they happen, without
+    // stalling; they are printed and, if a trace is open, logged. Without
+    // KHR_debug, debug_frame() falls back to one glGetError() per frame.
+    //
+    // debug_frame
+    //
+    // Call once per frame after the swap: counts frames for the trace and
+    // does the fallback poll.
+    //-------------------------------------------------------------------------
+    void debug_context();
+    void debug_frame();
+    uint64_t debug_messages();              // reported so far, all contexts
+
+    //-------------------------------------------------------------------------
+    // Call trace
+    //
+    // trace_open() starts logging every GL_CALL and GL_SCOPE, from any
+    // thread, to a text file: one line per call with its start time, the
+    // CPU time it took to issue (not GPU time), the frame, thread and
+    // scope depth. KHR_debug messages are logged in place. When no trace
+    // is open, GL_CALL costs one branch.
+    //
+    // USAGE:
+    // mygllib::trace_open("gl.trace");
+    // {
+    //     GL_SCOPE("draw_scene");             // also a KHR_debug group
+    //     GL_CALL(glDrawArrays(GL_TRIANGLES, 0, n));
+    // }
+    // mygllib::trace_close();
+    //-------------------------------------------------------------------------
+    bool trace_open(const char * path);
+    void trace_close();
+
+    int64_t trace_begin();                  // 0 when not tracing
+    void trace_end(const char * call, int64_t t0);
+
+    class TraceScope
     {
-        GLenum errno;
-        bool error = false;
-        while ((errno = glGetError()) != GL_NO_ERROR)
-        {
-            std::cout << "\nOpenGL error: [" << errno << " -- "
-                      << gluErrorString(errno) << ']' << std::endl;
-            error = true;
-        }
-        if (error)
-        {
-            throw OpenGLError();
-        }
-    }
+    public:
+        TraceScope(const char * name);
+        ~TraceScope();
+
+    private:
+        const char * name_;
+        int64_t t0_;
+    };
+
+    #define GL_CALL(call)                                           \
+        do                                                          \
+        {                                                           \
+            const int64_t gl_call_t0_ = mygllib::trace_begin();     \
+            call;                                                   \
+            if (gl_call_t0_) mygllib::trace_end(#call, gl_call_t0_); \
+        } while (0)
+
+    #define GL_SCOPE_CAT_(a, b) a ## b
+    #define GL_SCOPE_NAME_(line) GL_SCOPE_CAT_(gl_scope_, line)
+    #define GL_SCOPE(name) mygllib::TraceScope GL_SCOPE_NAME_(__LINE__)(name)
+
+#else
+    const bool GL_DEBUG = false;
+
+    inline void debug() {}
+    inline void debug_context() {}
+    inline void debug_frame() {}
+    inline uint64_t debug_messages() { return 0; }
+    inline bool trace_open(const char *) { return false; }
+    inline void trace_close() {}
+
+    #define GL_CALL(call) call
+    #define GL_SCOPE(name) ((void) 0)
+#endif
 }
 
 #endif
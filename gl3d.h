@@ -7,6 +7,7 @@
 #include "config.h"
 #include "View.h"
 #include "Material.h"
+#include "Windows.h"
 
 namespace mygllib
 {
@@ -18,14 +19,13 @@ namespace mygllib
         int argc = 0;
         char ** argv = NULL;
         glutInit(&argc, argv);    
-        glutInitWindowPosition(WIN_X, WIN_Y);
-        glutInitWindowSize(WIN_W, WIN_H);
         glutInitDisplayMode(GLUT_DEPTH
                             | GLUT_DOUBLE
                             | GLUT_RGBA
                             | GLUT_STENCIL
             );
-        glutCreateWindow(WIN_TITLE);
+        if (GL_DEBUG) glutInitContextFlags(GLUT_DEBUG);
+        Windows::open(WIN_TITLE, View(), WIN_X, WIN_Y, WIN_W, WIN_H);
     }
 
     //-------------------------------------------------------------------------
@@ -73,12 +73,12 @@ namespace mygllib
     {
         glColor3f(0.5, 0.5, 0.5);
         glBegin(GL_LINES);
-        for (float x = minx; x <= maxx; x += 1)
+        for (float x = minx; x <= maxx; x += dx)
         {
             glVertex3f(x, 0, minz);
             glVertex3f(x, 0, maxz);
         }
-        for (float z = minz; z <= maxz; z += 1)
+        for (float z = minz; z <= maxz; z += dz)
         {
             glVertex3f(minx, 0, z);
             glVertex3f(maxx, 0, z);
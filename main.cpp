@@ -5,16 +5,48 @@
 // Description:
 // Robotic arm with rotations
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <GL/freeglut.h>
 #include "gl3d.h"
 #include "View.h"
 #include "SingletonView.h"
 #include "Reshape.h"
+#include "Windows.h"
 #include "Keyboard.h"
-#include "Material.h"
-#include "Light.h"
+#include "Command.h"
+#include "ArmConfig.h"
+#include "Kinematics.h"
+#include "Collision.h"
+#include "Grasp.h"
+#include "Dynamics.h"
+#include "Jacobian.h"
+#include "Telemetry.h"
+#include "Clock.h"
+#include "Mesh.h"
+#include "Scene.h"
+#include "Headless.h"
+#include "Replay.h"
+#include "Batch.h"
+#include "Export.h"
+#include "Capture.h"
+#include "Hud.h"
+#include "Fleet.h"
+#include "Shard.h"
+#include "Picking.h"
+#include "Script.h"
+#include "Sweep.h"
+#include "Latency.h"
+#include "Governor.h"
+#include "Framebuffer.h"
+#include "DepthCamera.h"
 
 //==============================================================
 // Config
@@ -26,71 +58,14 @@ namespace cfg
     const GLfloat EYE_Y = 5.0f;
     const GLfloat EYE_Z = 7.0f;
 
-    // -------- clear/depth --------
-    const GLfloat CLEAR_R = 1.0f;
-    const GLfloat CLEAR_G = 1.0f;
-    const GLfloat CLEAR_B = 1.0f;
-    const GLfloat CLEAR_A = 0.0f;
-    const GLfloat CLEAR_DEPTH = 1.0f;
-
-    // -------- tessellation (glut) --------
-    const GLint SLICES = 20;
-    const GLint STACKS = 20;
-
-    // -------- materials --------
-    const int MAT_JOINT = mygllib::Material::CHROME;
-    const int MAT_LINKS = mygllib::Material::PEARL;
-
-    // -------- light --------
-    const GLenum LIGHT_ID = GL_LIGHT0;
-    const GLfloat LIGHT_AMBIENT[4]  = { 0.5f, 0.5f, 0.5f, 0.5f };
-    const GLfloat LIGHT_DIFFUSE[4]  = { 1.0f, 1.0f, 1.0f, 1.0f };
-    const GLfloat LIGHT_SPECULAR[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    const GLfloat LIGHT_POS[4]      = { 4.0f, 6.0f, 3.0f, 1.0f };
-
-    // -------- base (cube scaled) --------
-    const GLfloat BASE_SIZE = 1.0f;    
-    const GLfloat BASE_SX   = 5.0f;
-    const GLfloat BASE_SY   = 0.5f;
-    const GLfloat BASE_SZ   = 5.0f;
-
-    // -------- joints --------
-    const GLfloat JOINT_R = 1.0f; // was 1
-
-    // -------- links (cylinders) --------
-    const GLfloat ARM_R = 0.5f;
-    const GLfloat ARM_L = 2.0f;
-    const GLfloat ROT_Z_TO_Y = -90.0f;  
-    const GLfloat OVERLAP_FRAC = 0.25f;
-    
-    inline GLfloat LINK_GAP()
-    {
-        const GLfloat m = (ARM_R < JOINT_R ? ARM_R : JOINT_R);
-        return -OVERLAP_FRAC * m;
-    }
+    // -------- simulation tick --------
+    const unsigned int TICK_MS = 1;    // 1 kHz: polls external commands
 
-    // -------- hand/fingers --------
-    const GLfloat PALM_SIZE = 1.0f;
-    const GLfloat FINGER_JOINT_R = 0.15f;
-    const GLfloat FINGER_DIGIT_R = 0.1f;
-    const GLfloat FINGER_DIGIT_L = 0.5f;
-    
-    const GLfloat PALM_TO_FINGER_Y = 0.5f * PALM_SIZE;
-    const GLfloat FINGER_OFFSET_X  = 0.23f * JOINT_R;
-    const GLfloat FINGER_OFFSET_Z  = 0.30f * JOINT_R;    
+    // -------- 'h': slerp back to the rest pose --------
+    const GLfloat HOME_S = 1.0f;
+    const GLfloat REPLAY_FRAME_S = 1.0f / 60;  // headless: time per frame
 }
 
-//==============================================================
-// Lighting
-//==============================================================
-mygllib::Light light(
-    cfg::LIGHT_ID,
-    cfg::LIGHT_AMBIENT[0], cfg::LIGHT_AMBIENT[1], cfg::LIGHT_AMBIENT[2], cfg::LIGHT_AMBIENT[3],
-    cfg::LIGHT_DIFFUSE[0], cfg::LIGHT_DIFFUSE[1], cfg::LIGHT_DIFFUSE[2], cfg::LIGHT_DIFFUSE[3],
-    cfg::LIGHT_SPECULAR[0], cfg::LIGHT_SPECULAR[1], cfg::LIGHT_SPECULAR[2], cfg::LIGHT_SPECULAR[3],
-    cfg::LIGHT_POS[0], cfg::LIGHT_POS[1], cfg::LIGHT_POS[2], cfg::LIGHT_POS[3]
-);
-
 //==============================================================
 // Globals
 //==============================================================
@@ -115,29 +90,8 @@ GLfloat elbow_roll  = 0.0f;     // rotate about Z → XY plane
 // Fingers
 GLfloat grip = 0.0f;            // 0=open … 1=closed (pinch)
 
-struct FingerAngles { GLfloat baseZ, jointZ, tipY; };
-
-// OPEN pose
-const FingerAngles OPEN_F0 = { -60.0f, +60.0f, -35.0f };
-const FingerAngles OPEN_F1 = { +60.0f, -60.0f, +35.0f };
-const FingerAngles OPEN_F2 = { +60.0f, -60.0f, +35.0f };
-
-// CLOSED pose (pinch): stronger curl, zero tip twist for a tight pinch
-const FingerAngles CLOSED_F0 = { -150.0f, +120.0f, 0.0f };
-const FingerAngles CLOSED_F1 = { +150.0f, -120.0f, 0.0f };
-const FingerAngles CLOSED_F2 = { +150.0f, -120.0f, 0.0f };
-
-inline GLfloat lerp(GLfloat a, GLfloat b, GLfloat t)
-{
-    return a + t * (b - a);
-}
-
-inline FingerAngles mix(const FingerAngles& a, const FingerAngles& b, GLfloat t)
-{
-    return { lerp(a.baseZ,  b.baseZ,  t),
-             lerp(a.jointZ, b.jointZ, t),
-             lerp(a.tipY,   b.tipY,   t) };
-}
+// tessellated once, shared by every frame
+const arm::ArmMeshes arm_meshes;
 
 void init()
 {
@@ -148,15 +102,7 @@ void init()
     view.set_projection();
     view.lookat();
 
-    glClearColor(cfg::CLEAR_R, cfg::CLEAR_G, cfg::CLEAR_B, cfg::CLEAR_A);
-    //glClearDepth(cfg::CLEAR_DEPTH);
-
-    light.set();
-    mygllib::Light::all_on();
-    light.on();
-    glEnable(GL_DEPTH_TEST);
-    glShadeModel(GL_SMOOTH);
-    glEnable(GL_NORMALIZE);
+    arm::init_scene();
 }
 
 inline void clamp_grip()
@@ -165,222 +111,808 @@ inline void clamp_grip()
     if (grip > 1.0f) grip = 1.0f;
 }
 
+arm::Pose current_pose()
+{
+    arm::Pose p = { shoulder_pitch, shoulder_yaw, shoulder_roll,
+                    elbow_pitch, elbow_yaw, elbow_roll,
+                    grip, xb, yb, zb };
+    return p;
+}
+
+// Ball joints as unit quaternions. The F-keys turn them about their own
+// axes; the Euler globals above follow them for display, telemetry and
+// the Pose-based code, and commands and drags set them through Euler.
+arm::Quat shoulder_q, elbow_q;
+
+void set_angles(const arm::Pose & p)
+{
+    shoulder_pitch = p.shoulder_pitch;
+    shoulder_yaw   = p.shoulder_yaw;
+    shoulder_roll  = p.shoulder_roll;
+    elbow_pitch    = p.elbow_pitch;
+    elbow_yaw      = p.elbow_yaw;
+    elbow_roll     = p.elbow_roll;
+}
+
+void set_joints(const arm::Pose & p)
+{
+    set_angles(p);
+    shoulder_q = arm::shoulder_rotation(p);
+    elbow_q = arm::elbow_rotation(p);
+}
+
+// rotate a ball joint by deg about its own x, y or z axis
+void turn(arm::Quat & q, GLfloat deg, GLfloat x, GLfloat y, GLfloat z)
+{
+    q = mygllib::normalize(q * arm::Quat::rotate(deg, x, y, z));
+    arm::Pose p = current_pose();
+    arm::set_shoulder_rotation(p, shoulder_q);
+    arm::set_elbow_rotation(p, elbow_q);
+    set_angles(p);
+}
+
+// 'h': both ball joints slerp to the rest pose over HOME_S
+arm::Pose home_from;
+GLfloat home_t = 1.0f;          // 1: not moving
+
+void animate(GLfloat dt)
+{
+    if (home_t >= 1.0f) return;
+    home_t = std::min(1.0f, home_t + dt / cfg::HOME_S);
+    const arm::Pose home = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                             home_from.grip, xb, yb, zb };
+    const GLfloat s = home_t * home_t * (3.0f - 2.0f * home_t);   // ease
+    set_joints(arm::slerp(home_from, home, s));
+}
+
 //==============================================================
-// Material helpers
+// Motion scripts, run on the sim tick ('p': pick demo). Operator
+// input (joint and grip keys, drags, external commands) stops them.
 //==============================================================
-void set_mat0()
+arm::ScriptRunner scripts;
+arm::Pose scripted;             // the pose scripts drive
+
+// reach down in front of the base, close the grip, hold, lift, let go:
+// the poses the arm passes through, in order
+std::vector< arm::Pose > pick_demo_path(const arm::Pose & from)
+{
+    std::vector< arm::Pose > path(6, from);
+    path[1].grip = 0.0f;
+    arm::Pose & reach = path[2];
+    reach.shoulder_pitch = 30.0f; reach.shoulder_yaw = 0.0f; reach.shoulder_roll = 0.0f;
+    reach.elbow_pitch = 75.0f;    reach.elbow_yaw = 0.0f;    reach.elbow_roll = 0.0f;
+    path[3] = reach;
+    path[3].grip = 1.0f;
+    path[4] = path[3];
+    path[4].shoulder_pitch = 10.0f;
+    path[4].elbow_pitch = 50.0f;
+    path[5] = path[4];
+    path[5].grip = 0.0f;
+    return path;
+}
+
+arm::Script pick_demo(arm::Pose & pose, std::vector< arm::Pose > path)
 {
-    mygllib::Material(cfg::MAT_JOINT).set();
+    co_await arm::grip_to(path[1].grip);
+    co_await arm::move_to(path[2]);
+    co_await arm::grip_to(path[3].grip);
+    co_await arm::sleep(500);
+    co_await arm::move_to(path[4]);
+    co_await arm::sleep(500);
+    co_await arm::grip_to(path[5].grip);
+}
+
+// Starts the pick demo if its whole path is clear of the base and of the
+// arm itself (move_to eases along the same slerp the check sweeps).
+void start_pick_demo()
+{
+    scripts.stop();
+    home_t = 1.0f;
+    scripted = current_pose();
+    const std::vector< arm::Pose > path = pick_demo_path(scripted);
+    const arm::TrajectoryCheck c = arm::check_trajectory(path, arm::Obstacles());
+    if (!c.clear)
+    {
+        std::cout << "pick demo: path blocked in move " << c.segment
+                  << " at " << c.s << (c.certain ? "" : " (too close)")
+                  << ", not started\n";
+        return;
+    }
+    scripts.start(pick_demo(scripted, path));
 }
 
-void set_col1()
+void run_scripts(GLfloat dt)
 {
-    mygllib::Material(cfg::MAT_LINKS).set();
+    if (scripts.running() == 0) return;
+    scripts.tick(dt);
+    set_joints(scripted);
+    grip = scripted.grip;
+    mygllib::Windows::redisplay_all();
 }
 
 //==============================================================
-// Glut drawing helpers
+// Simulation state, updated every tick
 //==============================================================
-void draw_cube(GLfloat size)
+// object to grasp (--grasp <shape>); NONE lets the fingers close freely
+arm::GraspObject grasp_object = arm::grasp_object(arm::GraspObject::NONE);
+arm::Grasp grasp;
+arm::Frames frames;             // current pose, fingers stopped by grasp
+
+// joint torques from finite-differenced joint motion
+const arm::ArmModel arm_model = arm::arm_model();
+arm::TorqueMonitor torque_monitor(arm_model);
+int64_t last_sim_ns = 0;
+
+// palm Jacobian and singularity measures ('m' toggles the ellipsoid)
+arm::Jacobian jacobian;
+arm::Manipulability manipulability;
+double jacobian_us = 0.0;       // smoothed cost per tick
+bool show_manipulability = true;
+
+// part being dragged with the mouse
+arm::DragPose drag;
+double pick_us = 0.0;           // cost of the last pick
+
+void update_jacobian(const arm::Pose & pose)
 {
-    glutSolidCube(size);
+    const int64_t t0 = mygllib::now_ns();
+    arm::palm_jacobian(pose, jacobian);
+    arm::manipulability(pose, jacobian, manipulability);
+    jacobian_us += 0.01 * ((mygllib::now_ns() - t0) * 1e-3 - jacobian_us);
 }
 
-void draw_sphere(GLfloat r, GLint slices = cfg::SLICES, GLint stacks = cfg::STACKS)
+void update_sim()
 {
-    glutSolidSphere(r, slices, stacks);
+    const arm::Pose pose = current_pose();
+    const int64_t now = mygllib::now_ns();
+    torque_monitor.update(pose, last_sim_ns ? (now - last_sim_ns) * 1e-9f
+                                            : 0.0f);
+    last_sim_ns = now;
+
+    arm::forward_kinematics(pose, frames);
+    arm::resolve_grasp(frames.palm, pose.grip, grasp_object, grasp);
+    if (grasp_object.shape != arm::GraspObject::NONE)
+        arm::forward_kinematics(pose, frames, grasp.angles);
+    update_jacobian(pose);
 }
 
-void draw_cylinder(GLfloat r, GLfloat h, GLint slices = cfg::SLICES, GLint stacks = cfg::STACKS)
+//==============================================================
+// External control (shared memory / UNIX socket)
+//==============================================================
+arm::CommandServer * command_server = NULL;
+uint64_t frame_count = 0;
+
+//==============================================================
+// Telemetry (shared memory, published every tick)
+//==============================================================
+arm::TelemetryPublisher * telemetry = NULL;
+uint64_t tick_count = 0;
+
+void publish_telemetry()
 {
-    glutSolidCylinder(r, h, slices, stacks);
+    const arm::Pose pose = current_pose();
+    const arm::Frames & f = frames;
+    arm::ArmShapes shapes;
+    arm::arm_shapes(f, shapes);
+
+    arm::TelemetrySample s;
+    s.tick = tick_count;
+    s.stamp_ns = mygllib::now_ns();
+    s.joints[0] = pose.shoulder_pitch;
+    s.joints[1] = pose.shoulder_yaw;
+    s.joints[2] = pose.shoulder_roll;
+    s.joints[3] = pose.elbow_pitch;
+    s.joints[4] = pose.elbow_yaw;
+    s.joints[5] = pose.elbow_roll;
+    s.grip = pose.grip;
+    s.collision = arm::in_collision(pose, shapes) ? 1 : 0;
+    memcpy(s.palm, f.palm.m, sizeof(s.palm));
+    for (int i = 0; i < arm::NUM_FINGERS; ++i)
+        memcpy(s.fingertip[i], f.fingertip[i].m, sizeof(s.fingertip[i]));
+    memset(s.contact, 0, sizeof(s.contact));
+    for (int i = 0; i < arm::NUM_FINGERS; ++i)
+    {
+        const arm::FingerContact & fc = grasp.finger[i];
+        const bool held = grasp_object.shape != arm::GraspObject::NONE;
+        s.closure[i] = held ? fc.closure() : 0.0f;
+        s.touching[i] = fc.touching;
+        for (int k = 0; k < 2; ++k)
+        {
+            if (!(fc.touching & (1 << k))) continue;
+            s.contact[i][k][0] = fc.point[k].x;
+            s.contact[i][k][1] = fc.point[k].y;
+            s.contact[i][k][2] = fc.point[k].z;
+        }
+    }
+    telemetry->publish(s);
+}
+
+void apply_command(const arm::Command & cmd)
+{
+    if (cmd.mask & arm::Command::SHOULDER_PITCH) shoulder_pitch = cmd.shoulder_pitch;
+    if (cmd.mask & arm::Command::SHOULDER_YAW)   shoulder_yaw   = cmd.shoulder_yaw;
+    if (cmd.mask & arm::Command::SHOULDER_ROLL)  shoulder_roll  = cmd.shoulder_roll;
+    if (cmd.mask & arm::Command::ELBOW_PITCH)    elbow_pitch    = cmd.elbow_pitch;
+    if (cmd.mask & arm::Command::ELBOW_YAW)      elbow_yaw      = cmd.elbow_yaw;
+    if (cmd.mask & arm::Command::ELBOW_ROLL)     elbow_roll     = cmd.elbow_roll;
+    if (cmd.mask & arm::Command::GRIP)
+    {
+        grip = cmd.grip;
+        clamp_grip();
+    }
+    set_joints(current_pose());
+    home_t = 1.0f;
+    scripts.stop();
+}
+
+void tick(int)
+{
+    arm::Command cmd;
+    if (command_server->poll(cmd))
+    {
+        apply_command(cmd);
+        mygllib::Windows::redisplay_all();
+    }
+    if (home_t < 1.0f)
+    {
+        animate(cfg::TICK_MS * 1e-3f);
+        mygllib::Windows::redisplay_all();
+    }
+    run_scripts(cfg::TICK_MS * 1e-3f);
+    update_sim();
+    publish_telemetry();
+    ++tick_count;
+    glutTimerFunc(cfg::TICK_MS, tick, 0);
 }
 
 //==============================================================
-// Robot part drawers
+// Recording (--record)
 //==============================================================
-void draw_base(GLfloat size)
+mygllib::FrameCapture * capture = NULL;
+int64_t start_ns = 0;
+
+void finish_capture()
 {
-    set_col1();
-    draw_cube(size);
+    if (!capture) return;
+    capture->finish();
+    const double secs = (mygllib::now_ns() - start_ns) / 1e9;
+    std::cout << "recorded " << capture->frames_written() << " frames ("
+              << capture->frames_dropped() << " dropped), "
+              << frame_count / secs << " fps" << std::endl;
+    delete capture;
+    capture = NULL;
 }
 
-void draw_joint(GLfloat r)
+//==============================================================
+// Input-to-photon latency (--latency)
+//==============================================================
+bool latency_csv = false;
+
+void finish_latency()
 {
-    set_mat0();
-    draw_sphere(r);
+    if (!latency_csv) return;
+    mygllib::InputLatency::close_csv();
+    mygllib::InputLatency::report(std::cout);
+    latency_csv = false;
 }
 
-void draw_arm(GLfloat r, GLfloat l)
+//==============================================================
+// Quality governor (--governor <ms>)
+//
+// Trades looks for frame time in the main window: the governor
+// moves down the levels while frames take longer than the target
+// and back up once they are well under it. All windows draw with
+// the level's meshes and detail; only the main window is rendered
+// at a lower resolution and fed to the governor.
+//==============================================================
+namespace cfg
 {
-    set_col1();
-    draw_cylinder(r, l);
+    struct QualityLevel
+    {
+        GLint slices, stacks;           // tessellation
+        GLfloat scale;                  // share of the window's resolution
+        int grid_step;
+        bool shadows;                   // if --shadows
+    };
+
+    // best first
+    const QualityLevel QUALITY[] =
+    {
+        { SLICES, STACKS, 1.0f,  1, true  },
+        { 14,     12,     1.0f,  1, true  },
+        { 12,     10,     1.0f,  2, false },
+        { 10,     8,      0.75f, 2, false },
+        { 8,      6,      0.6f,  4, false },
+        { 6,      4,      0.5f,  5, false },
+    };
+    const int QUALITY_LEVELS = sizeof(QUALITY) / sizeof(QUALITY[0]);
 }
 
-void draw_finger(GLfloat tx, GLfloat ty, GLfloat tz,
-                 GLfloat baseZDeg, GLfloat jointZDeg, GLfloat tipYDeg)
+mygllib::QualityGovernor * governor = NULL;
+mygllib::ScaledFramebuffer * scaled = NULL;
+bool shadows = false;
+const arm::ArmMeshes * lod_meshes[cfg::QUALITY_LEVELS] = { &arm_meshes };
+int64_t frame_start_ns = 0;
+
+const cfg::QualityLevel & quality()
 {
-    glPushMatrix();
+    return cfg::QUALITY[governor ? governor->level() : 0];
+}
+
+// tessellated on first use of a level
+const arm::ArmMeshes & meshes()
+{
+    const int level = governor ? governor->level() : 0;
+    if (!lod_meshes[level])
+    {
+        const cfg::QualityLevel & q = cfg::QUALITY[level];
+        lod_meshes[level] = new arm::ArmMeshes(q.slices, q.stacks);
+    }
+    return *lod_meshes[level];
+}
+
+arm::SceneDetail scene_detail()
+{
+    const arm::SceneDetail d = { quality().grid_step,
+                                 shadows && quality().shadows };
+    return d;
+}
+
+// main window: start the frame clock and draw at the level's resolution
+void begin_main_frame()
+{
+    mygllib::Windows::apply();
+    mygllib::InputLatency::frame();
+    frame_start_ns = mygllib::now_ns();
+    scaled->begin(mygllib::Windows::width(), mygllib::Windows::height(),
+                  quality().scale);
+}
+
+// the scene is drawn; the HUD goes on at full resolution
+void end_main_scene()
+{
+    scaled->end();
+}
+
+// after the swap
+void end_main_frame()
+{
+    mygllib::InputLatency::presented();
+    if (governor
+        && governor->frame(mygllib::ns_to_ms(mygllib::now_ns() - frame_start_ns)))
+        mygllib::Windows::redisplay_all();
+}
+
+//==============================================================
+// Wrist depth camera (--depth-camera <hz>): color and linear depth
+// from the wrist, drawn offscreen at its own size and rate from a
+// timer of its own (see depth_camera_frame()), never inside a
+// window's frame. Readers take the newest frame from
+// depth_camera->frames().
+//==============================================================
+namespace cfg
+{
+    const int DEPTH_CAMERA_W = 320;
+    const int DEPTH_CAMERA_H = 240;
+    const GLfloat DEPTH_CAMERA_NEAR = 0.1f;
+    const GLfloat DEPTH_CAMERA_FAR = 60.0f;
+    const unsigned int DEPTH_CAMERA_POLL_MS = 2;  // pick up readbacks
+}
+
+mygllib::DepthCamera * depth_camera = NULL;
+double depth_camera_hz = 0.0;
+uint64_t depth_seq = 0;                 // newest frame the HUD has seen
+float depth_center = 0.0f;              // its depth at the image center
+int64_t depth_render_ns = 0;
+
+//==============================================================
+// Display
+//==============================================================
+mygllib::Hud hud;
+
+void add_quality_line()
+{
+    if (!governor) return;
+    const cfg::QualityLevel & q = quality();
+    char line[128];
+    snprintf(line, sizeof(line),
+             "quality %d/%d: %dx%d, %.0f%% res, grid %d, shadows %s  (%.1f ms of %.1f)",
+             governor->level(), cfg::QUALITY_LEVELS - 1, q.slices, q.stacks,
+             100.0f * q.scale, q.grid_step, scene_detail().shadows ? "on" : "off",
+             governor->mean_ms(), governor->target_ms());
+    hud.add(line);
+}
+
+// input-to-photon latency, once there has been input
+void add_latency_lines()
+{
+    typedef mygllib::InputLatency L;
+    if (L::count() == 0) return;
+    char line[128];
+    snprintf(line, sizeof(line),
+             "input to photon: last %.1f ms  mean %.1f  max %.1f  (%llu events)",
+             L::last_ms(), L::mean_ms(), L::max_ms(),
+             (unsigned long long) L::count());
+    hud.add(line);
+
+    std::string bars = "  ms";
+    for (int i = 0; i < L::BUCKETS; ++i)
+    {
+        const bool over = i == L::BUCKETS - 1;
+        snprintf(line, sizeof(line), over ? "  %g+: %llu" : "  <%g: %llu",
+                 L::bucket_ms(over ? i - 1 : i), (unsigned long long) L::bucket(i));
+        bars += line;
+    }
+    hud.add(bars);
+}
+
+// Label next to a point of the arm. Call while the modelview still holds
+// the camera (right after draw_scene()).
+void label_joint(const arm::Vec3 & p, const char * s)
+{
+    GLdouble mv[16], pr[16], x, y, z;
+    GLint vp[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, mv);
+    glGetDoublev(GL_PROJECTION_MATRIX, pr);
+    glGetIntegerv(GL_VIEWPORT, vp);
+    if (gluProject(p.x, p.y, p.z, mv, pr, vp, &x, &y, &z) == GL_TRUE
+        && z > 0.0 && z < 1.0)
+        hud.label(GLfloat(x) + 12.0f, GLfloat(y), s);
+}
+
+// newest wrist depth frame, read the way any consumer would
+void add_depth_camera_line()
+{
+    if (!depth_camera) return;
+    mygllib::TripleBuffer< mygllib::DepthFrame > & frames = depth_camera->frames();
+    if (frames.acquire())
+    {
+        const mygllib::DepthFrame & f = frames.front();
+        depth_seq = f.seq;
+        depth_center = f.depth_at(f.width / 2, f.height / 2);
+        depth_render_ns = f.render_ns;
+    }
+    char line[128];
+    if (depth_seq == 0)
     {
-        // place on palm
-        glTranslatef(tx, ty, tz);
-        draw_joint(cfg::FINGER_JOINT_R);
+        snprintf(line, sizeof(line), "wrist depth: %dx%d at %.0f Hz, no frame yet",
+                 depth_camera->width(), depth_camera->height(), depth_camera_hz);
+    }
+    else
+    {
+        snprintf(line, sizeof(line),
+                 "wrist depth: %dx%d at %.0f Hz, frame %llu (%llu skipped), center %.2f, %.1f ms old",
+                 depth_camera->width(), depth_camera->height(), depth_camera_hz,
+                 (unsigned long long) depth_seq,
+                 (unsigned long long) depth_camera->skipped(), depth_center,
+                 mygllib::ns_to_ms(mygllib::now_ns() - depth_render_ns));
+    }
+    hud.add(line);
+}
+
+void draw_hud()
+{
+    const float * tau = torque_monitor.torque();
+    const float * hold = torque_monitor.gravity();
+    char line[128];
+    hud.clear();
+    snprintf(line, sizeof(line), "shoulder %.0f %.0f %.0f",
+             shoulder_pitch, shoulder_yaw, shoulder_roll);
+    label_joint(frames.shoulder.origin(), line);
+    snprintf(line, sizeof(line), "elbow %.0f %.0f %.0f",
+             elbow_pitch, elbow_yaw, elbow_roll);
+    label_joint(frames.elbow.origin(), line);
+    snprintf(line, sizeof(line), "grip %.2f", grip);
+    label_joint(frames.palm.origin(), line);
 
-        // first phalanx: your Z-bend, then aim Z->Y and draw
-        glRotatef(baseZDeg, 0.0f, 0.0f, 1.0f);
-        glPushMatrix();
+    hud.add("torque (N m)     pitch     yaw     roll");
+    snprintf(line, sizeof(line), "shoulder  %8.1f %8.1f %8.1f",
+             tau[0], tau[1], tau[2]);
+    hud.add(line);
+    snprintf(line, sizeof(line), "elbow     %8.1f %8.1f %8.1f",
+             tau[3], tau[4], tau[5]);
+    hud.add(line);
+    snprintf(line, sizeof(line), "holding   %8.1f %8.1f %8.1f | %.1f %.1f %.1f",
+             hold[0], hold[1], hold[2], hold[3], hold[4], hold[5]);
+    hud.add(line);
+
+    const arm::Manipulability & m = manipulability;
+    snprintf(line, sizeof(line),
+             "manipulability %.3f  cond %.1f | position %.2f  cond %.1f  (%.1f us)",
+             m.w, m.condition, m.position_w, m.position_condition, jacobian_us);
+    hud.add(line);
+    if (m.near_singular || m.shoulder_gimbal_lock || m.elbow_gimbal_lock)
+    {
+        std::string warn = "WARNING: near singularity";
+        if (m.shoulder_gimbal_lock) warn += ", shoulder gimbal lock";
+        if (m.elbow_gimbal_lock) warn += ", elbow gimbal lock";
+        hud.add(warn);
+    }
+    if (mygllib::debug_messages() > 0)
+    {
+        snprintf(line, sizeof(line), "GL debug: %llu driver messages (see stdout)",
+                 (unsigned long long) mygllib::debug_messages());
+        hud.add(line);
+    }
+    if (drag.active())
+    {
+        const arm::Pick::Part part = drag.pick().part;
+        const char * moves = part == arm::Pick::SHOULDER
+                          || part == arm::Pick::UPPER_ARM ? "shoulder"
+                           : (part == arm::Pick::ELBOW
+                              || part == arm::Pick::FOREARM ? "elbow" : "palm (IK)");
+        snprintf(line, sizeof(line), "dragging %s: moves the %s  (pick %.1f us)",
+                 arm::part_name(part), moves, pick_us);
+        hud.add(line);
+    }
+    add_latency_lines();
+    add_depth_camera_line();
+    add_quality_line();
+    hud.draw();
+}
+
+// The main window keeps the grid, axes and base in a StaticLayer while
+// its camera and the base stay put, and draws only the arm over them
+// (--no-static-cache: redraw everything every frame). Frames come out
+// the same either way.
+bool use_static_layer = true;
+mygllib::StaticLayer * static_layer = NULL;
+
+// the arm and what is drawn around it, as every window shows it; with
+// a layer, the static part comes from it
+void draw_world(const mygllib::View & view, mygllib::StaticLayer * layer=NULL)
+{
+    const arm::Pose pose = current_pose();
+    const arm::SceneDetail detail = scene_detail();
+    if (layer)
+    {
+        const float key[] = { view.eyex(), view.eyey(), view.eyez(),
+                              view.refx(), view.refy(), view.refz(),
+                              view.upx(), view.upy(), view.upz(),
+                              view.fovy(), view.aspect(), view.zNear(),
+                              view.zFar(), pose.xb, pose.yb, pose.zb,
+                              float(detail.grid_step) };
+        if (layer->begin(scaled->width(), scaled->height(), key,
+                         sizeof(key) / sizeof(key[0])))
         {
-            glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
-            draw_arm(cfg::FINGER_DIGIT_R, cfg::FINGER_DIGIT_L);
+            arm::draw_static(pose, view, meshes(), detail);
+            layer->end();
         }
-        glPopMatrix();
-
-        // middle joint block: walk L in (palm) Y, apply your joint Z, draw joint
-        glPushMatrix();
+        else
         {
-            glTranslatef(0.0f, cfg::FINGER_DIGIT_L, 0.0f);
-            glRotatef(jointZDeg, 0.0f, 0.0f, 1.0f);
-            draw_joint(cfg::FINGER_JOINT_R);
-
-            // second phalanx: aim Z->Y then your Y-rotation, draw
-            glPushMatrix();
-            {
-                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
-                glRotatef(tipYDeg, 0.0f, 1.0f, 0.0f);
-                draw_arm(cfg::FINGER_DIGIT_R, cfg::FINGER_DIGIT_L);
-            }
-            glPopMatrix();
+            layer->restore();
         }
-        glPopMatrix();
+        arm::draw_moving(pose, view, meshes(), grasp.angles, detail);
+    }
+    else
+    {
+        arm::draw_scene(pose, view, meshes(), grasp.angles, detail);
     }
-    glPopMatrix();
+    arm::draw_grasp(grasp_object, grasp, meshes());
+    if (show_manipulability)
+        arm::draw_manipulability(frames.palm.origin(), manipulability,
+                                 meshes());
+}
+
+void display()
+{
+    begin_main_frame();
+    draw_world(mygllib::Windows::view(), static_layer);
+    end_main_scene();
+    draw_hud();
+    if (capture)
+        capture->capture(mygllib::Windows::width(), mygllib::Windows::height());
+
+    mygllib::swap_buffers();
+    end_main_frame();
+    mygllib::debug_frame();
+    if (command_server) command_server->frame_presented(frame_count);
+    ++frame_count;
 }
 
 //==============================================================
-// Display
+// Fleet (--fleet <n>)
+//
+// Many arms stepped on a WorkPool by their own thread; the window
+// draws the newest complete tick and never waits for the sim. With
+// --shards the arms are stepped by that many child processes instead
+// and this one only draws.
 //==============================================================
-void display()
+namespace cfg
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const unsigned int FLEET_TICK_MS  = 10;   // 100 Hz fleet sim
+    const unsigned int FLEET_FRAME_MS = 16;   // redraw rate
+}
 
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    mygllib::SingletonView::getInstance()->lookat();
+arm::Fleet * fleet = NULL;
+arm::ShardedFleet * sharded = NULL;
+mygllib::WorkPool * fleet_pool = NULL;
+std::thread fleet_thread;
+std::atomic< bool > fleet_running(false);
+std::atomic< int64_t > fleet_tick_ns(0);     // cost of the last step()
 
-    mygllib::Light::all_off();
-    mygllib::draw_xz_plane();
-    mygllib::draw_axes();
-    mygllib::Light::all_on();
-    
-    light.on();
-    glEnable(GL_NORMALIZE);
-    glShadeModel(GL_SMOOTH);
-    light.set_position();
-    
-    // base
-    glPushMatrix();
+void run_fleet()
+{
+    const int64_t period = cfg::FLEET_TICK_MS * 1000000LL;
+    int64_t next = mygllib::now_ns();
+    while (fleet_running.load())
     {
-        glTranslatef(xb, yb, zb);
-        glScalef(cfg::BASE_SX, cfg::BASE_SY, cfg::BASE_SZ);
-        draw_base(cfg::BASE_SIZE);
+        const int64_t t0 = mygllib::now_ns();
+        fleet->step(*fleet_pool, cfg::FLEET_TICK_MS * 1e-3f);
+        const int64_t t1 = mygllib::now_ns();
+        fleet_tick_ns.store(t1 - t0);
+
+        next += period;
+        if (next > t1)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(next - t1));
+        else
+            next = t1;                  // over budget: don't try to catch up
     }
-    glPopMatrix();
+}
 
-    // upper arm joint (shoulder)
-    glPushMatrix();
+void stop_fleet()
+{
+    if (sharded)
     {
-        glRotatef(shoulder_pitch, 1.0f, 0.0f, 0.0f); // X
-        glRotatef(shoulder_yaw,   0.0f, 1.0f, 0.0f); // Y
-        glRotatef(shoulder_roll,  0.0f, 0.0f, 1.0f); // Z
+        sharded->stop();
+        std::vector< arm::ShardStats > stats(sharded->shards());
+        for (int i = 0; i < sharded->shards(); ++i) stats[i] = sharded->stats(i);
+        arm::report(stats.data(), sharded->shards(), std::cout);
+        delete sharded;
+        sharded = NULL;
+    }
+    if (!fleet_thread.joinable()) return;
+    fleet_running.store(false);
+    fleet_thread.join();
+}
 
-        draw_joint(cfg::JOINT_R);
- 
-        // upper arm
-        glPushMatrix();
-        {
-            glTranslatef(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
-
-            glPushMatrix();
-            {
-                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
-                draw_arm(cfg::ARM_R, cfg::ARM_L);
-            }
-            glPopMatrix();
-
-            // forearm joint (elbow)
-            glTranslatef(0.0f, cfg::ARM_L - cfg::LINK_GAP(), 0.0f);
-            glRotatef(elbow_pitch, 1.0f, 0.0f, 0.0f); // X
-            glRotatef(elbow_yaw,   0.0f, 1.0f, 0.0f); // Y
-            glRotatef(elbow_roll,  0.0f, 0.0f, 1.0f); // Z
-
-            draw_joint(cfg::JOINT_R);
-
-            // forearm
-            glTranslatef(0.0f, cfg::JOINT_R + cfg::LINK_GAP(), 0.0f);
-            glPushMatrix();
-            {
-                glRotatef(cfg::ROT_Z_TO_Y, 1.0f, 0.0f, 0.0f);
-                draw_arm(cfg::ARM_R, cfg::ARM_L);
-            }
-            glPopMatrix();
-        
-            // palm: top of forearm plus half the palm cube
-            glTranslatef(0.0f, cfg::ARM_L + 0.5f * cfg::PALM_SIZE, 0.0f);
-            draw_cube(cfg::PALM_SIZE);
-
-            // fingers
-            const GLfloat t = -grip;
-
-            // finger 0 (center)
-            {
-                const FingerAngles A = mix(OPEN_F0, CLOSED_F0, t);
-                draw_finger(+cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, 0.0f,
-                            A.baseZ, A.jointZ, A.tipY);
-            }
-
-            // finger 1 (left, front-right)
-            {
-                const FingerAngles A = mix(OPEN_F1, CLOSED_F1, t);
-                draw_finger(-cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, +cfg::FINGER_OFFSET_Z,
-                            A.baseZ, A.jointZ, A.tipY);
-            }
-
-            // finger 2 (left, back-right)
-            {
-                const FingerAngles A = mix(OPEN_F2, CLOSED_F2, t);
-                draw_finger(-cfg::FINGER_OFFSET_X, cfg::PALM_TO_FINGER_Y, -cfg::FINGER_OFFSET_Z,
-                            A.baseZ, A.jointZ, A.tipY);
-            }
-        }
-        glPopMatrix();
+// the newest tick of whichever fleet is running
+const arm::FleetState & fleet_front()
+{
+    if (sharded)
+    {
+        sharded->acquire();
+        return sharded->front();
     }
-    glPopMatrix();
+    fleet->acquire();
+    return fleet->front();
+}
 
-    glutSwapBuffers();
+void fleet_display()
+{
+    begin_main_frame();
+    const arm::FleetState & s = fleet_front();
+    arm::draw_fleet(s, mygllib::Windows::view(), meshes(), scene_detail());
+    end_main_scene();
+
+    size_t colliding = 0;
+    for (size_t k = 0; k < s.size(); ++k) colliding += s.colliding[k];
+    char line[128];
+    hud.clear();
+    if (sharded)
+    {
+        double tick_ms, wait_ms;
+        sharded->last_tick(tick_ms, wait_ms);
+        snprintf(line, sizeof(line), "fleet: %zu arms in %d shard processes",
+                 s.size(), sharded->shards());
+        hud.add(line);
+        snprintf(line, sizeof(line),
+                 "tick %llu  t %.1f s  step %.2f ms of %u ms, barrier wait %.2f ms mean",
+                 (unsigned long long) s.tick, s.t, tick_ms, cfg::FLEET_TICK_MS,
+                 wait_ms);
+        hud.add(line);
+    }
+    else
+    {
+        const double tick_ms = mygllib::ns_to_ms(fleet_tick_ns.load());
+        snprintf(line, sizeof(line), "fleet: %zu arms on %d threads", s.size(),
+                 fleet_pool->threads());
+        hud.add(line);
+        snprintf(line, sizeof(line), "tick %llu  t %.1f s  step %.2f ms of %u ms",
+                 (unsigned long long) s.tick, s.t, tick_ms, cfg::FLEET_TICK_MS);
+        hud.add(line);
+    }
+    snprintf(line, sizeof(line), "%zu arms hitting themselves or their base",
+             colliding);
+    hud.add(line);
+    snprintf(line, sizeof(line),
+             "arm-arm: %u candidate pairs (%.2f ms), %u touching (%.2f ms)",
+             s.candidate_pairs, s.broadphase_ms, s.contact_pairs, s.narrow_ms);
+    hud.add(line);
+    add_latency_lines();
+    add_quality_line();
+    hud.draw();
+    if (capture)
+        capture->capture(mygllib::Windows::width(), mygllib::Windows::height());
+
+    mygllib::swap_buffers();
+    end_main_frame();
+    mygllib::debug_frame();
+    ++frame_count;
+}
+
+void fleet_frame(int)
+{
+    mygllib::Windows::redisplay_all();
+    glutTimerFunc(cfg::FLEET_FRAME_MS, fleet_frame, 0);
+}
+
+// glutCloseFunc: the context is still current here
+void close_window()
+{
+    finish_capture();
+    finish_latency();
+    stop_fleet();
+    delete depth_camera;
+    depth_camera = NULL;
+    delete static_layer;
+    static_layer = NULL;
+    delete scaled;
+    scaled = NULL;
+    delete command_server;              // unlinks the mailbox and socket
+    command_server = NULL;
+    delete telemetry;                   // unlinks the telemetry block
+    telemetry = NULL;
+    mygllib::trace_close();
 }
 
 //==============================================================
 // User input
 //==============================================================
+void keyboard(unsigned char key, int x, int y)
+{
+    if (key == 'm')
+    {
+        mygllib::InputLatency::input(mygllib::InputLatency::KEY);
+        show_manipulability = !show_manipulability;
+        mygllib::Windows::redisplay_all();
+        return;
+    }
+    if (key == 'p')
+    {
+        mygllib::InputLatency::input(mygllib::InputLatency::KEY);
+        start_pick_demo();
+        mygllib::Windows::redisplay_all();
+        return;
+    }
+    if (key == 'h')
+    {
+        mygllib::InputLatency::input(mygllib::InputLatency::KEY);
+        scripts.stop();
+        home_from = current_pose();
+        home_t = 0.0f;
+        mygllib::Windows::redisplay_all();
+        return;
+    }
+    mygllib::Keyboard::keyboard(key, x, y);   // stamps its own input
+}
+
 void specialkeyboard(int key, int, int)
 {
+    mygllib::InputLatency::input(mygllib::InputLatency::SPECIAL);
+    if (key >= GLUT_KEY_F1 && key <= GLUT_KEY_F12) home_t = 1.0f;
+
+    // the operator takes over from a script
+    if ((key >= GLUT_KEY_F1 && key <= GLUT_KEY_F12)
+        || key == GLUT_KEY_UP || key == GLUT_KEY_DOWN)
+        scripts.stop();
     switch (key)
     {
-        // Shoulder (upper arm)
-        case GLUT_KEY_F1:  shoulder_pitch += dt; break;
-        case GLUT_KEY_F2:  shoulder_pitch -= dt; break;
-        case GLUT_KEY_F3:  shoulder_yaw   += dt; break;
-        case GLUT_KEY_F4:  shoulder_yaw   -= dt; break;
-        case GLUT_KEY_F5: shoulder_roll  += dt; break;
-        case GLUT_KEY_F6: shoulder_roll  -= dt; break;
+        // Shoulder (upper arm), about its own axes
+        case GLUT_KEY_F1:  turn(shoulder_q, +dt, 1.0f, 0.0f, 0.0f); break;
+        case GLUT_KEY_F2:  turn(shoulder_q, -dt, 1.0f, 0.0f, 0.0f); break;
+        case GLUT_KEY_F3:  turn(shoulder_q, +dt, 0.0f, 1.0f, 0.0f); break;
+        case GLUT_KEY_F4:  turn(shoulder_q, -dt, 0.0f, 1.0f, 0.0f); break;
+        case GLUT_KEY_F5:  turn(shoulder_q, +dt, 0.0f, 0.0f, 1.0f); break;
+        case GLUT_KEY_F6:  turn(shoulder_q, -dt, 0.0f, 0.0f, 1.0f); break;
 
         // Elbow (forearm)
-        case GLUT_KEY_F7: elbow_pitch += dt; break;
-        case GLUT_KEY_F8: elbow_pitch -= dt; break;
-        case GLUT_KEY_F9: elbow_yaw   += dt; break;
-        case GLUT_KEY_F10: elbow_yaw   -= dt; break;
-        case GLUT_KEY_F11: elbow_roll  += dt; break;
-        case GLUT_KEY_F12: elbow_roll  -= dt; break;
+        case GLUT_KEY_F7:  turn(elbow_q, +dt, 1.0f, 0.0f, 0.0f); break;
+        case GLUT_KEY_F8:  turn(elbow_q, -dt, 1.0f, 0.0f, 0.0f); break;
+        case GLUT_KEY_F9:  turn(elbow_q, +dt, 0.0f, 1.0f, 0.0f); break;
+        case GLUT_KEY_F10: turn(elbow_q, -dt, 0.0f, 1.0f, 0.0f); break;
+        case GLUT_KEY_F11: turn(elbow_q, +dt, 0.0f, 0.0f, 1.0f); break;
+        case GLUT_KEY_F12: turn(elbow_q, -dt, 0.0f, 0.0f, 1.0f); break;
 
         // Grip (fingers)
         case GLUT_KEY_UP:  grip += 0.05f; clamp_grip(); break;
@@ -389,20 +921,480 @@ void specialkeyboard(int key, int, int)
         default: break;
     }
 
-    glutPostRedisplay();
+    mygllib::Windows::redisplay_all();
+}
+
+//==============================================================
+// Mouse: press on a part of the arm and drag it
+//==============================================================
+arm::Ray mouse_ray(int x, int y)
+{
+    return arm::view_ray(mygllib::Windows::view(), x, y,
+                         mygllib::Windows::width(), mygllib::Windows::height());
+}
+
+void mouse(int button, int state, int x, int y)
+{
+    if (button != GLUT_LEFT_BUTTON) return;
+    mygllib::InputLatency::input(mygllib::InputLatency::MOUSE);
+    if (state == GLUT_DOWN)
+    {
+        const int64_t t0 = mygllib::now_ns();
+        arm::ArmShapes shapes;
+        arm::arm_shapes(frames, shapes);
+        drag.begin(mouse_ray(x, y), shapes);
+        home_t = 1.0f;
+        if (drag.active()) scripts.stop();
+        pick_us = (mygllib::now_ns() - t0) * 1e-3;
+    }
+    else
+    {
+        drag.end();
+    }
+    mygllib::Windows::redisplay_all();
+}
+
+void motion(int x, int y)
+{
+    if (!drag.active()) return;
+    mygllib::InputLatency::input(mygllib::InputLatency::MOUSE);
+    scripts.stop();
+    arm::Pose pose = current_pose();
+    drag.move(mouse_ray(x, y), pose);
+    set_joints(pose);
+    mygllib::Windows::redisplay_all();
+}
+
+//==============================================================
+// More views (--views): an overview from above and a camera on the
+// wrist, each in its own window with its own View. They draw with the
+// main window's context, so nothing is uploaded twice, and like the
+// main window redraw only when the scene or their camera changes.
+//==============================================================
+namespace cfg
+{
+    const int VIEWS_W = 300;
+    const int VIEWS_H = 300;
+    const int VIEWS_GAP = 40;               // between windows
+    const GLfloat OVERVIEW_EYE_Y = 18.0f;
+    const GLfloat OVERVIEW_FOVY = 60.0f;
+
+    // wrist camera, in palm coordinates: above the back of the hand,
+    // looking out past the fingers
+    const GLfloat WRIST_EYE_Y = -0.3f;
+    const GLfloat WRIST_EYE_Z = -1.2f;
+    const GLfloat WRIST_REF_Y = 3.0f;
+    const GLfloat WRIST_FOVY = 70.0f;
+}
+
+void overview_display()
+{
+    mygllib::Windows::apply();
+    mygllib::InputLatency::frame();
+    if (fleet || sharded)
+    {
+        arm::draw_fleet(fleet_front(), mygllib::Windows::view(), meshes(),
+                        scene_detail());
+    }
+    else
+    {
+        draw_world(mygllib::Windows::view());
+    }
+    mygllib::swap_buffers();
+    mygllib::InputLatency::presented();
+    mygllib::debug_frame();
+}
+
+// puts view's eye on the wrist, following the palm
+void follow_palm(mygllib::View & view)
+{
+    const arm::Mat4 & palm = frames.palm;
+    const arm::Vec3 eye = palm.point(arm::Vec3(0.0f, cfg::WRIST_EYE_Y,
+                                               cfg::WRIST_EYE_Z));
+    const arm::Vec3 ref = palm.point(arm::Vec3(0.0f, cfg::WRIST_REF_Y, 0.0f));
+    const arm::Vec3 up = -palm.zaxis();
+    view.eyex() = eye.x; view.eyey() = eye.y; view.eyez() = eye.z;
+    view.refx() = ref.x; view.refy() = ref.y; view.refz() = ref.z;
+    view.upx() = up.x;   view.upy() = up.y;   view.upz() = up.z;
+}
+
+// The eye follows the palm, so only the lens keys (fovy, near, far)
+// stick in this window.
+void wrist_display()
+{
+    mygllib::View & view = mygllib::Windows::view();
+    follow_palm(view);
+
+    mygllib::Windows::apply();
+    mygllib::InputLatency::frame();
+    draw_world(view);
+    mygllib::swap_buffers();
+    mygllib::InputLatency::presented();
+    mygllib::debug_frame();
+}
+
+// Wrist depth camera timer: publishes finished readbacks every
+// DEPTH_CAMERA_POLL_MS and draws a new frame when one is due. The
+// windows share one context, so whichever is current will do.
+int64_t depth_camera_next_ns = 0;
+
+void depth_camera_frame(int)
+{
+    if (!depth_camera) return;          // closed
+    depth_camera->poll();
+    const int64_t now = mygllib::now_ns();
+    if (now >= depth_camera_next_ns)
+    {
+        depth_camera_next_ns += int64_t(1e9 / depth_camera_hz);
+        if (depth_camera_next_ns < now) depth_camera_next_ns = now; // behind
+        mygllib::View lens(0, 0, 1, 0, 0, 0, 0, 1, 0,
+                           mygllib::View::PERSPECTIVE, cfg::WRIST_FOVY, 1.0f,
+                           cfg::DEPTH_CAMERA_NEAR, cfg::DEPTH_CAMERA_FAR);
+        follow_palm(lens);
+        if (depth_camera->begin(lens))
+        {
+            draw_world(lens);
+            depth_camera->end();
+        }
+    }
+    glutTimerFunc(cfg::DEPTH_CAMERA_POLL_MS, depth_camera_frame, 0);
+}
+
+// input callbacks of the current window
+void input_callbacks()
+{
+    glutKeyboardFunc(keyboard);
+    glutSpecialFunc(specialkeyboard);
+    glutReshapeFunc(mygllib::Reshape::reshape);
+    glutCloseFunc(close_window);        // context is still current here
+    if (!fleet && !sharded)
+    {
+        glutMouseFunc(mouse);
+        glutMotionFunc(motion);
+    }
+}
+
+// Opens the extra windows to the right of the main one, which is made
+// current again afterwards.
+void open_views(GLfloat overview_eye_y)
+{
+    const int main_window = glutGetWindow();
+    const int x = mygllib::WIN_X + mygllib::WIN_W + cfg::VIEWS_GAP;
+
+    const mygllib::View top(0.0f, overview_eye_y, 0.0f, 0.0f, 0.0f, 0.0f,
+                            0.0f, 0.0f, -1.0f, mygllib::View::PERSPECTIVE,
+                            cfg::OVERVIEW_FOVY);
+    mygllib::Windows::open("overview", top, x, mygllib::WIN_Y,
+                           cfg::VIEWS_W, cfg::VIEWS_H);
+    glutDisplayFunc(overview_display);
+    input_callbacks();
+
+    if (!fleet && !sharded)             // one wrist per window
+    {
+        mygllib::View wrist;
+        wrist.fovy() = cfg::WRIST_FOVY;
+        mygllib::Windows::open("wrist camera", wrist, x,
+                               mygllib::WIN_Y + cfg::VIEWS_H + cfg::VIEWS_GAP,
+                               cfg::VIEWS_W, cfg::VIEWS_H);
+        glutDisplayFunc(wrist_display);
+        input_callbacks();
+    }
+    glutSetWindow(main_window);
+}
+
+//==============================================================
+// Posed mesh export
+//==============================================================
+int run_export(const char * poses, const char * out_dir,
+               arm::MeshExporter::Format format)
+{
+    try
+    {
+        // the pose list format of --batch; the camera is not used
+        const std::vector< arm::BatchItem > items = arm::read_pose_list(poses);
+        std::vector< arm::Pose > p(items.size());
+        for (size_t i = 0; i < items.size(); ++i) p[i] = items[i].pose;
+        arm::report(arm::export_poses(p, out_dir, format, arm_meshes),
+                    std::cout);
+    }
+    catch (arm::BatchError &)
+    {
+        return 1;
+    }
+    catch (arm::ExportError &)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+//==============================================================
+// Headless replay
+//==============================================================
+// no timer runs headless: one sim step per rendered frame
+void replay_display()
+{
+    animate(cfg::REPLAY_FRAME_S);
+    run_scripts(cfg::REPLAY_FRAME_S);
+    update_sim();
+    display();
+}
+
+int run_replay(const char * script, const char * golden,
+               const char * write_golden, bool realtime, const char * record)
+{
+    const int w = mygllib::WIN_W, h = mygllib::WIN_H;
+    try
+    {
+        mygllib::HEADLESS = true;
+        mygllib::OffscreenContext context(w, h);
+        context.make_current();
+        mygllib::debug_context();
+        init();
+        if (use_static_layer) static_layer = new mygllib::StaticLayer;
+        mygllib::Reshape::reshape(w, h);
+
+        arm::Replay replay(script);
+        if (record) capture = new mygllib::FrameCapture(record, w, h);
+        start_ns = mygllib::now_ns();
+        show_manipulability = false;    // keeps the goldens arm-only
+        replay.mouse(mouse, motion);
+        replay.run(w, h, replay_display, keyboard, specialkeyboard, realtime);
+        finish_capture();
+        if (static_layer)
+            std::cout << "static layer: drawn " << static_layer->draws()
+                      << ", reused " << static_layer->restores() << std::endl;
+        delete static_layer;            // while the context is current
+        static_layer = NULL;
+        replay.report(std::cout);
+        if (write_golden) replay.write_golden(write_golden);
+        if (golden && replay.check_golden(golden, std::cout) != 0) return 1;
+    }
+    catch (mygllib::OffscreenError &)
+    {
+        return 1;
+    }
+    catch (arm::ReplayError &)
+    {
+        return 1;
+    }
+    catch (mygllib::CaptureError &)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+//==============================================================
+// Headless batch rendering
+//==============================================================
+int run_batch(const char * poses, const char * out_dir, int threads,
+              int w, int h)
+{
+    try
+    {
+        mygllib::HEADLESS = true;
+        const std::vector< arm::BatchItem > items = arm::read_pose_list(poses);
+        arm::report(arm::render_batch(items, out_dir, threads, w, h, arm_meshes),
+                    std::cout);
+    }
+    catch (arm::BatchError &)
+    {
+        return 1;
+    }
+    return 0;
 }
 
 //==============================================================
 // main
+//
+// USAGE:
+// main.exe [--record <file.y4m>] [--grasp <shape>] [--views]
+//                                            interactive window
+// main.exe --replay <script> [--golden <file>] [--write-golden <file>]
+//          [--fast] [--record <file.y4m>] [--grasp <shape>]
+//                                            headless scripted replay
+// <shape> is sphere, box or capsule: an object held between the fingers
+// main.exe --batch <poses> [--out <dir>] [--threads <n>] [--size <w>x<h>]
+//                                            headless pose dataset
+// main.exe --export <poses> [--out <dir>] [--format stl|ply]
+//                                            posed arm meshes, one per pose
+// main.exe --fleet <arms> [--threads <n>] [--shards <n>]
+//          [--record <file.y4m>] [--views]   many arms, one window
+// --shards steps the fleet in <n> lockstep processes (--threads each)
+// --views adds an overview window and (one arm) a wrist camera window
+// --governor <ms> (interactive, fleet or replay) lowers the rendering
+// quality while frames take longer than <ms>; --shadows draws arm shadows
+// --no-static-cache (interactive or replay) redraws the grid and base
+// every frame instead of keeping them between frames
+// --latency <file.csv> (interactive or replay) writes the input-to-photon
+// latency of every key press and drag; --gl-finish times it to glFinish()
+// --gl-trace <file> (any mode, make DEBUG=1 builds only) logs every
+// traced GL call and driver message to <file>
 //==============================================================
 int main(int argc, char ** argv)
 {
+    const char * replay = NULL;
+    const char * golden = NULL;
+    const char * write_golden = NULL;
+    bool realtime = true;
+    bool views = false;
+    const char * record = NULL;
+    const char * gl_trace = NULL;
+    const char * latency = NULL;
+    double governor_ms = 0.0;
+    const char * batch = NULL;
+    const char * export_poses = NULL;
+    const char * out_dir = NULL;
+    arm::MeshExporter::Format format = arm::MeshExporter::STL;
+    int threads = 0;                    // 0: per mode default
+    size_t fleet_arms = 0;
+    int shards = 0;
+    int w = mygllib::WIN_W, h = mygllib::WIN_H;
+    arm::GraspObject::Shape shape = arm::GraspObject::NONE;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc)            replay = argv[++i];
+        else if (arg == "--golden" && i + 1 < argc)       golden = argv[++i];
+        else if (arg == "--write-golden" && i + 1 < argc) write_golden = argv[++i];
+        else if (arg == "--fast")                         realtime = false;
+        else if (arg == "--views")                        views = true;
+        else if (arg == "--record" && i + 1 < argc)       record = argv[++i];
+        else if (arg == "--gl-trace" && i + 1 < argc)     gl_trace = argv[++i];
+        else if (arg == "--latency" && i + 1 < argc)      latency = argv[++i];
+        else if (arg == "--gl-finish")                    mygllib::InputLatency::finish(true);
+        else if (arg == "--governor" && i + 1 < argc)     governor_ms = atof(argv[++i]);
+        else if (arg == "--shadows")                      shadows = true;
+        else if (arg == "--depth-camera" && i + 1 < argc) depth_camera_hz = atof(argv[++i]);
+        else if (arg == "--no-static-cache")              use_static_layer = false;
+        else if (arg == "--batch" && i + 1 < argc)        batch = argv[++i];
+        else if (arg == "--export" && i + 1 < argc)       export_poses = argv[++i];
+        else if (arg == "--out" && i + 1 < argc)          out_dir = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)      threads = atoi(argv[++i]);
+        else if (arg == "--fleet" && i + 1 < argc)        fleet_arms = strtoul(argv[++i], NULL, 10);
+        else if (arg == "--shards" && i + 1 < argc)       shards = atoi(argv[++i]);
+        else if (arg == "--grasp" && i + 1 < argc
+                 && arm::parse_shape(argv[i + 1], shape)) ++i;
+        else if (arg == "--format" && i + 1 < argc
+                 && arm::parse_format(argv[i + 1], format)) ++i;
+        else if (arg == "--size" && i + 1 < argc
+                 && sscanf(argv[i + 1], "%dx%d", &w, &h) == 2) ++i;
+        else
+        {
+            std::cout << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    // no GL involved
+    if (export_poses)
+        return run_export(export_poses, out_dir ? out_dir : "export_out", format);
+    if (gl_trace && !mygllib::GL_DEBUG)
+    {
+        std::cout << "--gl-trace: built without the GL debug layer"
+                     " (make clean; make DEBUG=1)" << std::endl;
+        return 1;
+    }
+    if (gl_trace && !mygllib::trace_open(gl_trace)) return 1;
+    if (governor_ms > 0.0)
+        governor = new mygllib::QualityGovernor(governor_ms, cfg::QUALITY_LEVELS);
+    scaled = new mygllib::ScaledFramebuffer;  // buffer made on first use
+    if (latency)
+    {
+        if (!mygllib::InputLatency::open_csv(latency)) return 1;
+        latency_csv = true;
+    }
+    grasp_object = arm::grasp_object(shape);
+    update_sim();
+
+    if (replay || batch)
+    {
+        const int ret = replay
+            ? run_replay(replay, golden, write_golden, realtime, record)
+            : run_batch(batch, out_dir ? out_dir : "batch_out", threads > 0 ? threads : 1, w, h);
+        finish_latency();
+        if (governor)
+            std::cout << "quality governor: level " << governor->level()
+                      << " of " << cfg::QUALITY_LEVELS - 1 << " after "
+                      << governor->changes() << " changes" << std::endl;
+        mygllib::trace_close();
+        return ret;
+    }
+
+    // fork the shards before this process starts threads or GL
+    if (fleet_arms > 0 && shards > 0)
+    {
+        try
+        {
+            sharded = new arm::ShardedFleet(fleet_arms, shards,
+                                            cfg::FLEET_TICK_MS * 1000000LL, 0,
+                                            threads > 0 ? threads : 1);
+        }
+        catch (arm::ShardError &)
+        {
+            return 1;
+        }
+    }
+
     mygllib::init3d();
+    mygllib::debug_context();
     init();
-    glutDisplayFunc(display);
-    glutKeyboardFunc(mygllib::Keyboard::keyboard);
-    glutSpecialFunc(specialkeyboard);
-    glutReshapeFunc(mygllib::Reshape::reshape);
+    GLfloat overview_eye_y = cfg::OVERVIEW_EYE_Y;
+    if (fleet_arms > 0)
+    {
+        // back the camera off until the whole cell is in view
+        const GLfloat cell = std::ceil(std::sqrt(GLfloat(fleet_arms)))
+                           * cfg::FLEET_SPACING;
+        const GLfloat zoom = std::max(1.0f, 0.6f * cell / cfg::EYE_X);
+        mygllib::View & view = *(mygllib::SingletonView::getInstance());
+        view.eyex() = zoom * cfg::EYE_X;
+        view.eyey() = zoom * cfg::EYE_Y;
+        view.eyez() = zoom * cfg::EYE_Z;
+        overview_eye_y *= zoom;
+
+        if (!sharded)
+        {
+            fleet = new arm::Fleet(fleet_arms);
+            fleet_pool = new mygllib::WorkPool(
+                threads > 0 ? threads : int(std::thread::hardware_concurrency()));
+            fleet_running.store(true);
+            fleet_thread = std::thread(run_fleet);
+        }
+        glutDisplayFunc(fleet_display);
+        glutTimerFunc(cfg::FLEET_FRAME_MS, fleet_frame, 0);
+    }
+    else
+    {
+        // only the single-arm tick polls commands and publishes telemetry
+        command_server = new arm::CommandServer;
+        telemetry = new arm::TelemetryPublisher;
+        glutDisplayFunc(display);
+        if (use_static_layer) static_layer = new mygllib::StaticLayer;
+        glutTimerFunc(cfg::TICK_MS, tick, 0);
+    }
+    input_callbacks();
+    if (views) open_views(overview_eye_y);
+    if (depth_camera_hz > 0.0 && fleet_arms == 0)
+    {
+        depth_camera = new mygllib::DepthCamera(cfg::DEPTH_CAMERA_W,
+                                                cfg::DEPTH_CAMERA_H);
+        depth_camera_next_ns = mygllib::now_ns();
+        glutTimerFunc(cfg::DEPTH_CAMERA_POLL_MS, depth_camera_frame, 0);
+    }
+    if (record)
+    {
+        try
+        {
+            capture = new mygllib::FrameCapture(record, mygllib::WIN_W,
+                                                mygllib::WIN_H);
+        }
+        catch (mygllib::CaptureError &)
+        {
+            stop_fleet();
+            return 1;
+        }
+    }
+    start_ns = mygllib::now_ns();
     glutMainLoop();
     
     return 0;
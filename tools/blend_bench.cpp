@@ -0,0 +1,146 @@
+// File  : blend_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Times arm::BlendTree::evaluate() (packed channels, SSE) against the
+// straightforward per-arm loop over Pose structs, for a blend of four
+// keyframes (ball joints as quaternions) and two additive layers with
+// random per-arm weights, and checks that both give the same poses.
+//
+// USAGE:
+// ./tools/blend_bench.exe [reps] [arms ...]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Clock.h"
+#include "Blend.h"
+
+namespace
+{
+    const int KEYS = 4;
+    const int LAYERS = 2;
+
+    arm::Pose random_pose(std::mt19937 & rng)
+    {
+        std::uniform_real_distribution< float > angle(-90.0f, 90.0f);
+        std::uniform_real_distribution< float > unit(0.0f, 1.0f);
+        arm::Pose p =
+        {
+            angle(rng), angle(rng), angle(rng), angle(rng), angle(rng),
+            angle(rng), unit(rng), unit(rng), unit(rng), unit(rng),
+        };
+        return p;
+    }
+
+    // q += w * r, r flipped to q's side
+    void accumulate(arm::Quat & q, const arm::Quat & r, GLfloat w)
+    {
+        if (mygllib::dot(q, r) < 0.0f) w = -w;
+        q.w += w * r.w;
+        q.x += w * r.x;
+        q.y += w * r.y;
+        q.z += w * r.z;
+    }
+
+    // what blending looks like without packing: one Pose at a time (a Pose
+    // is ten GLfloats in channel order)
+    void blend_poses(const arm::Pose * key, const arm::Pose * layer,
+                     const std::vector< GLfloat > * w,
+                     const std::vector< GLfloat > * a,
+                     std::vector< arm::Pose > & out)
+    {
+        for (size_t k = 0; k < out.size(); ++k)
+        {
+            GLfloat * o = &out[k].shoulder_pitch;
+            GLfloat sum = 0.0f;
+            arm::Quat shoulder(0.0f), elbow(0.0f);
+            for (int c = 0; c < arm::BLEND_CHANNELS; ++c) o[c] = 0.0f;
+            for (int i = 0; i < KEYS; ++i)
+            {
+                const GLfloat * v = &key[i].shoulder_pitch;
+                sum += w[i][k];
+                for (int c = 0; c < arm::BLEND_CHANNELS; ++c) o[c] += w[i][k] * v[c];
+                accumulate(shoulder, arm::shoulder_rotation(key[i]), w[i][k]);
+                accumulate(elbow, arm::elbow_rotation(key[i]), w[i][k]);
+            }
+            const GLfloat inv = sum > 0.0f ? 1.0f / sum : 0.0f;
+            for (int c = 0; c < arm::BLEND_CHANNELS; ++c) o[c] *= inv;
+            arm::set_shoulder_rotation(out[k], mygllib::normalize(shoulder));
+            arm::set_elbow_rotation(out[k], mygllib::normalize(elbow));
+            for (int j = 0; j < LAYERS; ++j)
+            {
+                const GLfloat * v = &layer[j].shoulder_pitch;
+                for (int c = 0; c < arm::BLEND_CHANNELS; ++c) o[c] += a[j][k] * v[c];
+            }
+        }
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    const int reps = argc > 1 ? atoi(argv[1]) : 200;
+    std::vector< size_t > sizes;
+    for (int i = 2; i < argc; ++i) sizes.push_back(strtoul(argv[i], NULL, 10));
+    if (sizes.empty())
+    {
+        const size_t defaults[] = { 100, 1000, 10000 };
+        sizes.assign(defaults, defaults + 3);
+    }
+
+    printf("%d keyframes, %d additive layers, %d reps per run\n", KEYS,
+           LAYERS, reps);
+    printf("%8s %12s %12s %8s %10s %10s\n", "arms", "per-pose us", "packed us",
+           "speedup", "ns/arm", "max diff");
+    for (size_t s = 0; s < sizes.size(); ++s)
+    {
+        const size_t n = sizes[s];
+        std::mt19937 rng(1);
+        std::uniform_real_distribution< float > unit(0.0f, 1.0f);
+
+        arm::Pose key[KEYS], layer[LAYERS];
+        std::vector< GLfloat > w[KEYS], a[LAYERS];
+        arm::BlendTree tree(n);
+        for (int i = 0; i < KEYS; ++i)
+        {
+            key[i] = random_pose(rng);
+            tree.add_keyframe(key[i]);
+            w[i].resize(n);
+            for (size_t k = 0; k < n; ++k) w[i][k] = tree.weight(i)[k] = unit(rng);
+        }
+        for (int j = 0; j < LAYERS; ++j)
+        {
+            layer[j] = random_pose(rng);
+            tree.add_layer(layer[j]);
+            a[j].resize(n);
+            for (size_t k = 0; k < n; ++k) a[j][k] = tree.amount(j)[k] = unit(rng);
+        }
+
+        std::vector< arm::Pose > poses(n);
+        int64_t t0 = mygllib::now_ns();
+        for (int r = 0; r < reps; ++r) blend_poses(key, layer, w, a, poses);
+        const double naive_us = (mygllib::now_ns() - t0) * 1e-3 / reps;
+
+        arm::PoseArray packed;
+        packed.resize(n);
+        t0 = mygllib::now_ns();
+        for (int r = 0; r < reps; ++r) tree.evaluate(0, n, packed);
+        const double packed_us = (mygllib::now_ns() - t0) * 1e-3 / reps;
+
+        float diff = 0.0f;
+        for (size_t k = 0; k < n; ++k)
+        {
+            const arm::Pose p = packed.pose(k);
+            const GLfloat * u = &p.shoulder_pitch;
+            const GLfloat * v = &poses[k].shoulder_pitch;
+            for (int c = 0; c < arm::BLEND_CHANNELS; ++c)
+                diff = std::max(diff, std::fabs(u[c] - v[c]));
+        }
+        printf("%8zu %12.2f %12.2f %8.2f %10.2f %10.2g\n", n, naive_us,
+               packed_us, naive_us / packed_us, packed_us * 1e3 / n, diff);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// File  : broadphase_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Compares the SpatialHash broadphase with naive all-pairs on the floor
+// footprints of a simulated fleet: time per tick for each, candidate
+// pairs (the two must agree) and the cost of the narrow phase that
+// follows in Fleet::step(). Stations are FLEET_SPACING apart, so neighbours' workspaces
+// overlap the way they do in a dense cell.
+//
+// USAGE:
+// ./tools/broadphase_bench.exe [ticks] [arms ...]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Clock.h"
+#include "Fleet.h"
+
+namespace
+{
+    // mean ms per call over enough calls to take about 0.2 s
+    template < typename F >
+    double time_ms(F f)
+    {
+        int reps = 0;
+        const int64_t start = mygllib::now_ns();
+        int64_t elapsed = 0;
+        do
+        {
+            f();
+            ++reps;
+            elapsed = mygllib::now_ns() - start;
+        } while (elapsed < 200000000LL);
+        return mygllib::ns_to_ms(elapsed) / reps;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    const int ticks = argc > 1 ? atoi(argv[1]) : 100;
+    std::vector< size_t > sizes;
+    for (int i = 2; i < argc; ++i) sizes.push_back(strtoul(argv[i], NULL, 10));
+    if (sizes.empty())
+    {
+        const size_t defaults[] = { 100, 1000, 10000 };
+        sizes.assign(defaults, defaults + 3);
+    }
+
+    printf("cell %.1f, stations %.1f apart, pose after %d ticks\n",
+           cfg::BROADPHASE_CELL, cfg::FLEET_SPACING, ticks);
+    printf("%7s %11s %11s %8s %10s %10s %10s %8s\n", "arms", "naive ms",
+           "hash ms", "speedup", "pairs", "narrow ms", "contacts", "entries");
+    for (size_t s = 0; s < sizes.size(); ++s)
+    {
+        arm::Fleet fleet(sizes[s]);
+        mygllib::WorkPool pool(1);
+        for (int t = 0; t < ticks; ++t) fleet.step(pool, 0.01f);
+        const std::vector< arm::Footprint > & f = fleet.footprints();
+        fleet.acquire();
+        const arm::FleetState & state = fleet.front();
+
+        std::vector< arm::ArmPair > naive, hashed;
+        arm::SpatialHash hash;
+        const double naive_ms = time_ms([&] { arm::all_pairs(f, naive); });
+        const double hash_ms = time_ms([&] { hash.pairs(f, hashed); });
+
+        std::sort(naive.begin(), naive.end());
+        std::sort(hashed.begin(), hashed.end());
+        if (naive != hashed)
+        {
+            printf("%7zu: broadphase disagrees (%zu naive, %zu hashed pairs)\n",
+                   sizes[s], naive.size(), hashed.size());
+            return 1;
+        }
+
+        printf("%7zu %11.3f %11.3f %8.1f %10zu %10.3f %10u %8zu\n",
+               sizes[s], naive_ms, hash_ms, naive_ms / hash_ms, naive.size(),
+               state.narrow_ms, state.contact_pairs, hash.entries());
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// File  : ctrl_client.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Stand-in controller for the robotic arm visualizer. Streams joint and
+// grip commands at a fixed rate and reports command-to-frame latency, i.e.
+// the time from send() until the visualizer swapped the first frame that
+// shows the command.
+//
+// USAGE:
+// ./main.exe &
+// ./tools/ctrl_client.exe [-s] [-r rate_hz] [-n count]
+//     -s  use the UNIX socket fallback instead of shared memory
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Clock.h"
+#include "Command.h"
+
+namespace
+{
+    void sleep_until(int64_t t_ns)
+    {
+        timespec ts;
+        ts.tv_sec  = t_ns / 1000000000LL;
+        ts.tv_nsec = t_ns % 1000000000LL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+
+    double percentile(const std::vector< int64_t > & sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        const size_t i = size_t(p * (sorted.size() - 1) + 0.5);
+        return mygllib::ns_to_ms(sorted[i]);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    arm::CommandClient::Transport transport = arm::CommandClient::SHM;
+    double rate = 1000.0;
+    int count = 5000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-s") == 0) transport = arm::CommandClient::SOCKET;
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else
+        {
+            std::cout << "usage: " << argv[0] << " [-s] [-r rate_hz] [-n count]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        arm::CommandClient client(transport);
+        std::vector< int64_t > latency;
+        latency.reserve(count);
+
+        const int64_t period = int64_t(1e9 / rate);
+        const int64_t t0 = mygllib::now_ns();
+        arm::Ack ack;
+        for (int i = 0; i < count; ++i)
+        {
+            const double t = i / rate;
+            arm::Command cmd;
+            memset(&cmd, 0, sizeof(cmd));
+            cmd.mask = arm::Command::SHOULDER_YAW | arm::Command::ELBOW_PITCH
+                     | arm::Command::GRIP;
+            cmd.shoulder_yaw = 45.0f * sin(2 * M_PI * 0.25 * t);
+            cmd.elbow_pitch  = 30.0f * sin(2 * M_PI * 0.5 * t);
+            cmd.grip         = 0.5f + 0.5f * sin(2 * M_PI * 0.2 * t);
+            client.send(cmd);
+
+            while (client.latest_ack(ack))
+                latency.push_back(ack.frame_ns - ack.sent_ns);
+
+            sleep_until(t0 + (i + 1) * period);
+        }
+
+        // let the last frame land
+        const int64_t done = mygllib::now_ns();
+        while (mygllib::now_ns() - done < 200000000LL)
+        {
+            while (client.latest_ack(ack))
+                latency.push_back(ack.frame_ns - ack.sent_ns);
+            sleep_until(mygllib::now_ns() + 1000000LL);
+        }
+
+        const double secs = (done - t0) / 1e9;
+        std::sort(latency.begin(), latency.end());
+        std::cout << "sent " << count << " commands in " << secs << " s ("
+                  << count / secs << " Hz) via "
+                  << (transport == arm::CommandClient::SHM ? "shm" : "socket")
+                  << '\n'
+                  << "frames acked " << latency.size() << '\n';
+        if (!latency.empty())
+        {
+            std::cout << "command-to-frame latency (ms):"
+                      << " min " << percentile(latency, 0.0)
+                      << " p50 " << percentile(latency, 0.5)
+                      << " p90 " << percentile(latency, 0.9)
+                      << " p99 " << percentile(latency, 0.99)
+                      << " max " << percentile(latency, 1.0) << std::endl;
+        }
+    }
+    catch (arm::CommandError &)
+    {
+        return 1;
+    }
+    return 0;
+}
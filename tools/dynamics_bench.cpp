@@ -0,0 +1,60 @@
+// File  : dynamics_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Runs arm::inverse_dynamics() over a synthetic trajectory (every joint
+// swinging sinusoidally) and reports samples per second and the peak
+// torque per joint, i.e. what each motor has to deliver.
+//
+// USAGE:
+// ./tools/dynamics_bench.exe [samples] [period_s] [amplitude_deg]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Clock.h"
+#include "Dynamics.h"
+
+int main(int argc, char ** argv)
+{
+    const size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+    const float period = argc > 2 ? atof(argv[2]) : 2.0f;
+    const float amp = mygllib::deg2rad(argc > 3 ? atof(argv[3]) : 60.0f);
+    const int J = arm::NUM_JOINTS;
+    const arm::ArmModel model = arm::arm_model();
+
+    // 1 kHz samples; each joint at its own phase so the motion is not planar
+    std::vector< float > q(n * J), qd(n * J), qdd(n * J), tau(n * J);
+    const float w = 2.0f * mygllib::PI / period;
+    for (size_t k = 0; k < n; ++k)
+    {
+        const float t = k * 1e-3f;
+        for (int i = 0; i < J; ++i)
+        {
+            const float ph = w * t + i * 0.7f;
+            q[k * J + i]   = amp * std::sin(ph);
+            qd[k * J + i]  = amp * w * std::cos(ph);
+            qdd[k * J + i] = -amp * w * w * std::sin(ph);
+        }
+    }
+
+    const int64_t start = mygllib::now_ns();
+    arm::inverse_dynamics(model, &q[0], &qd[0], &qdd[0], &tau[0], n);
+    const double secs = (mygllib::now_ns() - start) / 1e9;
+
+    float peak[arm::NUM_JOINTS] = { 0 };
+    for (size_t k = 0; k < n; ++k)
+        for (int i = 0; i < J; ++i)
+            peak[i] = std::max(peak[i], std::fabs(tau[k * J + i]));
+
+    printf("links: upper arm %.2f kg, forearm+hand %.2f kg (base %.2f kg)\n",
+           model.link[2].m, model.link[5].m, model.base_mass);
+    printf("%zu samples in %.3f s: %.2f M samples/s\n", n, secs, n / secs / 1e6);
+    const char * names[] = { "shoulder pitch", "shoulder yaw", "shoulder roll",
+                             "elbow pitch", "elbow yaw", "elbow roll" };
+    for (int i = 0; i < J; ++i)
+        printf("  %-15s peak %8.2f N m\n", names[i], peak[i]);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// File  : fleet_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Times arm::Fleet::step() for a range of fleet sizes and WorkPool thread
+// counts and prints one row per combination: mean tick time, arms per
+// millisecond, speedup over one thread and parallel efficiency, plus the
+// share of chunks that were stolen. Scaling stops where the speedup
+// flattens (at the number of cores, or earlier for small fleets whose
+// tick is dominated by the fork/join).
+//
+// USAGE:
+// ./tools/fleet_bench.exe [ticks] [max_threads] [arms ...]
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "Clock.h"
+#include "Fleet.h"
+
+int main(int argc, char ** argv)
+{
+    const int ticks = argc > 1 ? atoi(argv[1]) : 50;
+    const int cores = int(std::thread::hardware_concurrency());
+    const int max_threads = argc > 2 ? atoi(argv[2])
+                                     : (cores > 4 ? 2 * cores : 8);
+    std::vector< size_t > sizes;
+    for (int i = 3; i < argc; ++i) sizes.push_back(strtoul(argv[i], NULL, 10));
+    if (sizes.empty())
+    {
+        const size_t defaults[] = { 10, 100, 1000, 10000 };
+        sizes.assign(defaults, defaults + 4);
+    }
+
+    printf("%d hardware threads, %d ticks per run\n", cores, ticks);
+    printf("%8s %7s %10s %10s %8s %6s %7s\n", "arms", "threads", "tick ms",
+           "arms/ms", "speedup", "eff", "stolen");
+    for (size_t s = 0; s < sizes.size(); ++s)
+    {
+        double base_ms = 0.0;
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            arm::Fleet fleet(sizes[s]);
+            mygllib::WorkPool pool(threads);
+            fleet.step(pool, 0.01f);            // warm up caches and threads
+
+            const int64_t start = mygllib::now_ns();
+            for (int t = 0; t < ticks; ++t) fleet.step(pool, 0.01f);
+            const double ms = mygllib::ns_to_ms(mygllib::now_ns() - start) / ticks;
+            if (threads == 1) base_ms = ms;
+
+            uint64_t chunks = 0, steals = 0;
+            for (int w = 0; w < threads; ++w)
+            {
+                chunks += pool.chunks()[w];
+                steals += pool.steals()[w];
+            }
+            const double speedup = base_ms / ms;
+            printf("%8zu %7d %10.3f %10.1f %8.2f %5.0f%% %6.1f%%\n",
+                   sizes[s], threads, ms, sizes[s] / ms, speedup,
+                   100.0 * speedup / threads,
+                   chunks ? 100.0 * steals / chunks : 0.0);
+        }
+    }
+    return 0;
+}
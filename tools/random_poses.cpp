@@ -0,0 +1,38 @@
+// File  : random_poses.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Writes a pose list for main.exe --batch: random joint angles and grip,
+// seen from a random camera on a ring around the arm.
+//
+// USAGE:
+// ./tools/random_poses.exe [count] [seed] > poses.txt
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+int main(int argc, char ** argv)
+{
+    const int count = argc > 1 ? atoi(argv[1]) : 100;
+    const unsigned seed = argc > 2 ? unsigned(atoi(argv[2])) : 1u;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution< float > joint(-90.0f, 90.0f);
+    std::uniform_real_distribution< float > unit(0.0f, 1.0f);
+
+    std::cout << "# sp sy sr ep ey er grip eyex eyey eyez refx refy refz fovy\n";
+    for (int i = 0; i < count; ++i)
+    {
+        const float a = 2.0f * float(M_PI) * unit(rng);
+        const float r = 8.0f + 4.0f * unit(rng);
+        std::cout << joint(rng) << ' ' << joint(rng) << ' ' << joint(rng) << ' '
+                  << joint(rng) << ' ' << joint(rng) << ' ' << joint(rng) << ' '
+                  << unit(rng) << ' '
+                  << r * cos(a) << ' ' << 3.0f + 4.0f * unit(rng) << ' ' << r * sin(a) << ' '
+                  << "0 2 0 "
+                  << 45.0f + 30.0f * unit(rng) << '\n';
+    }
+    return 0;
+}
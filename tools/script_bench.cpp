@@ -0,0 +1,111 @@
+// File  : script_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Runs one pick-and-place motion script per arm, for many arms at once,
+// on a 1 kHz tick until every script has finished. Prints what starting
+// the scripts and each tick cost, and counts the heap allocations made
+// while ticking (there should be none).
+//
+// USAGE:
+// ./tools/script_bench.exe [arms ...]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "Clock.h"
+#include "Script.h"
+
+namespace
+{
+    std::atomic< size_t > allocations(0);
+
+    const float TICK_S = 0.001f;
+
+    arm::Script pick(arm::Pose & pose, arm::Pose at, arm::Pose above,
+                     float hold_ms)
+    {
+        co_await arm::grip_to(0.0f);
+        co_await arm::move_to(above);
+        co_await arm::move_to(at);
+        co_await arm::grip_to(1.0f);
+        co_await arm::sleep(hold_ms);
+        co_await arm::move_to(above);
+        co_await arm::grip_to(0.0f);
+    }
+}
+
+void * operator new(size_t n)
+{
+    ++allocations;
+    void * p = malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    free(p);
+}
+
+int main(int argc, char ** argv)
+{
+    std::vector< size_t > counts;
+    for (int i = 1; i < argc; ++i) counts.push_back(strtoul(argv[i], NULL, 10));
+    if (counts.empty())
+    {
+        const size_t defaults[] = { 100, 1000, 10000 };
+        counts.assign(defaults, defaults + 3);
+    }
+
+    printf("%8s %12s %9s %12s %12s %8s\n", "scripts", "start us", "ticks",
+           "tick us", "ns/script", "allocs");
+    for (size_t c = 0; c < counts.size(); ++c)
+    {
+        const size_t n = counts[c];
+        std::mt19937 rng(1);
+        std::uniform_real_distribution< float > angle(-60.0f, 60.0f);
+        std::uniform_real_distribution< float > hold(200.0f, 800.0f);
+
+        std::vector< arm::Pose > poses(n);
+        arm::ScriptRunner runner(n);
+        const int64_t t0 = mygllib::now_ns();
+        for (size_t k = 0; k < n; ++k)
+        {
+            const arm::Pose rest = { 0, 0, 0, 0, 0, 0, 0.5f, 0, 0, 0 };
+            arm::Pose at = rest, above = rest;
+            at.shoulder_pitch = angle(rng);
+            at.shoulder_yaw = angle(rng);
+            at.elbow_pitch = angle(rng);
+            above.shoulder_pitch = 0.5f * at.shoulder_pitch;
+            above.shoulder_yaw = at.shoulder_yaw;
+            poses[k] = rest;
+            runner.start(pick(poses[k], at, above, hold(rng)));
+        }
+        const int64_t t1 = mygllib::now_ns();
+
+        const size_t before = allocations.load();
+        size_t ticks = 0, ticked = 0;
+        while (runner.running() > 0)
+        {
+            ticked += runner.running();
+            runner.tick(TICK_S);
+            ++ticks;
+        }
+        const int64_t t2 = mygllib::now_ns();
+        const size_t allocs = allocations.load() - before;
+
+        printf("%8zu %12.1f %9zu %12.2f %12.1f %8zu\n", n, (t1 - t0) * 1e-3,
+               ticks, (t2 - t1) * 1e-3 / ticks, double(t2 - t1) / ticked,
+               allocs);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// File  : shard_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Runs the fleet as arm::ShardedFleet, unpaced, for a range of shard
+// (process) counts and prints the lockstep tick time and where it goes:
+// computing, exchanging boundary arms through shared memory, and
+// waiting at the barrier. Each run's last tick is checked against the
+// same fleet stepped in this process.
+//
+// USAGE:
+// ./tools/shard_bench.exe [arms] [ticks] [shards ...]
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Clock.h"
+#include "Shard.h"
+
+int main(int argc, char ** argv)
+{
+    const size_t arms = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000;
+    const int ticks = argc > 2 ? atoi(argv[2]) : 200;
+    std::vector< int > counts;
+    for (int i = 3; i < argc; ++i) counts.push_back(atoi(argv[i]));
+    if (counts.empty())
+    {
+        const int defaults[] = { 1, 2, 4, 8 };
+        counts.assign(defaults, defaults + 4);
+    }
+
+    // reference: the whole fleet in one process, one thread
+    arm::Fleet fleet(arms);
+    mygllib::WorkPool pool(1);
+    const int64_t t0 = mygllib::now_ns();
+    for (int t = 0; t < ticks; ++t) fleet.step(pool, 0.01f);
+    const double single_ms = mygllib::ns_to_ms(mygllib::now_ns() - t0) / ticks;
+    fleet.acquire();
+    const arm::FleetState & ref = fleet.front();
+
+    printf("%zu arms, %d ticks, %u cores; one process: %.3f ms/tick\n", arms,
+           ticks, std::thread::hardware_concurrency(), single_ms);
+    printf("%7s %9s %9s %9s %9s %9s %7s %9s %6s\n", "shards", "tick ms",
+           "p99 ms", "compute", "exchange", "barrier", "sync %", "boundary",
+           "same");
+    for (size_t c = 0; c < counts.size(); ++c)
+    {
+        arm::ShardedFleet sharded(arms, counts[c], 0, ticks);
+        sharded.wait();
+        const int n = sharded.shards();
+        std::vector< arm::ShardStats > st(n);
+        for (int i = 0; i < n; ++i) st[i] = sharded.stats(i);
+
+        double tick = 0.0, p99 = 0.0, compute = 0.0, exchange = 0.0, wait = 0.0;
+        size_t boundary = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            tick = std::max(tick, st[i].tick_mean);
+            p99 = std::max(p99, st[i].tick_p99);
+            compute += st[i].compute / n;
+            exchange += st[i].exchange / n;
+            wait += st[i].wait / n;
+            boundary += st[i].imported;
+        }
+
+        sharded.acquire();
+        const arm::FleetState & s = sharded.front();
+        bool same = s.tick == ref.tick && s.contact_pairs == ref.contact_pairs
+                 && s.candidate_pairs == ref.candidate_pairs;
+        for (size_t k = 0; same && k < arms; ++k)
+        {
+            same = s.touching[k] == ref.touching[k]
+                && s.colliding[k] == ref.colliding[k]
+                && s.palm[0][k] == ref.palm[0][k]
+                && s.palm[1][k] == ref.palm[1][k]
+                && s.palm[2][k] == ref.palm[2][k];
+        }
+
+        printf("%7d %9.3f %9.3f %9.3f %9.3f %9.3f %7.1f %9zu %6s\n", n, tick,
+               p99, compute, exchange, wait,
+               100.0 * (exchange + wait) / tick, boundary / n,
+               same ? "yes" : "NO");
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+// File  : sweep_bench.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Fast random moves between clear poses, among thin poles around one
+// arm. Compares the swept-volume check (arm::segment_clear) with
+// checking poses one frame apart at 360 deg/s (6 degrees): how many
+// blocked moves the per-frame check misses, and what each costs. Moves
+// the sweep calls clear are then sampled every 0.1 degree to confirm
+// none of them is blocked. Last, times check_trajectory() on one long
+// clear plan, serially and with a WorkPool of each thread count.
+//
+// USAGE:
+// ./tools/sweep_bench.exe [moves] [plan segments] [threads ...]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Clock.h"
+#include "Sweep.h"
+
+namespace
+{
+    const float FRAME_DEG = 6.0f;       // 360 deg/s at 60 Hz
+    const float DENSE_DEG = 0.1f;
+
+    // vertical poles, 0.1 thick, in a ring through the arm's reach
+    arm::Obstacles poles()
+    {
+        arm::Obstacles o;
+        for (int i = 0; i < 12; ++i)
+        {
+            const float a = i * 2.0f * float(M_PI) / 12.0f;
+            const float r = 3.0f + 1.5f * (i % 3);
+            const arm::Capsule c = { arm::Vec3(r * std::cos(a), 0.0f, r * std::sin(a)),
+                                     arm::Vec3(r * std::cos(a), 8.0f, r * std::sin(a)),
+                                     0.05f };
+            o.capsules.push_back(c);
+        }
+        return o;
+    }
+
+    float turn_deg(const arm::Pose & a, const arm::Pose & b)
+    {
+        const float ds = std::fabs(mygllib::dot(arm::shoulder_rotation(a),
+                                                arm::shoulder_rotation(b)));
+        const float de = std::fabs(mygllib::dot(arm::elbow_rotation(a),
+                                                arm::elbow_rotation(b)));
+        return mygllib::rad2deg(2.0f * std::acos(std::min(1.0f, std::min(ds, de))));
+    }
+
+    // true if any of the poses step degrees apart along a -> b is blocked
+    bool sampled_blocked(const arm::Pose & a, const arm::Pose & b, float step,
+                         const arm::Obstacles & o)
+    {
+        const int n = std::max(1, int(std::ceil(turn_deg(a, b) / step)));
+        for (int k = 0; k <= n; ++k)
+            if (arm::pose_blocked(arm::slerp(a, b, float(k) / n), o))
+                return true;
+        return false;
+    }
+
+    struct RandomPose
+    {
+        RandomPose() : rng(1), angle(-60.0f, 60.0f), unit(0.0f, 1.0f) {}
+
+        arm::Pose operator()()
+        {
+            arm::Pose p = { angle(rng), angle(rng), angle(rng),
+                            angle(rng), angle(rng), angle(rng),
+                            unit(rng), 0.0f, 0.0f, 0.0f };
+            return p;
+        }
+
+        // a random pose that is itself clear
+        arm::Pose clear(const arm::Obstacles & o)
+        {
+            arm::Pose p;
+            do p = (*this)(); while (arm::pose_blocked(p, o));
+            return p;
+        }
+
+        std::mt19937 rng;
+        std::uniform_real_distribution< float > angle, unit;
+    };
+}
+
+int main(int argc, char ** argv)
+{
+    const int moves = argc > 1 ? atoi(argv[1]) : 2000;
+    const int segments = argc > 2 ? atoi(argv[2]) : 1000;
+    std::vector< int > threads;
+    for (int i = 3; i < argc; ++i) threads.push_back(atoi(argv[i]));
+    if (threads.empty())
+    {
+        const int defaults[] = { 1, 2, 4 };
+        threads.assign(defaults, defaults + 3);
+    }
+
+    const arm::Obstacles o = poles();
+    RandomPose random;
+
+    int blocked = 0, certain = 0, frame_missed = 0, sweep_missed = 0;
+    long intervals = 0;
+    int64_t sweep_ns = 0, frame_ns = 0;
+    for (int m = 0; m < moves; ++m)
+    {
+        const arm::Pose a = random.clear(o), b = random.clear(o);
+
+        const int64_t t0 = mygllib::now_ns();
+        const arm::SegmentCheck c = arm::segment_clear(a, b, o);
+        const int64_t t1 = mygllib::now_ns();
+        const bool frames = sampled_blocked(a, b, FRAME_DEG, o);
+        const int64_t t2 = mygllib::now_ns();
+        sweep_ns += t1 - t0;
+        frame_ns += t2 - t1;
+        intervals += c.intervals;
+
+        if (c.clear)
+        {
+            if (sampled_blocked(a, b, DENSE_DEG, o)) ++sweep_missed;
+            continue;
+        }
+        ++blocked;
+        if (c.certain)
+        {
+            ++certain;
+            if (!frames) ++frame_missed;
+        }
+    }
+
+    printf("%d moves between clear poses, 12 poles 0.1 thick\n", moves);
+    printf("  blocked (sweep)        %6d  (%d certain, %d within %.0e)\n",
+           blocked, certain, blocked - certain, cfg::SWEEP_TOLERANCE);
+    printf("  missed by %.0f deg frames %5d\n", FRAME_DEG, frame_missed);
+    printf("  clear but blocked at %.1f deg: %d\n", DENSE_DEG, sweep_missed);
+    printf("  us per move: sweep %.1f (%.1f intervals), frames %.1f\n",
+           sweep_ns * 1e-3 / moves, double(intervals) / moves,
+           frame_ns * 1e-3 / moves);
+
+    // a long plan of clear moves
+    std::vector< arm::Pose > plan(1, random.clear(o));
+    while (int(plan.size()) <= segments)
+    {
+        const arm::Pose next = random.clear(o);
+        if (arm::segment_clear(plan.back(), next, o).clear) plan.push_back(next);
+    }
+
+    printf("\nplan of %d clear moves\n", segments);
+    printf("%8s %10s %12s\n", "threads", "ms", "intervals");
+    int64_t t0 = mygllib::now_ns();
+    arm::TrajectoryCheck c = arm::check_trajectory(plan, o);
+    printf("%8s %10.2f %12zu\n", "serial",
+           mygllib::ns_to_ms(mygllib::now_ns() - t0), c.intervals);
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        mygllib::WorkPool pool(threads[i]);
+        t0 = mygllib::now_ns();
+        c = arm::check_trajectory(plan, o, &pool);
+        printf("%8d %10.2f %12zu%s\n", threads[i],
+               mygllib::ns_to_ms(mygllib::now_ns() - t0), c.intervals,
+               c.clear ? "" : "  BLOCKED?");
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// File  : telemetry_reader.cpp
+// Author: Cole Schwandt
+//
+// Description:
+// Samples the visualizer's shared-memory telemetry block and prints, once a
+// second, the rate at which new ticks arrive, how many reads were torn by a
+// concurrent publish (and retried), and the latest palm position.
+//
+// USAGE:
+// ./main.exe &
+// ./tools/telemetry_reader.exe [-t seconds] [-i poll_interval_us]
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include "Clock.h"
+#include "Telemetry.h"
+
+int main(int argc, char ** argv)
+{
+    double seconds = 5.0;
+    int interval_us = 100;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) interval_us = atoi(argv[++i]);
+        else
+        {
+            std::cout << "usage: " << argv[0] << " [-t seconds] [-i poll_interval_us]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        arm::TelemetryReader reader;
+        arm::TelemetrySample s;
+        memset(&s, 0, sizeof(s));
+
+        const int64_t start = mygllib::now_ns();
+        const int64_t end = start + int64_t(seconds * 1e9);
+        int64_t report = start + 1000000000LL;
+        uint64_t last_tick = ~0ULL;
+        long updates = 0, reads = 0, retries = 0;
+        long total_updates = 0, total_retries = 0;
+
+        for (int64_t now = start; now < end; now = mygllib::now_ns())
+        {
+            ++reads;
+            while (!reader.try_read(s)) ++retries;
+            if (s.tick != last_tick)
+            {
+                last_tick = s.tick;
+                ++updates;
+            }
+
+            if (now >= report)
+            {
+                std::cout << "tick " << s.tick
+                          << "  update " << updates << " Hz"
+                          << "  reads " << reads
+                          << "  torn retries " << retries
+                          << "  grip " << s.grip
+                          << "  collision " << s.collision
+                          << "  palm (" << s.palm[12] << ','
+                          << s.palm[13] << ',' << s.palm[14] << ')'
+                          << "  closure " << s.closure[0] << ','
+                          << s.closure[1] << ',' << s.closure[2]
+                          << std::endl;
+                total_updates += updates;
+                total_retries += retries;
+                updates = reads = retries = 0;
+                report += 1000000000LL;
+            }
+            if (interval_us > 0) usleep(interval_us);
+        }
+
+        total_updates += updates;
+        total_retries += retries;
+        std::cout << "total: " << total_updates << " updates, "
+                  << total_retries << " torn-read retries" << std::endl;
+    }
+    catch (arm::TelemetryError &)
+    {
+        return 1;
+    }
+    return 0;
+}